@@ -0,0 +1,4529 @@
+//===------------------------- ConstraintGraph.cpp ------------------------===//
+//===------- The constraint graph of the Range Analysis and its solver ----===//
+//
+//					 The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+// Copyright (C) 2011-2012, 2015, 2017  Victor Hugo Sperle Campos
+//               2011               	  Douglas do Couto Teixeira
+//               2012               	  Igor Rafael de Assis Costa
+//
+//===----------------------------------------------------------------------===//
+
+#include "ConstraintGraph.h"
+
+#include <stdint.h>
+#include <algorithm>
+#include <cassert>
+#include <condition_variable>
+#include <cstring>
+#include <iterator>
+#include <mutex>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <type_traits>
+
+#include "llvm/ADT/APInt.h"
+#include "llvm/ADT/BitVector.h"
+#include "llvm/ADT/iterator.h"
+#include "llvm/ADT/Statistic.h"
+#include "llvm/IR/DerivedTypes.h"
+#include "llvm/IR/Instruction.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MathExtras.h"
+#include "llvm/Support/Process.h"
+
+int __builtin_clz(unsigned int);
+
+#define DEBUG_TYPE "range-analysis"
+
+namespace RangeAnalysis {
+
+using namespace llvm;
+
+// These macros are used to get stats regarding the precision of our analysis.
+STATISTIC(usedBits, "Initial number of bits.");
+STATISTIC(needBits, "Needed bits.");
+STATISTIC(percentReduction, "Percentage of reduction of the number of bits.");
+STATISTIC(numSCCs, "Number of strongly connected components.");
+STATISTIC(numAloneSCCs, "Number of SCCs containing only one node.");
+STATISTIC(sizeMaxSCC, "Size of largest SCC.");
+STATISTIC(numVars, "Number of variables");
+STATISTIC(numUnknown, "Number of unknown variables");
+STATISTIC(numEmpty, "Number of empty-set variables");
+STATISTIC(numCPlusInf, "Number of variables [c, +inf].");
+STATISTIC(numCC, "Number of variables [c, c].");
+STATISTIC(numMinInfC, "Number of variables [-inf, c].");
+STATISTIC(numMaxRange, "Number of variables [-inf, +inf].");
+STATISTIC(numConstants, "Number of constants.");
+STATISTIC(numZeroUses, "Number of variables without any use.");
+STATISTIC(numNotInt, "Number of variables that are not Integer.");
+STATISTIC(numOps, "Number of operations");
+STATISTIC(numFoldedOps, "Number of operations folded before solving.");
+STATISTIC(numAliases, "Number of variables made aliases of others.");
+STATISTIC(maxVisit, "Max number of times a value has been visited.");
+
+namespace {
+
+// The number of threads that solve the components of a constraint graph. With
+// one thread, components are solved one after the other.
+cl::opt<unsigned> NumThreads(
+    "ra-threads", cl::init(1),
+    cl::desc("Number of threads that solve the strongly connected components "
+             "of the constraint graph"));
+
+// With several threads, components with at least this many nodes are solved
+// by all of them together. The ranges of such components may then change
+// from one run to the next, though they are always sound.
+cl::opt<unsigned> ParallelSCCSize(
+    "ra-parallel-scc-size", cl::init(0),
+    cl::desc("Minimum number of nodes of a strongly connected component "
+             "solved by several threads at once (0 disables it)"));
+
+// Renumbering the graph in the order of its components lays out the ranges
+// and the lists of each component next to each other, and those of the next
+// components after them.
+cl::opt<bool> Relayout(
+    "ra-relayout", cl::init(false),
+    cl::desc("Renumber the nodes and operations of the constraint graph in "
+             "the topological order of its strongly connected components"));
+
+// The summary-based inter-procedural analysis stops earlier if no summary
+// changes. The same number bounds the iterations on a recursive component
+// within a round.
+cl::opt<unsigned> SummaryRounds(
+    "ra-summary-rounds", cl::init(16),
+    cl::desc("Maximum number of rounds of the summary-based "
+             "inter-procedural range analysis"));
+
+// The summary-based inter-procedural analysis solves again the callees of
+// some calls with the arguments of the call, as if they were inlined there,
+// and narrows down the return value of the call with the result. The calls
+// are chosen as long as the number of instructions and arguments of these
+// callees stays within the budget, the smallest callees first.
+cl::opt<unsigned> ContextBudget(
+    "ra-context-budget", cl::init(0),
+    cl::desc("Size of the callees the summary-based inter-procedural range "
+             "analysis solves again for each of their chosen calls"));
+
+// The constraint graph is simplified before its components are searched:
+// operations whose sources are all known are evaluated once, and operations
+// which only copy their source make their sink an alias of the source. The
+// components are then found in another order, which may change the ranges
+// of the components entered from several others.
+cl::opt<bool> Simplify(
+    "ra-simplify", cl::init(false),
+    cl::desc("Fold constants and copies out of the constraint graph before "
+             "solving it"));
+
+// Each constraint graph is written to the file once it is finalized, before
+// it is solved, so that the solver can be run again on it without the
+// program. See GraphFile for the format.
+cl::opt<std::string> WriteGraphs(
+    "ra-write-graphs", cl::init(""), cl::value_desc("filename"),
+    cl::desc("Write the constraint graphs to this file before solving them"));
+
+} // end anonymous namespace
+
+// ========================================================================== //
+// AnalysisContext
+// ========================================================================== //
+AnalysisContext::AnalysisContext()
+    : numThreads(NumThreads), parallelSCCSize(ParallelSCCSize),
+      relayout(Relayout), summaryRounds(SummaryRounds),
+      contextBudget(ContextBudget), simplify(Simplify),
+      graphFile(WriteGraphs) {}
+
+void AnalysisContext::merge(const AnalysisContext &other) {
+  stats.usedBits += other.stats.usedBits;
+  stats.needBits += other.stats.needBits;
+  stats.numSCCs += other.stats.numSCCs;
+  stats.numAloneSCCs += other.stats.numAloneSCCs;
+  stats.sizeMaxSCC = std::max(stats.sizeMaxSCC, other.stats.sizeMaxSCC);
+  stats.numVars += other.stats.numVars;
+  stats.numUnknown += other.stats.numUnknown;
+  stats.numEmpty += other.stats.numEmpty;
+  stats.numCPlusInf += other.stats.numCPlusInf;
+  stats.numCC += other.stats.numCC;
+  stats.numMinInfC += other.stats.numMinInfC;
+  stats.numMaxRange += other.stats.numMaxRange;
+  stats.numConstants += other.stats.numConstants;
+  stats.numZeroUses += other.stats.numZeroUses;
+  stats.numNotInt += other.stats.numNotInt;
+  stats.numOps += other.stats.numOps;
+  stats.numFoldedOps += other.stats.numFoldedOps;
+  stats.numAliases += other.stats.numAliases;
+  for (const auto &pair : other.FerMap) {
+    FerMap[pair.first] += pair.second;
+  }
+#ifdef STATS
+  prof.merge(other.prof);
+#endif
+}
+
+void AnalysisContext::publishStatistics() {
+  usedBits += stats.usedBits;
+  needBits += stats.needBits;
+  if (stats.usedBits != 0) {
+    double totalB = stats.usedBits;
+    double needB = stats.needBits;
+    percentReduction =
+        static_cast<unsigned int>((totalB - needB) * 100 / totalB);
+  }
+  numSCCs += stats.numSCCs;
+  numAloneSCCs += stats.numAloneSCCs;
+  sizeMaxSCC.updateMax(stats.sizeMaxSCC);
+  numVars += stats.numVars;
+  numUnknown += stats.numUnknown;
+  numEmpty += stats.numEmpty;
+  numCPlusInf += stats.numCPlusInf;
+  numCC += stats.numCC;
+  numMinInfC += stats.numMinInfC;
+  numMaxRange += stats.numMaxRange;
+  numConstants += stats.numConstants;
+  numZeroUses += stats.numZeroUses;
+  numNotInt += stats.numNotInt;
+  numOps += stats.numOps;
+  numFoldedOps += stats.numFoldedOps;
+  numAliases += stats.numAliases;
+
+  // max visit computation
+  unsigned maxtimes = 0;
+  for (auto &pair : FerMap) {
+    unsigned times = pair.second;
+    if (times > maxtimes) {
+      maxtimes = times;
+    }
+  }
+  maxVisit.updateMax(maxtimes);
+
+  stats = Statistics();
+  FerMap.clear();
+}
+
+// ========================================================================== //
+// Range
+// ========================================================================== //
+Range::Range(unsigned bitwidth, RangeType rType)
+    : bitwidth(bitwidth), type(rType) {
+  if (isNative()) {
+    nl = getNativeMin();
+    nu = getNativeMax();
+  } else {
+    new (&l) APInt(APInt::getSignedMinValue(bitwidth));
+    new (&u) APInt(APInt::getSignedMaxValue(bitwidth));
+  }
+}
+
+Range::Range(const APInt &lb, const APInt &ub, RangeType rType)
+    : bitwidth(lb.getBitWidth()), type(rType) {
+  if (isNative()) {
+    nl = lb.getSExtValue();
+    nu = ub.getSExtValue();
+  } else {
+    new (&l) APInt(lb);
+    new (&u) APInt(ub);
+  }
+
+  if (hasInvertedBounds()) {
+    type = Empty;
+  }
+}
+
+bool Range::isMaxRange() const { return isLowerMin() && isUpperMax(); }
+
+/// Add and Mul are commutative. So, they are a little different
+/// than the other operations.
+Range Range::add(const Range &other) const {
+  if (isNative()) {
+    return nativeAdd(other);
+  }
+
+  const APInt Min = APInt::getSignedMinValue(bitwidth);
+  const APInt Max = APInt::getSignedMaxValue(bitwidth);
+
+  if (this->isUnknown() || other.isUnknown()) {
+    return Range(bitwidth, Unknown);
+  }
+
+  const APInt &a = this->l;
+  const APInt &b = this->u;
+  const APInt &c = other.l;
+  const APInt &d = other.u;
+  APInt l = Min, u = Max;
+  if (a.ne(Min) && c.ne(Min)) {
+    l = a + c;
+
+    // Overflow handling
+    if (a.isNegative() == c.isNegative() && a.isNegative() != l.isNegative()) {
+      l = Min;
+    }
+  }
+
+  if (b.ne(Max) && d.ne(Max)) {
+    u = b + d;
+
+    // Overflow handling
+    if (b.isNegative() == d.isNegative() && b.isNegative() != u.isNegative()) {
+      u = Max;
+    }
+  }
+
+  return Range(l, u);
+}
+
+/// [a, b] − [c, d] =
+/// [min (a − c, a − d, b − c, b − d),
+/// max (a − c, a − d, b − c, b − d)] = [a − d, b − c]
+/// The other operations are just like this.
+Range Range::sub(const Range &other) const {
+  if (isNative()) {
+    return nativeSub(other);
+  }
+
+  const APInt Min = APInt::getSignedMinValue(bitwidth);
+  const APInt Max = APInt::getSignedMaxValue(bitwidth);
+
+  if (this->isUnknown() || other.isUnknown()) {
+    return Range(bitwidth, Unknown);
+  }
+
+  const APInt &a = this->l;
+  const APInt &b = this->u;
+  const APInt &c = other.l;
+  const APInt &d = other.u;
+  APInt l, u;
+
+  const APInt less = (a.slt(c)) ? a : c;
+  const APInt greater = (b.sgt(d)) ? b : d;
+
+  // a-d
+  if (a.eq(Min) || d.eq(Max)) {
+    l = Min;
+  } else {
+    l = a - d;
+
+    // Overflow handling
+    if (a.isNegative() != d.isNegative() && d.isNegative() == l.isNegative()) {
+      l = Min;
+    }
+  }
+
+  // b-c
+  if (b.eq(Max) || c.eq(Min)) {
+    u = Max;
+  } else {
+    u = b - c;
+
+    // Overflow handling
+    if (b.isNegative() != c.isNegative() && c.isNegative() == u.isNegative()) {
+      u = Max;
+    }
+  }
+
+  return Range(l, u);
+}
+
+namespace {
+/// Multiplies two bounds, saturating to [-inf, +inf] if the product overflows.
+APInt mulSaturated(const APInt &x, const APInt &y) {
+  bool overflow = false;
+  APInt xy = x.smul_ov(y, overflow);
+
+  if (overflow) {
+    return x.isNegative() == y.isNegative()
+               ? APInt::getSignedMaxValue(x.getBitWidth())
+               : APInt::getSignedMinValue(x.getBitWidth());
+  }
+
+  return xy;
+}
+} // namespace
+
+#define MUL_HELPER(x, y)                                                       \
+  (x).eq(Max)                                                                  \
+      ? ((y).slt(Zero) ? Min : ((y).eq(Zero) ? Zero : Max))                    \
+      : ((y).eq(Max)                                                           \
+             ? ((x).slt(Zero) ? Min : ((x).eq(Zero) ? Zero : Max))             \
+             : ((x).eq(Min)                                                    \
+                    ? ((y).slt(Zero) ? Max : ((y).eq(Zero) ? Zero : Min))      \
+                    : ((y).eq(Min)                                             \
+                           ? ((x).slt(Zero) ? Max                              \
+                                            : ((x).eq(Zero) ? Zero : Min))     \
+                           : mulSaturated((x), (y)))))
+
+/// Add and Mul are commutatives. So, they are a little different
+/// of the other operations.
+// [a, b] * [c, d] = [Min(a*c, a*d, b*c, b*d), Max(a*c, a*d, b*c, b*d)]
+Range Range::mul(const Range &other) const {
+  if (isNative()) {
+    return nativeMul(other);
+  }
+
+  const APInt Min = APInt::getSignedMinValue(bitwidth);
+  const APInt Max = APInt::getSignedMaxValue(bitwidth);
+  const APInt Zero = APInt::getNullValue(bitwidth);
+
+  if (this->isUnknown() || other.isUnknown()) {
+    return Range(bitwidth, Unknown);
+  }
+
+  if (this->isMaxRange() || other.isMaxRange()) {
+    return Range(bitwidth);
+  }
+
+  const APInt &a = this->l;
+  const APInt &b = this->u;
+  const APInt &c = other.l;
+  const APInt &d = other.u;
+
+  APInt candidates[4];
+  candidates[0] = MUL_HELPER(a, c);
+  candidates[1] = MUL_HELPER(a, d);
+  candidates[2] = MUL_HELPER(b, c);
+  candidates[3] = MUL_HELPER(b, d);
+
+  // Lower bound is the min value from the vector, while upper bound is the max
+  // value
+  APInt *min = &candidates[0];
+  APInt *max = &candidates[0];
+
+  for (unsigned i = 1; i < 4; ++i) {
+    if (candidates[i].sgt(*max)) {
+      max = &candidates[i];
+    } else if (candidates[i].slt(*min)) {
+      min = &candidates[i];
+    }
+  }
+
+  return Range(*min, *max);
+}
+
+#define DIV_HELPER(OP, x, y)                                                   \
+  (x).eq(Max)                                                                  \
+      ? ((y).slt(Zero) ? Min : ((y).eq(Zero) ? Zero : Max))                    \
+      : ((y).eq(Max)                                                           \
+             ? ((x).slt(Zero) ? Min : ((x).eq(Zero) ? Zero : Max))             \
+             : ((x).eq(Min)                                                    \
+                    ? ((y).slt(Zero) ? Max : ((y).eq(Zero) ? Zero : Min))      \
+                    : ((y).eq(Min)                                             \
+                           ? ((x).slt(Zero) ? Max                              \
+                                            : ((x).eq(Zero) ? Zero : Min))     \
+                           : ((x).OP((y))))))
+
+Range Range::udiv(const Range &other) const {
+  if (isNative()) {
+    return nativeUdiv(other);
+  }
+
+  const APInt Min = APInt::getSignedMinValue(bitwidth);
+  const APInt Max = APInt::getSignedMaxValue(bitwidth);
+  const APInt Zero = APInt::getNullValue(bitwidth);
+
+  if (this->isUnknown() || other.isUnknown()) {
+    return Range(bitwidth, Unknown);
+  }
+
+  const APInt &a = this->l;
+  const APInt &b = this->u;
+  const APInt &c = other.l;
+  const APInt &d = other.u;
+
+  // Deal with division by 0 exception
+  if (c.ule(Zero) && d.uge(Zero)) {
+    return Range(bitwidth);
+  }
+
+  APInt candidates[4];
+
+  // value[1]: lb(c) / leastpositive(d)
+  candidates[0] = DIV_HELPER(udiv, a, c);
+  candidates[1] = DIV_HELPER(udiv, a, d);
+  candidates[2] = DIV_HELPER(udiv, b, c);
+  candidates[3] = DIV_HELPER(udiv, b, d);
+
+  // Lower bound is the min value from the vector, while upper bound is the max
+  // value
+  APInt *min = &candidates[0];
+  APInt *max = &candidates[0];
+
+  for (unsigned i = 1; i < 4; ++i) {
+    if (candidates[i].sgt(*max)) {
+      max = &candidates[i];
+    } else if (candidates[i].slt(*min)) {
+      min = &candidates[i];
+    }
+  }
+
+  return Range(*min, *max);
+}
+
+Range Range::sdiv(const Range &other) const {
+  if (isNative()) {
+    return nativeSdiv(other);
+  }
+
+  const APInt Min = APInt::getSignedMinValue(bitwidth);
+  const APInt Max = APInt::getSignedMaxValue(bitwidth);
+  const APInt Zero = APInt::getNullValue(bitwidth);
+
+  if (this->isUnknown() || other.isUnknown()) {
+    return Range(bitwidth, Unknown);
+  }
+
+  const APInt &a = this->l;
+  const APInt &b = this->u;
+  const APInt &c = other.l;
+  const APInt &d = other.u;
+
+  // Deal with division by 0 exception
+  if (c.sle(Zero) && d.sge(Zero)) {
+    return Range(bitwidth);
+  }
+
+  APInt candidates[4];
+  candidates[0] = DIV_HELPER(sdiv, a, c);
+  candidates[1] = DIV_HELPER(sdiv, a, d);
+  candidates[2] = DIV_HELPER(sdiv, b, c);
+  candidates[3] = DIV_HELPER(sdiv, b, d);
+
+  // Lower bound is the min value from the vector, while upper bound is the max
+  // value
+  APInt *min = &candidates[0];
+  APInt *max = &candidates[0];
+
+  for (unsigned i = 1; i < 4; ++i) {
+    if (candidates[i].sgt(*max)) {
+      max = &candidates[i];
+    } else if (candidates[i].slt(*min)) {
+      min = &candidates[i];
+    }
+  }
+
+  return Range(*min, *max);
+}
+
+Range Range::urem(const Range &other) const {
+  if (isNative()) {
+    return nativeUrem(other);
+  }
+
+  const APInt Min = APInt::getSignedMinValue(bitwidth);
+  const APInt Max = APInt::getSignedMaxValue(bitwidth);
+  const APInt Zero = APInt::getNullValue(bitwidth);
+
+  if (this->isUnknown() || other.isUnknown()) {
+    return Range(bitwidth, Unknown);
+  }
+
+  const APInt &a = this->l;
+  const APInt &b = this->u;
+  const APInt &c = other.l;
+  const APInt &d = other.u;
+
+  // Deal with mod 0 exception
+  if (c.ule(Zero) && d.uge(Zero)) {
+    return Range(bitwidth);
+  }
+
+  APInt candidates[4];
+  candidates[0] = Min;
+  candidates[1] = Min;
+  candidates[2] = Max;
+  candidates[3] = Max;
+
+  if (a.ne(Min) && c.ne(Min)) {
+    candidates[0] = a.urem(c); // lower lower
+  }
+
+  if (a.ne(Min) && d.ne(Max)) {
+    candidates[1] = a.urem(d); // lower upper
+  }
+
+  if (b.ne(Max) && c.ne(Min)) {
+    candidates[2] = b.urem(c); // upper lower
+  }
+
+  if (b.ne(Max) && d.ne(Max)) {
+    candidates[3] = b.urem(d); // upper upper
+  }
+
+  // Lower bound is the min value from the vector, while upper bound is the max
+  // value
+  APInt *min = &candidates[0];
+  APInt *max = &candidates[0];
+
+  for (unsigned i = 1; i < 4; ++i) {
+    if (candidates[i].sgt(*max)) {
+      max = &candidates[i];
+    } else if (candidates[i].slt(*min)) {
+      min = &candidates[i];
+    }
+  }
+
+  return Range(*min, *max);
+}
+
+Range Range::srem(const Range &other) const {
+  if (isNative()) {
+    return nativeSrem(other);
+  }
+
+  const APInt Min = APInt::getSignedMinValue(bitwidth);
+  const APInt Max = APInt::getSignedMaxValue(bitwidth);
+  const APInt Zero = APInt::getNullValue(bitwidth);
+
+  if (other == Range(Zero, Zero) || other == Range(bitwidth, Empty)) {
+    return Range(bitwidth, Empty);
+  }
+
+  if (this->isUnknown() || other.isUnknown()) {
+    return Range(bitwidth, Unknown);
+  }
+
+  const APInt &a = this->l;
+  const APInt &b = this->u;
+  const APInt &c = other.l;
+  const APInt &d = other.u;
+
+  // Deal with mod 0 exception
+  if (c.sle(Zero) && d.sge(Zero)) {
+    return Range(bitwidth);
+  }
+
+  APInt candidates[4];
+  candidates[0] = Min;
+  candidates[1] = Min;
+  candidates[2] = Max;
+  candidates[3] = Max;
+
+  if (a.ne(Min) && c.ne(Min)) {
+    candidates[0] = a.srem(c); // lower lower
+  }
+
+  if (a.ne(Min) && d.ne(Max)) {
+    candidates[1] = a.srem(d); // lower upper
+  }
+
+  if (b.ne(Max) && c.ne(Min)) {
+    candidates[2] = b.srem(c); // upper lower
+  }
+
+  if (b.ne(Max) && d.ne(Max)) {
+    candidates[3] = b.srem(d); // upper upper
+  }
+
+  // Lower bound is the min value from the vector, while upper bound is the max
+  // value
+  APInt *min = &candidates[0];
+  APInt *max = &candidates[0];
+
+  for (unsigned i = 1; i < 4; ++i) {
+    if (candidates[i].sgt(*max)) {
+      max = &candidates[i];
+    } else if (candidates[i].slt(*min)) {
+      min = &candidates[i];
+    }
+  }
+
+  return Range(*min, *max);
+}
+
+// Logic has been borrowed from ConstantRange
+Range Range::shl(const Range &other) const {
+  if (isNative()) {
+    return nativeShl(other);
+  }
+
+  const APInt Min = APInt::getSignedMinValue(bitwidth);
+  const APInt Max = APInt::getSignedMaxValue(bitwidth);
+
+  if (isEmpty()) {
+    return Range(*this);
+  }
+  if (other.isEmpty()) {
+    return Range(other);
+  }
+
+  if (this->isUnknown() || other.isUnknown()) {
+    return Range(bitwidth, Unknown);
+  }
+
+  const APInt &a = this->l;
+  const APInt &b = this->u;
+  const APInt &c = other.l;
+  const APInt &d = other.u;
+
+  if (a.eq(Min) || c.eq(Min) || b.eq(Max) || d.eq(Max)) {
+    return Range(bitwidth);
+  }
+
+  APInt min = a.shl(c);
+  APInt max = b.shl(d);
+
+  APInt Zeros(bitwidth, b.countLeadingZeros());
+  if (Zeros.ugt(d)) {
+    return Range(min, max);
+  }
+
+  // [-inf, +inf]
+  return Range(bitwidth);
+}
+
+// Logic has been borrowed from ConstantRange
+Range Range::lshr(const Range &other) const {
+  if (isNative()) {
+    return nativeLshr(other);
+  }
+
+  const APInt Min = APInt::getSignedMinValue(bitwidth);
+  const APInt Max = APInt::getSignedMaxValue(bitwidth);
+
+  if (isEmpty()) {
+    return Range(*this);
+  }
+  if (other.isEmpty()) {
+    return Range(other);
+  }
+
+  if (this->isUnknown() || other.isUnknown()) {
+    return Range(bitwidth, Unknown);
+  }
+
+  const APInt &a = this->l;
+  const APInt &b = this->u;
+  const APInt &c = other.l;
+  const APInt &d = other.u;
+
+  if (a.eq(Min) || c.eq(Min) || b.eq(Max) || d.eq(Max)) {
+    return Range(bitwidth);
+  }
+
+  APInt max = b.lshr(c);
+  APInt min = a.lshr(d);
+
+  return Range(min, max);
+}
+
+Range Range::ashr(const Range &other) const {
+  if (isNative()) {
+    return nativeAshr(other);
+  }
+
+  const APInt Min = APInt::getSignedMinValue(bitwidth);
+  const APInt Max = APInt::getSignedMaxValue(bitwidth);
+
+  if (isEmpty()) {
+    return Range(*this);
+  }
+  if (other.isEmpty()) {
+    return Range(other);
+  }
+
+  if (this->isUnknown() || other.isUnknown()) {
+    return Range(bitwidth, Unknown);
+  }
+
+  const APInt &a = this->l;
+  const APInt &b = this->u;
+  const APInt &c = other.l;
+  const APInt &d = other.u;
+
+  if (a.eq(Min) || c.eq(Min) || b.eq(Max) || d.eq(Max)) {
+    return Range(bitwidth);
+  }
+
+  APInt max = b.ashr(c);
+  APInt min = a.ashr(d);
+
+  return Range(min, max);
+}
+
+/*
+ * 	This and operation is coded following Hacker's Delight algorithm.
+ * 	According to the author, it provides tight results.
+ */
+Range Range::And(const Range &other) const {
+  if (isNative()) {
+    return nativeAnd(other);
+  }
+
+  const APInt Min = APInt::getSignedMinValue(bitwidth);
+  const APInt Max = APInt::getSignedMaxValue(bitwidth);
+
+  if (this->isUnknown() || other.isUnknown()) {
+    const APInt &umin = APIntOps::umin(this->u, other.u);
+    if (umin.isAllOnesValue()) {
+      return Range(bitwidth);
+    }
+    return Range(APInt::getNullValue(bitwidth), umin);
+  }
+
+  APInt a = this->l;
+  APInt b = this->u;
+  const APInt &c = other.l;
+  const APInt &d = other.u;
+
+  if (a.eq(Min) || b.eq(Max) || c.eq(Min) || d.eq(Max)) {
+    return Range(bitwidth);
+  }
+
+  // negate everybody
+  APInt negA = APInt(a);
+  negA.flipAllBits();
+  APInt negB = APInt(b);
+  negB.flipAllBits();
+  APInt negC = APInt(c);
+  negC.flipAllBits();
+  APInt negD = APInt(d);
+  negD.flipAllBits();
+
+  Range inv1 = Range(negB, negA);
+  Range inv2 = Range(negD, negC);
+
+  Range invres = inv1.Or(inv2);
+
+  // negate the result of the 'or'
+  APInt invLower = invres.getUpper();
+  invLower.flipAllBits();
+
+  APInt invUpper = invres.getLower();
+  invUpper.flipAllBits();
+
+  return Range(invLower, invUpper);
+}
+
+// This operator is used when we are dealing with values
+// with more than 64-bits
+Range Range::And_conservative(const Range &other) const {
+  if (isNative()) {
+    return nativeAnd_conservative(other);
+  }
+
+  if (isEmpty()) {
+    return Range(*this);
+  }
+  if (other.isEmpty()) {
+    return Range(other);
+  }
+
+  const APInt &umin = APIntOps::umin(other.u, this->u);
+  if (umin.isAllOnesValue()) {
+    return Range(bitwidth);
+  }
+  return Range(APInt::getNullValue(bitwidth), umin);
+}
+
+namespace {
+int64_t minOR(int64_t a, int64_t b, int64_t c, int64_t d) {
+  int64_t m, temp;
+
+  m = 0x80000000 >> __builtin_clz(a ^ c);
+  while (m != 0) {
+    if ((~a & c & m) != 0) {
+      temp = (a | m) & -m;
+      if (temp <= b) {
+        a = temp;
+        break;
+      }
+    } else if ((a & ~c & m) != 0) {
+      temp = (c | m) & -m;
+      if (temp <= d) {
+        c = temp;
+        break;
+      }
+    }
+    m = m >> 1;
+  }
+  return a | c;
+}
+
+int64_t maxOR(int64_t a, int64_t b, int64_t c, int64_t d) {
+  int64_t m, temp;
+
+  m = 0x80000000 >> __builtin_clz(b & d);
+  while (m != 0) {
+    if ((b & d & m) != 0) {
+      temp = (b - m) | (m - 1);
+      if (temp >= a) {
+        b = temp;
+        break;
+      }
+      temp = (d - m) | (m - 1);
+      if (temp >= c) {
+        d = temp;
+        break;
+      }
+    }
+    m = m >> 1;
+  }
+  return b | d;
+}
+} // namespace
+
+// This operator is used when we are dealing with values
+// with more than 64-bits
+Range Range::Or_conservative(const Range &other) const {
+  if (isNative()) {
+    return nativeOr_conservative(other);
+  }
+
+  if (isEmpty()) {
+    return Range(*this);
+  }
+  if (other.isEmpty()) {
+    return Range(other);
+  }
+
+  if (this->isUnknown() || other.isUnknown()) {
+    return Range(bitwidth, Unknown);
+  }
+
+  const APInt &umax = APIntOps::umax(this->l, other.l);
+  if (umax.isMinValue()) {
+    return Range(bitwidth);
+  }
+
+  return Range(umax, APInt::getNullValue(bitwidth));
+}
+
+/*
+ * 	This or operation is coded following Hacker's Delight algorithm.
+ * 	According to the author, it provides tight results.
+ */
+Range Range::Or(const Range &other) const {
+  if (isNative()) {
+    return nativeOr(other);
+  }
+
+  const APInt Min = APInt::getSignedMinValue(bitwidth);
+  const APInt Max = APInt::getSignedMaxValue(bitwidth);
+
+  const APInt &a = this->l;
+  const APInt &b = this->u;
+  const APInt &c = other.l;
+  const APInt &d = other.u;
+
+  if (this->isUnknown() || other.isUnknown()) {
+    return Range(bitwidth, Unknown);
+  }
+  if (a.eq(Min) || b.eq(Max) || c.eq(Min) || d.eq(Max)) {
+    return Range(bitwidth);
+  }
+
+  unsigned char switchval = 0;
+  switchval += (a.isNonNegative() ? 1 : 0);
+  switchval <<= 1;
+  switchval += (b.isNonNegative() ? 1 : 0);
+  switchval <<= 1;
+  switchval += (c.isNonNegative() ? 1 : 0);
+  switchval <<= 1;
+  switchval += (d.isNonNegative() ? 1 : 0);
+
+  APInt l = Min, u = Max;
+
+  switch (switchval) {
+  case 0:
+    l = minOR(a.getSExtValue(), b.getSExtValue(), c.getSExtValue(),
+              d.getSExtValue());
+    u = maxOR(a.getSExtValue(), b.getSExtValue(), c.getSExtValue(),
+              d.getSExtValue());
+    break;
+  case 1:
+    l = a;
+    u = -1;
+    break;
+  case 3:
+    l = minOR(a.getSExtValue(), b.getSExtValue(), c.getSExtValue(),
+              d.getSExtValue());
+    u = maxOR(a.getSExtValue(), b.getSExtValue(), c.getSExtValue(),
+              d.getSExtValue());
+    break;
+  case 4:
+    l = c;
+    u = -1;
+    break;
+  case 5:
+    l = (a.slt(c) ? a : c);
+    u = maxOR(0, b.getSExtValue(), 0, d.getSExtValue());
+    break;
+  case 7:
+    l = minOR(a.getSExtValue(), 0xFFFFFFFF, c.getSExtValue(), d.getSExtValue());
+    u = minOR(0, b.getSExtValue(), c.getSExtValue(), d.getSExtValue());
+    break;
+  case 12:
+    l = minOR(a.getSExtValue(), b.getSExtValue(), c.getSExtValue(),
+              d.getSExtValue());
+    u = maxOR(a.getSExtValue(), b.getSExtValue(), c.getSExtValue(),
+              d.getSExtValue());
+    break;
+  case 13:
+    l = minOR(a.getSExtValue(), b.getSExtValue(), c.getSExtValue(), 0xFFFFFFFF);
+    u = maxOR(a.getSExtValue(), b.getSExtValue(), 0, d.getSExtValue());
+    break;
+  case 15:
+    l = minOR(a.getSExtValue(), b.getSExtValue(), c.getSExtValue(),
+              d.getSExtValue());
+    u = maxOR(a.getSExtValue(), b.getSExtValue(), c.getSExtValue(),
+              d.getSExtValue());
+    break;
+  }
+
+  return Range(l, u);
+}
+
+/*
+ * 	We don't have a xor implementation yet.
+ * 	To be in safe side, we just give maxrange as result.
+ */
+Range Range::Xor(const Range &other) const {
+  if (this->isUnknown() || other.isUnknown()) {
+    return Range(bitwidth, Unknown);
+  }
+
+  return Range(bitwidth);
+}
+
+// Truncate
+//		- if the source range is entirely inside max bit range, he is
+// the
+// result
+//      - else, the result is the max bit range
+Range Range::truncate(unsigned bitwidth) const {
+  if (isNative()) {
+    return nativeTruncate(bitwidth);
+  }
+
+  const APInt maxupper =
+      APInt::getSignedMaxValue(bitwidth).sextOrSelf(this->bitwidth);
+  const APInt maxlower =
+      APInt::getSignedMinValue(bitwidth).sextOrSelf(this->bitwidth);
+
+  // Check if source range is contained by max bit range
+  if (this->l.sge(maxlower) && this->u.sle(maxupper)) {
+    return Range(this->l.truncOrSelf(bitwidth), this->u.truncOrSelf(bitwidth),
+                 type);
+  }
+  return Range(bitwidth);
+}
+
+// Sign extension keeps the bounds, which are now inside the wider range.
+// Note that -inf and +inf of the source become plain numbers.
+Range Range::sextOrTrunc(unsigned bitwidth) const {
+  if (bitwidth <= this->bitwidth) {
+    return truncate(bitwidth);
+  }
+
+  if (isNative() && bitwidth <= 64) {
+    return Range(this->nl, this->nu, bitwidth, type);
+  }
+
+  return Range(getLower().sext(bitwidth), getUpper().sext(bitwidth), type);
+}
+
+// Zero extension of a non-negative range is the same as sign extension. A
+// range that may be negative can become any value the source width holds
+// when read as unsigned.
+Range Range::zextOrTrunc(unsigned bitwidth) const {
+  if (bitwidth <= this->bitwidth) {
+    return truncate(bitwidth);
+  }
+
+  if (!isRegular()) {
+    return Range(bitwidth, type);
+  }
+
+  if (getLower().isNonNegative()) {
+    return sextOrTrunc(bitwidth);
+  }
+
+  return Range(APInt::getNullValue(bitwidth),
+               APInt::getMaxValue(this->bitwidth).zext(bitwidth));
+}
+
+Range Range::resize(unsigned bitwidth) const {
+  if (bitwidth == this->bitwidth) {
+    return *this;
+  }
+
+  if (isNative() && bitwidth <= 64) {
+    const int64_t min = APInt::getSignedMinValue(bitwidth).getSExtValue();
+    const int64_t max = APInt::getSignedMaxValue(bitwidth).getSExtValue();
+    const int64_t lower = isLowerMin() ? min : std::min(std::max(nl, min), max);
+    const int64_t upper = isUpperMax() ? max : std::min(std::max(nu, min), max);
+    return Range(lower, upper, bitwidth, type);
+  }
+
+  const APInt min = APInt::getSignedMinValue(bitwidth);
+  const APInt max = APInt::getSignedMaxValue(bitwidth);
+  APInt lower = getLower();
+  APInt upper = getUpper();
+
+  if (bitwidth > this->bitwidth) {
+    lower = isLowerMin() ? min : lower.sext(bitwidth);
+    upper = isUpperMax() ? max : upper.sext(bitwidth);
+  } else {
+    lower = lower.slt(min.sext(this->bitwidth))
+                ? min
+                : (lower.sgt(max.sext(this->bitwidth)) ? max
+                                                       : lower.trunc(bitwidth));
+    upper = upper.slt(min.sext(this->bitwidth))
+                ? min
+                : (upper.sgt(max.sext(this->bitwidth)) ? max
+                                                       : upper.trunc(bitwidth));
+  }
+
+  return Range(lower, upper, type);
+}
+
+Range Range::intersectWith(const Range &other) const {
+  if (isNative()) {
+    return nativeIntersectWith(other);
+  }
+
+  if (this->isEmpty() || other.isEmpty()) {
+    return Range(bitwidth, Empty);
+  }
+
+  if (this->isUnknown()) {
+    return other;
+  }
+
+  if (other.isUnknown()) {
+    return *this;
+  }
+
+  const APInt &lower = this->l.sgt(other.l) ? this->l : other.l;
+  const APInt &upper = this->u.slt(other.u) ? this->u : other.u;
+  return Range(lower, upper);
+}
+
+Range Range::unionWith(const Range &other) const {
+  if (isNative()) {
+    return nativeUnionWith(other);
+  }
+
+  if (this->isEmpty()) {
+    return other;
+  }
+
+  if (other.isEmpty()) {
+    return *this;
+  }
+
+  if (this->isUnknown()) {
+    return other;
+  }
+
+  if (other.isUnknown()) {
+    return *this;
+  }
+
+  const APInt &lower = this->l.slt(other.l) ? this->l : other.l;
+  const APInt &upper = this->u.sgt(other.u) ? this->u : other.u;
+  return Range(lower, upper);
+}
+
+bool Range::operator==(const Range &other) const {
+  if (this->bitwidth != other.bitwidth) {
+    return false;
+  }
+  if (isNative()) {
+    return this->type == other.type && this->nl == other.nl &&
+           this->nu == other.nu;
+  }
+
+  return this->type == other.type && this->l.eq(other.l) &&
+         this->u.eq(other.u);
+}
+
+bool Range::operator!=(const Range &other) const {
+  return !(*this == other);
+}
+
+void Range::print(raw_ostream &OS) const {
+  if (this->isUnknown()) {
+    OS << "Unknown";
+    return;
+  }
+
+  if (this->isEmpty()) {
+    OS << "Empty";
+    return;
+  }
+
+  if (isLowerMin()) {
+    OS << "[-inf, ";
+  } else {
+    OS << "[" << getLower() << ", ";
+  }
+
+  if (isUpperMax()) {
+    OS << "+inf]";
+  } else {
+    OS << getUpper() << "]";
+  }
+}
+
+raw_ostream &operator<<(raw_ostream &OS, const Range &R) {
+  R.print(OS);
+  return OS;
+}
+
+// ========================================================================== //
+// Range (native backend)
+// ========================================================================== //
+//
+// The functions below mirror the APInt implementations above for ranges
+// that are at most 64 bits wide. Bounds are kept sign-extended to 64 bits,
+// Min and Max are the signed limits of the range's bit width, and every
+// result that falls outside of those limits saturates to them, exactly as
+// the overflow checks of the APInt versions do. Operations that look at the
+// bit pattern of a bound (unsigned division, shifts, the bitwise operators)
+// work on the low 'bitwidth' bits and sign-extend the result back.
+
+namespace {
+int64_t getSignedMinValue(unsigned bitwidth) {
+  return bitwidth >= 64 ? INT64_MIN : -(INT64_C(1) << (bitwidth - 1));
+}
+
+int64_t getSignedMaxValue(unsigned bitwidth) {
+  return bitwidth >= 64 ? INT64_MAX : (INT64_C(1) << (bitwidth - 1)) - 1;
+}
+
+/// Returns the low 'bitwidth' bits of a bound, as an unsigned value.
+uint64_t toBits(int64_t value, unsigned bitwidth) {
+  return static_cast<uint64_t>(value) & maskTrailingOnes<uint64_t>(bitwidth);
+}
+
+/// Sign-extends the low 'bitwidth' bits of a bit pattern back into a bound.
+int64_t fromBits(uint64_t bits, unsigned bitwidth) {
+  return SignExtend64(bits, bitwidth);
+}
+
+/// Native counterpart of MUL_HELPER.
+int64_t nativeMulHelper(int64_t x, int64_t y, int64_t min, int64_t max) {
+  if (x == max) {
+    return y < 0 ? min : (y == 0 ? 0 : max);
+  }
+  if (y == max) {
+    return x < 0 ? min : (x == 0 ? 0 : max);
+  }
+  if (x == min) {
+    return y < 0 ? max : (y == 0 ? 0 : min);
+  }
+  if (y == min) {
+    return x < 0 ? max : (x == 0 ? 0 : min);
+  }
+
+  int64_t xy;
+  if (__builtin_mul_overflow(x, y, &xy) || xy < min || xy > max) {
+    return (x < 0) == (y < 0) ? max : min;
+  }
+
+  return xy;
+}
+
+/// Native counterpart of DIV_HELPER. The division itself is only reached
+/// when neither operand is infinite.
+template <typename DivOp>
+int64_t nativeDivHelper(int64_t x, int64_t y, int64_t min, int64_t max,
+                        DivOp div) {
+  if (x == max) {
+    return y < 0 ? min : (y == 0 ? 0 : max);
+  }
+  if (y == max) {
+    return x < 0 ? min : (x == 0 ? 0 : max);
+  }
+  if (x == min) {
+    return y < 0 ? max : (y == 0 ? 0 : min);
+  }
+  if (y == min) {
+    return x < 0 ? max : (x == 0 ? 0 : min);
+  }
+
+  return div(x, y);
+}
+
+/// Shift amounts are read as unsigned values of the range's bit width.
+/// Amounts that are not smaller than the bit width shift every bit out.
+uint64_t getShiftAmount(int64_t value, unsigned bitwidth) {
+  return toBits(value, bitwidth);
+}
+
+int64_t nativeShlBound(int64_t x, int64_t amount, unsigned bitwidth) {
+  uint64_t shamt = getShiftAmount(amount, bitwidth);
+  if (shamt >= bitwidth) {
+    return 0;
+  }
+  return fromBits(toBits(x, bitwidth) << shamt, bitwidth);
+}
+
+int64_t nativeLshrBound(int64_t x, int64_t amount, unsigned bitwidth) {
+  uint64_t shamt = getShiftAmount(amount, bitwidth);
+  if (shamt >= bitwidth) {
+    return 0;
+  }
+  return fromBits(toBits(x, bitwidth) >> shamt, bitwidth);
+}
+
+int64_t nativeAshrBound(int64_t x, int64_t amount, unsigned bitwidth) {
+  uint64_t shamt = getShiftAmount(amount, bitwidth);
+  if (shamt >= bitwidth) {
+    return x < 0 ? -1 : 0;
+  }
+  return x >> shamt;
+}
+} // namespace
+
+Range::Range(int64_t lb, int64_t ub, unsigned bitwidth, RangeType rType)
+    : bitwidth(bitwidth), type(rType), nl(lb), nu(ub) {
+  if (lb > ub) {
+    type = Empty;
+  }
+}
+
+int64_t Range::getNativeMin() const { return getSignedMinValue(bitwidth); }
+
+int64_t Range::getNativeMax() const { return getSignedMaxValue(bitwidth); }
+
+Range Range::nativeAdd(const Range &other) const {
+  if (this->isUnknown() || other.isUnknown()) {
+    return Range(bitwidth, Unknown);
+  }
+
+  const int64_t min = getNativeMin();
+  const int64_t max = getNativeMax();
+  int64_t l = min, u = max;
+
+  if (this->nl != min && other.nl != min) {
+    if (__builtin_add_overflow(this->nl, other.nl, &l) || l < min || l > max) {
+      l = min;
+    }
+  }
+
+  if (this->nu != max && other.nu != max) {
+    if (__builtin_add_overflow(this->nu, other.nu, &u) || u < min || u > max) {
+      u = max;
+    }
+  }
+
+  return Range(l, u, bitwidth);
+}
+
+Range Range::nativeSub(const Range &other) const {
+  if (this->isUnknown() || other.isUnknown()) {
+    return Range(bitwidth, Unknown);
+  }
+
+  const int64_t min = getNativeMin();
+  const int64_t max = getNativeMax();
+  int64_t l = min, u = max;
+
+  // a-d
+  if (this->nl != min && other.nu != max) {
+    if (__builtin_sub_overflow(this->nl, other.nu, &l) || l < min || l > max) {
+      l = min;
+    }
+  }
+
+  // b-c
+  if (this->nu != max && other.nl != min) {
+    if (__builtin_sub_overflow(this->nu, other.nl, &u) || u < min || u > max) {
+      u = max;
+    }
+  }
+
+  return Range(l, u, bitwidth);
+}
+
+Range Range::nativeMul(const Range &other) const {
+  if (this->isUnknown() || other.isUnknown()) {
+    return Range(bitwidth, Unknown);
+  }
+
+  if (this->isMaxRange() || other.isMaxRange()) {
+    return Range(bitwidth);
+  }
+
+  const int64_t min = getNativeMin();
+  const int64_t max = getNativeMax();
+  const int64_t candidates[4] = {
+      nativeMulHelper(this->nl, other.nl, min, max),
+      nativeMulHelper(this->nl, other.nu, min, max),
+      nativeMulHelper(this->nu, other.nl, min, max),
+      nativeMulHelper(this->nu, other.nu, min, max)};
+
+  return Range(*std::min_element(candidates, candidates + 4),
+               *std::max_element(candidates, candidates + 4), bitwidth);
+}
+
+Range Range::nativeUdiv(const Range &other) const {
+  if (this->isUnknown() || other.isUnknown()) {
+    return Range(bitwidth, Unknown);
+  }
+
+  // Deal with division by 0 exception
+  if (other.nl == 0 || other.nu == 0) {
+    return Range(bitwidth);
+  }
+
+  const unsigned bw = bitwidth;
+  auto udiv = [bw](int64_t x, int64_t y) {
+    return fromBits(toBits(x, bw) / toBits(y, bw), bw);
+  };
+
+  const int64_t min = getNativeMin();
+  const int64_t max = getNativeMax();
+  const int64_t candidates[4] = {
+      nativeDivHelper(this->nl, other.nl, min, max, udiv),
+      nativeDivHelper(this->nl, other.nu, min, max, udiv),
+      nativeDivHelper(this->nu, other.nl, min, max, udiv),
+      nativeDivHelper(this->nu, other.nu, min, max, udiv)};
+
+  return Range(*std::min_element(candidates, candidates + 4),
+               *std::max_element(candidates, candidates + 4), bitwidth);
+}
+
+Range Range::nativeSdiv(const Range &other) const {
+  if (this->isUnknown() || other.isUnknown()) {
+    return Range(bitwidth, Unknown);
+  }
+
+  // Deal with division by 0 exception
+  if (other.nl <= 0 && other.nu >= 0) {
+    return Range(bitwidth);
+  }
+
+  // Min is caught by nativeDivHelper, so Min / -1 never reaches the division.
+  auto sdiv = [](int64_t x, int64_t y) { return x / y; };
+
+  const int64_t min = getNativeMin();
+  const int64_t max = getNativeMax();
+  const int64_t candidates[4] = {
+      nativeDivHelper(this->nl, other.nl, min, max, sdiv),
+      nativeDivHelper(this->nl, other.nu, min, max, sdiv),
+      nativeDivHelper(this->nu, other.nl, min, max, sdiv),
+      nativeDivHelper(this->nu, other.nu, min, max, sdiv)};
+
+  return Range(*std::min_element(candidates, candidates + 4),
+               *std::max_element(candidates, candidates + 4), bitwidth);
+}
+
+Range Range::nativeUrem(const Range &other) const {
+  if (this->isUnknown() || other.isUnknown()) {
+    return Range(bitwidth, Unknown);
+  }
+
+  const int64_t a = this->nl;
+  const int64_t b = this->nu;
+  const int64_t c = other.nl;
+  const int64_t d = other.nu;
+
+  // Deal with mod 0 exception
+  if (c == 0 || d == 0) {
+    return Range(bitwidth);
+  }
+
+  const int64_t min = getNativeMin();
+  const int64_t max = getNativeMax();
+  auto urem = [this](int64_t x, int64_t y) {
+    return fromBits(toBits(x, bitwidth) % toBits(y, bitwidth), bitwidth);
+  };
+
+  int64_t candidates[4] = {min, min, max, max};
+
+  if (a != min && c != min) {
+    candidates[0] = urem(a, c); // lower lower
+  }
+
+  if (a != min && d != max) {
+    candidates[1] = urem(a, d); // lower upper
+  }
+
+  if (b != max && c != min) {
+    candidates[2] = urem(b, c); // upper lower
+  }
+
+  if (b != max && d != max) {
+    candidates[3] = urem(b, d); // upper upper
+  }
+
+  return Range(*std::min_element(candidates, candidates + 4),
+               *std::max_element(candidates, candidates + 4), bitwidth);
+}
+
+Range Range::nativeSrem(const Range &other) const {
+  if ((other.isRegular() && other.nl == 0 && other.nu == 0) ||
+      (other.isEmpty() && other.isMaxRange())) {
+    return Range(bitwidth, Empty);
+  }
+
+  if (this->isUnknown() || other.isUnknown()) {
+    return Range(bitwidth, Unknown);
+  }
+
+  const int64_t a = this->nl;
+  const int64_t b = this->nu;
+  const int64_t c = other.nl;
+  const int64_t d = other.nu;
+
+  // Deal with mod 0 exception
+  if (c <= 0 && d >= 0) {
+    return Range(bitwidth);
+  }
+
+  const int64_t min = getNativeMin();
+  const int64_t max = getNativeMax();
+  // INT64_MIN % -1 traps, although its remainder is just 0.
+  auto srem = [](int64_t x, int64_t y) { return y == -1 ? 0 : x % y; };
+
+  int64_t candidates[4] = {min, min, max, max};
+
+  if (a != min && c != min) {
+    candidates[0] = srem(a, c); // lower lower
+  }
+
+  if (a != min && d != max) {
+    candidates[1] = srem(a, d); // lower upper
+  }
+
+  if (b != max && c != min) {
+    candidates[2] = srem(b, c); // upper lower
+  }
+
+  if (b != max && d != max) {
+    candidates[3] = srem(b, d); // upper upper
+  }
+
+  return Range(*std::min_element(candidates, candidates + 4),
+               *std::max_element(candidates, candidates + 4), bitwidth);
+}
+
+Range Range::nativeShl(const Range &other) const {
+  if (isEmpty()) {
+    return Range(*this);
+  }
+  if (other.isEmpty()) {
+    return Range(other);
+  }
+
+  if (this->isUnknown() || other.isUnknown()) {
+    return Range(bitwidth, Unknown);
+  }
+
+  const int64_t min = getNativeMin();
+  const int64_t max = getNativeMax();
+
+  if (this->nl == min || other.nl == min || this->nu == max ||
+      other.nu == max) {
+    return Range(bitwidth);
+  }
+
+  // The shift is safe as long as it keeps the leading zeros of the upper bound
+  uint64_t zeros = countLeadingZeros(toBits(this->nu, bitwidth)) -
+                   (64 - bitwidth);
+  if (zeros > toBits(other.nu, bitwidth)) {
+    return Range(nativeShlBound(this->nl, other.nl, bitwidth),
+                 nativeShlBound(this->nu, other.nu, bitwidth), bitwidth);
+  }
+
+  // [-inf, +inf]
+  return Range(bitwidth);
+}
+
+Range Range::nativeLshr(const Range &other) const {
+  if (isEmpty()) {
+    return Range(*this);
+  }
+  if (other.isEmpty()) {
+    return Range(other);
+  }
+
+  if (this->isUnknown() || other.isUnknown()) {
+    return Range(bitwidth, Unknown);
+  }
+
+  if (this->nl == getNativeMin() || other.nl == getNativeMin() ||
+      this->nu == getNativeMax() || other.nu == getNativeMax()) {
+    return Range(bitwidth);
+  }
+
+  return Range(nativeLshrBound(this->nl, other.nu, bitwidth),
+               nativeLshrBound(this->nu, other.nl, bitwidth), bitwidth);
+}
+
+Range Range::nativeAshr(const Range &other) const {
+  if (isEmpty()) {
+    return Range(*this);
+  }
+  if (other.isEmpty()) {
+    return Range(other);
+  }
+
+  if (this->isUnknown() || other.isUnknown()) {
+    return Range(bitwidth, Unknown);
+  }
+
+  if (this->nl == getNativeMin() || other.nl == getNativeMin() ||
+      this->nu == getNativeMax() || other.nu == getNativeMax()) {
+    return Range(bitwidth);
+  }
+
+  return Range(nativeAshrBound(this->nl, other.nu, bitwidth),
+               nativeAshrBound(this->nu, other.nl, bitwidth), bitwidth);
+}
+
+Range Range::nativeAnd(const Range &other) const {
+  if (this->isUnknown() || other.isUnknown()) {
+    uint64_t umin =
+        std::min(toBits(this->nu, bitwidth), toBits(other.nu, bitwidth));
+    if (umin == maskTrailingOnes<uint64_t>(bitwidth)) {
+      return Range(bitwidth);
+    }
+    return Range(0, fromBits(umin, bitwidth), bitwidth);
+  }
+
+  const int64_t a = this->nl;
+  const int64_t b = this->nu;
+  const int64_t c = other.nl;
+  const int64_t d = other.nu;
+
+  if (a == getNativeMin() || b == getNativeMax() || c == getNativeMin() ||
+      d == getNativeMax()) {
+    return Range(bitwidth);
+  }
+
+  // negate everybody
+  Range inv1 = Range(~b, ~a, bitwidth);
+  Range inv2 = Range(~d, ~c, bitwidth);
+
+  Range invres = inv1.nativeOr(inv2);
+
+  // negate the result of the 'or'
+  return Range(~invres.nu, ~invres.nl, bitwidth);
+}
+
+Range Range::nativeAnd_conservative(const Range &other) const {
+  if (isEmpty()) {
+    return Range(*this);
+  }
+  if (other.isEmpty()) {
+    return Range(other);
+  }
+
+  uint64_t umin =
+      std::min(toBits(other.nu, bitwidth), toBits(this->nu, bitwidth));
+  if (umin == maskTrailingOnes<uint64_t>(bitwidth)) {
+    return Range(bitwidth);
+  }
+  return Range(0, fromBits(umin, bitwidth), bitwidth);
+}
+
+Range Range::nativeOr_conservative(const Range &other) const {
+  if (isEmpty()) {
+    return Range(*this);
+  }
+  if (other.isEmpty()) {
+    return Range(other);
+  }
+
+  if (this->isUnknown() || other.isUnknown()) {
+    return Range(bitwidth, Unknown);
+  }
+
+  uint64_t umax =
+      std::max(toBits(this->nl, bitwidth), toBits(other.nl, bitwidth));
+  if (umax == 0) {
+    return Range(bitwidth);
+  }
+
+  return Range(fromBits(umax, bitwidth), 0, bitwidth);
+}
+
+Range Range::nativeOr(const Range &other) const {
+  const int64_t a = this->nl;
+  const int64_t b = this->nu;
+  const int64_t c = other.nl;
+  const int64_t d = other.nu;
+
+  if (this->isUnknown() || other.isUnknown()) {
+    return Range(bitwidth, Unknown);
+  }
+  if (a == getNativeMin() || b == getNativeMax() || c == getNativeMin() ||
+      d == getNativeMax()) {
+    return Range(bitwidth);
+  }
+
+  unsigned char switchval = 0;
+  switchval += (a >= 0 ? 1 : 0);
+  switchval <<= 1;
+  switchval += (b >= 0 ? 1 : 0);
+  switchval <<= 1;
+  switchval += (c >= 0 ? 1 : 0);
+  switchval <<= 1;
+  switchval += (d >= 0 ? 1 : 0);
+
+  int64_t l = getNativeMin(), u = getNativeMax();
+
+  switch (switchval) {
+  case 0:
+  case 3:
+  case 12:
+  case 15:
+    l = minOR(a, b, c, d);
+    u = maxOR(a, b, c, d);
+    break;
+  case 1:
+    l = a;
+    u = -1;
+    break;
+  case 4:
+    l = c;
+    u = -1;
+    break;
+  case 5:
+    l = (a < c ? a : c);
+    u = maxOR(0, b, 0, d);
+    break;
+  case 7:
+    l = minOR(a, 0xFFFFFFFF, c, d);
+    u = minOR(0, b, c, d);
+    break;
+  case 13:
+    l = minOR(a, b, c, 0xFFFFFFFF);
+    u = maxOR(a, b, 0, d);
+    break;
+  }
+
+  // Like the APInt version, keep only the bits that fit in the range
+  return Range(fromBits(toBits(l, bitwidth), bitwidth),
+               fromBits(toBits(u, bitwidth), bitwidth), bitwidth);
+}
+
+Range Range::nativeTruncate(unsigned bitwidth) const {
+  const int64_t maxupper = getSignedMaxValue(bitwidth);
+  const int64_t maxlower = getSignedMinValue(bitwidth);
+
+  // Check if source range is contained by max bit range
+  if (this->nl >= maxlower && this->nu <= maxupper) {
+    return Range(this->nl, this->nu, bitwidth, type);
+  }
+  return Range(bitwidth);
+}
+
+Range Range::nativeIntersectWith(const Range &other) const {
+  if (this->isEmpty() || other.isEmpty()) {
+    return Range(bitwidth, Empty);
+  }
+
+  if (this->isUnknown()) {
+    return other;
+  }
+
+  if (other.isUnknown()) {
+    return *this;
+  }
+
+  return Range(std::max(this->nl, other.nl), std::min(this->nu, other.nu),
+               bitwidth);
+}
+
+Range Range::nativeUnionWith(const Range &other) const {
+  if (this->isEmpty()) {
+    return other;
+  }
+
+  if (other.isEmpty()) {
+    return *this;
+  }
+
+  if (this->isUnknown()) {
+    return other;
+  }
+
+  if (other.isUnknown()) {
+    return *this;
+  }
+
+  return Range(std::min(this->nl, other.nl), std::max(this->nu, other.nu),
+               bitwidth);
+}
+
+// ========================================================================== //
+// BasicInterval
+// ========================================================================== //
+
+BasicInterval::BasicInterval(Range range) : range(std::move(range)) {}
+
+BasicInterval::BasicInterval(unsigned bitwidth) : range(Range(bitwidth)) {}
+
+BasicInterval::BasicInterval(const APInt &l, const APInt &u)
+    : range(Range(l, u)) {}
+
+// This is a base class, its dtor must be virtual.
+BasicInterval::~BasicInterval() = default;
+
+// ========================================================================== //
+// SymbInterval
+// ========================================================================== //
+
+SymbInterval::SymbInterval(const Range &range, const Value *bound,
+                           CmpInst::Predicate pred)
+    : BasicInterval(range), bound(bound), pred(pred) {}
+
+SymbInterval::~SymbInterval() = default;
+
+Range SymbInterval::fixIntersects(VarNode *bound, VarNode *sink) {
+  // Get the lower and the upper bound of the
+  // node which bounds this intersection. The bound may come from a cast of
+  // the sink, so it is moved to the sink's width first.
+  const Range boundRange = bound->getRange().resize(sink->getBitWidth());
+  APInt l = boundRange.getLower();
+  APInt u = boundRange.getUpper();
+
+  // Get the lower and upper bound of the interval of this operation
+  APInt lower = sink->getRange().getLower();
+  APInt upper = sink->getRange().getUpper();
+
+  switch (this->getOperation()) {
+  case CmpInst::ICMP_EQ: // equal
+    return Range(l, u);
+    break;
+  case CmpInst::ICMP_SLE: // signed less or equal
+    return Range(lower, u);
+    break;
+  case CmpInst::ICMP_SLT: // signed less than
+    if (!boundRange.isUpperMax()) {
+      return Range(lower, u - 1);
+    } else {
+      return Range(lower, u);
+    }
+    break;
+  case CmpInst::ICMP_SGE: // signed greater or equal
+    return Range(l, upper);
+    break;
+  case CmpInst::ICMP_SGT: // signed greater than
+    if (!boundRange.isLowerMin()) {
+      return Range(l + 1, upper);
+    } else {
+      return Range(l, upper);
+    }
+    break;
+  default:
+    return Range(sink->getBitWidth());
+  }
+
+  return Range(sink->getBitWidth());
+}
+
+// ========================================================================== //
+// BoundsTable
+// ========================================================================== //
+
+unsigned BoundsTable::add(const Range &R) {
+  const unsigned id = widths.size();
+  widths.push_back(R.getBitWidth());
+  types.push_back(R.type);
+  if (R.isNative()) {
+    lower.push_back(R.nl);
+    upper.push_back(R.nu);
+  } else {
+    lower.push_back(wide.size());
+    upper.push_back(0);
+    wide.push_back(std::make_pair(R.l, R.u));
+  }
+  return id;
+}
+
+void BoundsTable::setShared(bool shared) {
+  if (!shared) {
+    locks.reset();
+  } else if (!locks) {
+    locks.reset(new std::atomic<bool>[widths.size()]());
+  }
+}
+
+void BoundsTable::permute(ArrayRef<unsigned> order) {
+  assert(!locks && "Entries of a shared table cannot move");
+  SmallVector<int64_t, 0> newLower(order.size());
+  SmallVector<int64_t, 0> newUpper(order.size());
+  SmallVector<unsigned, 0> newWidths(order.size());
+  SmallVector<RangeType, 0> newTypes(order.size());
+  SmallVector<std::pair<APInt, APInt>, 0> newWide;
+  newWide.reserve(wide.size());
+  for (unsigned id = 0, e = order.size(); id < e; ++id) {
+    const unsigned old = order[id];
+    newWidths[id] = widths[old];
+    newTypes[id] = types[old];
+    if (widths[old] <= 64) {
+      newLower[id] = lower[old];
+      newUpper[id] = upper[old];
+    } else {
+      newLower[id] = newWide.size();
+      newWide.push_back(std::move(wide[lower[old]]));
+    }
+  }
+  lower.swap(newLower);
+  upper.swap(newUpper);
+  widths.swap(newWidths);
+  types.swap(newTypes);
+  wide.swap(newWide);
+}
+
+void BoundsTable::clear() {
+  locks.reset();
+  lower.clear();
+  upper.clear();
+  widths.clear();
+  types.clear();
+  wide.clear();
+}
+
+// ========================================================================== //
+// VarNode
+// ========================================================================== //
+
+VarNode::VarNode(const Range &R, bool constant, BoundsTable *bounds)
+    : V(nullptr), bounds(bounds), id(bounds->add(R)), abstractState(0),
+      constant(constant) {}
+
+/// The dtor.
+VarNode::~VarNode() = default;
+
+void VarNode::moveTo(BoundsTable *newBounds) {
+  id = newBounds->add(getRange());
+  bounds = newBounds;
+}
+
+void VarNode::storeAbstractState() {
+  const Range interval = getRange();
+  ASSERT(!interval.isUnknown(), "storeAbstractState doesn't handle empty set")
+
+  if (interval.isLowerMin()) {
+    if (interval.isUpperMax()) {
+      this->abstractState = '?';
+    } else {
+      this->abstractState = '-';
+    }
+  } else if (interval.isUpperMax()) {
+    this->abstractState = '+';
+  } else {
+    this->abstractState = '0';
+  }
+}
+
+// ========================================================================== //
+// BasicOp
+// ========================================================================== //
+
+static_assert(sizeof(UnaryOp) == sizeof(BasicOp) &&
+                  sizeof(SigmaOp) == sizeof(BasicOp) &&
+                  sizeof(BinaryOp) == sizeof(BasicOp) &&
+                  sizeof(TernaryOp) == sizeof(BasicOp) &&
+                  sizeof(PhiOp) == sizeof(BasicOp),
+              "Operations must not add fields to BasicOp");
+static_assert(std::is_trivially_destructible<BasicOp>::value,
+              "Operations are released without running destructors");
+
+/// We can not want people creating objects of this class,
+/// but we want to inherit of it.
+BasicOp::BasicOp(OperationId kind, BasicInterval *intersect, VarNode *sink,
+                 const Instruction *inst, unsigned opcode)
+    : intersect(intersect), sink(sink), inst(inst), inlineSources(),
+      opcode(opcode), kind(kind) {}
+
+/// Evaluates the operation according to its kind.
+Range BasicOp::eval() const {
+  switch (kind) {
+  case OperationId::UnaryOpId:
+    return static_cast<const UnaryOp *>(this)->eval();
+  case OperationId::SigmaOpId:
+    return static_cast<const SigmaOp *>(this)->eval();
+  case OperationId::BinaryOpId:
+    return static_cast<const BinaryOp *>(this)->eval();
+  case OperationId::TernaryOpId:
+    return static_cast<const TernaryOp *>(this)->eval();
+  case OperationId::PhiOpId:
+    return static_cast<const PhiOp *>(this)->eval();
+  }
+  llvm_unreachable("Unknown operation kind");
+}
+
+void BasicOp::replaceSource(const VarNode *from, VarNode *to) {
+  for (unsigned i = 0; i < numSources; ++i) {
+    if (kind == OperationId::PhiOpId) {
+      if (phiSources[i] == from) {
+        phiSources[i] = to;
+      }
+    } else if (inlineSources[i] == from) {
+      inlineSources[i] = to;
+    }
+  }
+}
+
+/// Replace symbolic intervals with hard-wired constants.
+void BasicOp::fixIntersects(VarNode *V) {
+  if (SymbInterval *SI = dyn_cast<SymbInterval>(getIntersect())) {
+    Range r = SI->fixIntersects(V, getSink());
+    this->setIntersect(SI->fixIntersects(V, getSink()));
+  }
+}
+
+// ========================================================================== //
+// UnaryOp
+// ========================================================================== //
+
+UnaryOp::UnaryOp(OperationId kind, BasicInterval *intersect, VarNode *sink,
+                 const Instruction *inst, VarNode *source, unsigned int opcode)
+    : BasicOp(kind, intersect, sink, inst, opcode) {
+  inlineSources[0] = source;
+  numSources = 1;
+}
+
+UnaryOp::UnaryOp(BasicInterval *intersect, VarNode *sink,
+                 const Instruction *inst, VarNode *source, unsigned int opcode)
+    : UnaryOp(OperationId::UnaryOpId, intersect, sink, inst, source, opcode) {
+}
+
+/// Computes the interval of the sink based on the interval of the sources,
+/// the operation and the interval associated to the operation.
+Range UnaryOp::eval() const {
+
+  unsigned bw = getSink()->getBitWidth();
+  Range oprnd = getSource()->getRange();
+  Range result(bw, Unknown);
+
+  if (oprnd.isRegular()) {
+    switch (this->getOpcode()) {
+    case Instruction::Trunc:
+      result = oprnd.truncate(bw);
+      break;
+    case Instruction::ZExt:
+      result = oprnd.zextOrTrunc(bw);
+      break;
+    case Instruction::SExt:
+      result = oprnd.sextOrTrunc(bw);
+      break;
+    default:
+      // Loads and Stores are handled here.
+      result = oprnd;
+      break;
+    }
+  } else if (oprnd.isEmpty()) {
+    result = Range(bw, Empty);
+  }
+
+  if (!getIntersect()->getRange().isMaxRange()) {
+    Range aux(getIntersect()->getRange());
+    result = result.intersectWith(aux);
+  }
+
+  // To ensure that we always are dealing with the correct bit width.
+  return result;
+}
+
+// ========================================================================== //
+// SigmaOp
+// ========================================================================== //
+
+SigmaOp::SigmaOp(BasicInterval *intersect, VarNode *sink,
+                 const Instruction *inst, VarNode *source, unsigned int opcode)
+    : UnaryOp(OperationId::SigmaOpId, intersect, sink, inst, source, opcode) {
+}
+
+/// Computes the interval of the sink based on the interval of the sources,
+/// the operation and the interval associated to the operation.
+Range SigmaOp::eval() const {
+  Range result = this->getSource()->getRange();
+
+  result = result.intersectWith(getIntersect()->getRange());
+
+  return result;
+}
+
+// ========================================================================== //
+// BinaryOp
+// ========================================================================== //
+
+// The ctor.
+BinaryOp::BinaryOp(BasicInterval *intersect, VarNode *sink,
+                   const Instruction *inst, VarNode *source1, VarNode *source2,
+                   unsigned int opcode)
+    : BasicOp(OperationId::BinaryOpId, intersect, sink, inst, opcode) {
+  inlineSources[0] = source1;
+  inlineSources[1] = source2;
+  numSources = 2;
+}
+
+/// Computes the interval of the sink based on the interval of the sources,
+/// the operation and the interval associated to the operation.
+/// Basically, this function performs the operation indicated in its opcode
+/// taking as its operands the source1 and the source2.
+Range BinaryOp::eval() const {
+
+  Range op1 = this->getSource1()->getRange();
+  Range op2 = this->getSource2()->getRange();
+  Range result(op1.getBitWidth(), Unknown);
+
+  // only evaluate if all operands are Regular
+  if (op1.isRegular() && op2.isRegular()) {
+    switch (this->getOpcode()) {
+    case Instruction::Add:
+      result = op1.add(op2);
+      break;
+    case Instruction::Sub:
+      result = op1.sub(op2);
+      break;
+    case Instruction::Mul:
+      result = op1.mul(op2);
+      break;
+    case Instruction::UDiv:
+      result = op1.udiv(op2);
+      break;
+    case Instruction::SDiv:
+      result = op1.sdiv(op2);
+      break;
+    case Instruction::URem:
+      result = op1.urem(op2);
+      break;
+    case Instruction::SRem:
+      result = op1.srem(op2);
+      break;
+    case Instruction::Shl:
+      result = op1.shl(op2);
+      break;
+    case Instruction::LShr:
+      result = op1.lshr(op2);
+      break;
+    case Instruction::AShr:
+      result = op1.ashr(op2);
+      break;
+    case Instruction::And:
+      result = op1.And(op2);
+      break;
+    case Instruction::Or:
+      // We have two versions of the 'or' operator
+      // One of them gives tight results, but only works
+      // for 64-bit values or less.
+      if (op1.getBitWidth() <= 64) {
+        result = op1.Or(op2);
+      } else {
+        result = op1.Or_conservative(op2);
+      }
+      break;
+    case Instruction::Xor:
+      result = op1.Xor(op2);
+      break;
+    default:
+      break;
+    }
+
+    // If resulting interval has become inconsistent, set it to max range for
+    // safety
+    if (result.hasInvertedBounds()) {
+      result = Range(result.getBitWidth());
+    }
+
+    // FIXME: check if this intersection happens
+    bool test = this->getIntersect()->getRange().isMaxRange();
+
+    if (!test) {
+      Range aux = this->getIntersect()->getRange();
+      result = result.intersectWith(aux);
+    }
+  } else {
+    if (op1.isEmpty() || op2.isEmpty()) {
+      result = Range(op1.getBitWidth(), Empty);
+    }
+  }
+
+  return result;
+}
+
+// ========================================================================== //
+// TernaryOp
+// ========================================================================== //
+
+// The ctor.
+TernaryOp::TernaryOp(BasicInterval *intersect, VarNode *sink,
+                     const Instruction *inst, VarNode *source1,
+                     VarNode *source2, VarNode *source3, unsigned int opcode)
+    : BasicOp(OperationId::TernaryOpId, intersect, sink, inst, opcode) {
+  inlineSources[0] = source1;
+  inlineSources[1] = source2;
+  inlineSources[2] = source3;
+  numSources = 3;
+}
+
+Range TernaryOp::eval() const {
+
+  Range op1 = this->getSource1()->getRange();
+  Range op2 = this->getSource2()->getRange();
+  Range op3 = this->getSource3()->getRange();
+  Range result(op2.getBitWidth(), Unknown);
+
+  // only evaluate if all operands are Regular
+  if (op1.isRegular() && op2.isRegular() && op3.isRegular()) {
+    switch (this->getOpcode()) {
+    case Instruction::Select: {
+      // Source1 is the selector
+      const APInt One(op1.getBitWidth(), 1);
+      const APInt Zero(op1.getBitWidth(), 0);
+      if (op1 == Range(One, One)) {
+        result = op2;
+      } else if (op1 == Range(Zero, Zero)) {
+        result = op3;
+      } else {
+        result = op2.unionWith(op3);
+      }
+    } break;
+    default:
+      break;
+    }
+
+    // If resulting interval has become inconsistent, set it to max range for
+    // safety
+    if (result.hasInvertedBounds()) {
+      result = Range(result.getBitWidth());
+    }
+
+    // FIXME: check if this intersection happens
+    bool test = this->getIntersect()->getRange().isMaxRange();
+
+    if (!test) {
+      Range aux = this->getIntersect()->getRange();
+      result = result.intersectWith(aux);
+    }
+  } else {
+    if (op1.isEmpty() || op2.isEmpty() || op3.isEmpty()) {
+      result = Range(op2.getBitWidth(), Empty);
+    }
+  }
+
+  return result;
+}
+
+// ========================================================================== //
+// PhiOp
+// ========================================================================== //
+
+// The ctor.
+PhiOp::PhiOp(BasicInterval *intersect, VarNode *sink, const Instruction *inst,
+             const VarNode **sources, unsigned maxSources)
+    : BasicOp(OperationId::PhiOpId, intersect, sink, inst) {
+  phiSources = sources;
+  this->maxSources = maxSources;
+}
+
+// Add source to the vector of sources
+void PhiOp::addSource(const VarNode *newsrc) {
+  assert(numSources < maxSources && "Phi operation has no room left");
+  phiSources[numSources++] = newsrc;
+}
+
+/// Computes the interval of the sink based on the interval of the sources.
+/// The result of evaluating a phi-function is the union of the ranges of
+/// every variable used in the phi.
+Range PhiOp::eval() const {
+  if (numSources == 0) {
+    return Range(getSink()->getBitWidth(), Unknown);
+  }
+
+  Range result = this->getSource(0)->getRange();
+
+  // Iterate over the sources of the phiop
+  for (unsigned i = 1; i < numSources; ++i) {
+    result = result.unionWith(phiSources[i]->getRange());
+  }
+
+  return result;
+}
+
+// ========================================================================== //
+// ValueBranchMap
+// ========================================================================== //
+
+ValueBranchMap::ValueBranchMap(const Value *V, const BasicBlock *BBTrue,
+                               const BasicBlock *BBFalse, BasicInterval *ItvT,
+                               BasicInterval *ItvF)
+    : V(V), BBTrue(BBTrue), BBFalse(BBFalse), ItvT(ItvT), ItvF(ItvF) {}
+
+ValueBranchMap::~ValueBranchMap() = default;
+
+// ========================================================================== //
+// ValueSwitchMap
+// ========================================================================== //
+
+ValueSwitchMap::ValueSwitchMap(
+    const Value *V,
+    SmallVector<std::pair<BasicInterval *, const BasicBlock *>, 4> &BBsuccs)
+    : V(V), BBsuccs(BBsuccs) {}
+
+ValueSwitchMap::~ValueSwitchMap() = default;
+
+// ========================================================================== //
+// GraphFile
+// ========================================================================== //
+
+const char GraphFile::Magic[8] = {'R', 'A', 'G', 'R', 'A', 'P', 'H', '\0'};
+
+uint64_t GraphFile::getRecordSize(const Header &H) {
+  const uint64_t numNodes = H.numNodes;
+  const uint64_t listSize = (numNodes + 1) * sizeof(Word32);
+  return alignTo(sizeof(Header), 8) + alignTo(H.nameSize, 8) +
+         alignTo(numNodes * sizeof(NodeRecord), 8) +
+         alignTo(uint64_t(H.numOps) * sizeof(OpRecord), 8) +
+         alignTo(uint64_t(H.numSources) * sizeof(Word32), 8) +
+         alignTo(listSize, 8) +
+         alignTo(uint64_t(H.numUses) * sizeof(Word32), 8) +
+         alignTo(listSize, 8) +
+         alignTo(uint64_t(H.numSymbUses) * sizeof(Word32), 8) +
+         uint64_t(H.numWords) * sizeof(Word64);
+}
+
+namespace {
+/// Returns the next section of a record, of count elements of type T, and
+/// moves section past it.
+template <class T>
+ArrayRef<T> takeSection(const char *&section, uint64_t count) {
+  ArrayRef<T> elements(reinterpret_cast<const T *>(section), count);
+  section += alignTo(count * sizeof(T), 8);
+  return elements;
+}
+} // end anonymous namespace
+
+bool GraphFile::parse() {
+  const char *data = region ? region->const_data() : nullptr;
+  const uint64_t fileSize = region ? region->size() : 0;
+
+  for (uint64_t offset = 0; offset < fileSize;) {
+    if (fileSize - offset < sizeof(Header)) {
+      return false;
+    }
+    const Header &H = *reinterpret_cast<const Header *>(data + offset);
+    if (std::memcmp(H.magic, Magic, sizeof(Magic)) != 0 ||
+        H.version != Version || H.size != getRecordSize(H) ||
+        H.size > fileSize - offset) {
+      return false;
+    }
+
+    const char *section = data + offset + alignTo(sizeof(Header), 8);
+    Record R;
+    R.name = StringRef(section, H.nameSize);
+    section += alignTo(H.nameSize, 8);
+    R.nodes = takeSection<NodeRecord>(section, H.numNodes);
+    R.ops = takeSection<OpRecord>(section, H.numOps);
+    R.sources = takeSection<Word32>(section, H.numSources);
+    R.useBegin = takeSection<Word32>(section, uint64_t(H.numNodes) + 1);
+    R.useOps = takeSection<Word32>(section, H.numUses);
+    R.symbBegin = takeSection<Word32>(section, uint64_t(H.numNodes) + 1);
+    R.symbOps = takeSection<Word32>(section, H.numSymbUses);
+    R.words = takeSection<Word64>(section, H.numWords);
+    records.push_back(R);
+
+    offset += H.size;
+  }
+  return true;
+}
+
+std::unique_ptr<GraphFile> GraphFile::open(const std::string &FileName) {
+  int FD;
+  uint64_t fileSize = 0;
+  std::error_code ErrorInfo = sys::fs::openFileForRead(FileName, FD);
+  if (ErrorInfo) {
+    errs() << "ERROR: file " << FileName << " can't be opened!\n";
+    return nullptr;
+  }
+  ErrorInfo = sys::fs::file_size(FileName, fileSize);
+
+  // A file without records cannot be mapped
+  std::unique_ptr<sys::fs::mapped_file_region> region;
+  if (!ErrorInfo && fileSize != 0) {
+    region = std::make_unique<sys::fs::mapped_file_region>(
+        FD, sys::fs::mapped_file_region::readonly, fileSize, 0, ErrorInfo);
+  }
+  sys::Process::SafelyCloseFileDescriptor(FD);
+  if (ErrorInfo) {
+    errs() << "ERROR: file " << FileName << " can't be mapped!\n";
+    return nullptr;
+  }
+
+  std::unique_ptr<GraphFile> File(new GraphFile(std::move(region)));
+  if (!File->parse()) {
+    errs() << "ERROR: file " << FileName
+           << " is not a graph file of version " << Version << "\n";
+    return nullptr;
+  }
+  return File;
+}
+
+// ========================================================================== //
+// ConstraintGraph
+// ========================================================================== //
+
+const unsigned ConstraintGraph::NoOp;
+
+/// The dtor.
+ConstraintGraph::~ConstraintGraph() { clear(); }
+
+
+void JumpSet::finish() {
+  std::sort(indices.begin(), indices.end());
+  indices.erase(std::unique(indices.begin(), indices.end()), indices.end());
+}
+
+/*
+ * Get the first constant of the set greater than or equal to val
+ */
+APInt JumpSet::getFirstGreater(const APInt &val) const {
+  const unsigned bitwidth = val.getBitWidth();
+  if (!indices.empty()) {
+    const unsigned width =
+        std::max(bitwidth, (*constants)[indices[0]].getBitWidth());
+    const APInt wideVal = val.sextOrSelf(width);
+    const unsigned *it = std::lower_bound(
+        indices.begin(), indices.end(), wideVal,
+        [this, width](unsigned idx, const APInt &V) {
+          return (*constants)[idx].sextOrSelf(width).slt(V);
+        });
+    // A constant that does not fit in val's width is above every value it
+    // can take.
+    if (it != indices.end() && (*constants)[*it].isSignedIntN(bitwidth)) {
+      return (*constants)[*it].sextOrTrunc(bitwidth);
+    }
+  }
+
+  return APInt::getSignedMaxValue(bitwidth);
+}
+
+/*
+ * Get the last constant of the set less than or equal to val
+ */
+APInt JumpSet::getFirstLess(const APInt &val) const {
+  const unsigned bitwidth = val.getBitWidth();
+  if (!indices.empty()) {
+    const unsigned width =
+        std::max(bitwidth, (*constants)[indices[0]].getBitWidth());
+    const APInt wideVal = val.sextOrSelf(width);
+    const unsigned *it = std::upper_bound(
+        indices.begin(), indices.end(), wideVal,
+        [this, width](const APInt &V, unsigned idx) {
+          return V.slt((*constants)[idx].sextOrSelf(width));
+        });
+    // A constant that does not fit in val's width is below every value it
+    // can take.
+    if (it != indices.begin() &&
+        (*constants)[*(it - 1)].isSignedIntN(bitwidth)) {
+      return (*constants)[*(it - 1)].sextOrTrunc(bitwidth);
+    }
+  }
+
+  return APInt::getSignedMinValue(bitwidth);
+}
+
+/*
+ * Collects the constants the jump-set widening may use, once for the whole
+ * graph. They include:
+ *   - Constant nodes
+ *   - Bounds of the intersections of sigmas which are not symbolic
+ * Each node also records the indices of the constants of its own value and
+ * of the constant sources of its definition, which are the constants that a
+ * component takes from its nodes.
+ */
+void ConstraintGraph::buildThresholds() {
+  const unsigned numNodes = nodes.size();
+  thresholds.clear();
+
+  // The range of a constant is its value
+  for (VarNode *varNode : nodes) {
+    if (varNode->isConstant()) {
+      thresholds.push_back(varNode->getRange().getLower());
+    }
+  }
+  for (BasicOp *op : ops) {
+    if (!isa<SigmaOp>(op) || isa<SymbInterval>(op->getIntersect())) {
+      continue;
+    }
+
+    const Range &rintersect = op->getIntersect()->getRange();
+    const APInt &lb = rintersect.getLower();
+    const APInt &ub = rintersect.getUpper();
+
+    if (!lb.isMinSignedValue() && !lb.isMaxSignedValue()) {
+      thresholds.push_back(lb);
+    }
+    if (!ub.isMinSignedValue() && !ub.isMaxSignedValue()) {
+      thresholds.push_back(ub);
+    }
+  }
+
+  // Bring every constant to the widest width among them, so they can be
+  // compared with each other, then sort them and remove the duplicates
+  unsigned bitwidth = 1;
+  for (const APInt &constant : thresholds) {
+    bitwidth = std::max(bitwidth, constant.getBitWidth());
+  }
+  for (APInt &constant : thresholds) {
+    constant = constant.sextOrSelf(bitwidth);
+  }
+  std::sort(thresholds.begin(), thresholds.end(),
+            [](const APInt &i1, const APInt &i2) { return i1.slt(i2); });
+  thresholds.erase(std::unique(thresholds.begin(), thresholds.end()),
+                   thresholds.end());
+
+  // The constants of each node
+  thresholdBegin.resize(numNodes + 1);
+  thresholdIdx.clear();
+  for (VarNode *varNode : nodes) {
+    thresholdBegin[varNode->getId()] = thresholdIdx.size();
+    if (varNode->isConstant()) {
+      thresholdIdx.push_back(getThresholdIndex(varNode->getRange().getLower()));
+    }
+
+    const unsigned def = defOp[varNode->getId()];
+    if (def == NoOp) {
+      continue;
+    }
+
+    SmallVector<const VarNode *, 2> sources;
+    if (const BinaryOp *bop = dyn_cast<BinaryOp>(ops[def])) {
+      sources.push_back(bop->getSource1());
+      sources.push_back(bop->getSource2());
+    } else if (const PhiOp *pop = dyn_cast<PhiOp>(ops[def])) {
+      for (unsigned i = 0, e = pop->getNumSources(); i < e; ++i) {
+        sources.push_back(pop->getSource(i));
+      }
+    }
+    for (const VarNode *source : sources) {
+      if (source->isConstant()) {
+        thresholdIdx.push_back(
+            getThresholdIndex(source->getRange().getLower()));
+      }
+    }
+  }
+  thresholdBegin[numNodes] = thresholdIdx.size();
+}
+
+unsigned ConstraintGraph::getThresholdIndex(const APInt &C) const {
+  const APInt wideC = C.sextOrSelf(thresholds.front().getBitWidth());
+  const APInt *it =
+      std::lower_bound(thresholds.begin(), thresholds.end(), wideC,
+                       [](const APInt &i1, const APInt &i2) {
+                         return i1.slt(i2);
+                       });
+  assert(it != thresholds.end() && *it == wideC && "Unknown constant");
+  return it - thresholds.begin();
+}
+
+/*
+ * Fills the jump-set with the constants related to the component
+ * They include:
+ *   - Constants inside component
+ *   - Constants that are source of an edge to an entry point
+ *   - Constants from intersections generated by sigmas
+ */
+void ConstraintGraph::buildConstantVector(
+    const SmallPtrSet<VarNode *, 32> &component,
+    const ComponentUseMap &compusemap) {
+  JumpSet &jumpset = compusemap.getWorkspace().jumpset;
+  jumpset.clear();
+
+  for (VarNode *varNode : component) {
+    const unsigned id = varNode->getId();
+    for (unsigned i = thresholdBegin[id], e = thresholdBegin[id + 1]; i < e;
+         ++i) {
+      jumpset.add(thresholdIdx[i]);
+    }
+  }
+
+  // Get constants used in intersections generated for sigmas
+  for (unsigned pos = 0, e = compusemap.size(); pos < e; ++pos) {
+    for (BasicOp *op : compusemap.getUses(compusemap.getNode(pos))) {
+      // Symbolic intervals are discarded, as they don't have fixed values yet
+      if (!isa<SigmaOp>(op) || isa<SymbInterval>(op->getIntersect())) {
+        continue;
+      }
+
+      const Range &rintersect = op->getIntersect()->getRange();
+      const APInt &lb = rintersect.getLower();
+      const APInt &ub = rintersect.getUpper();
+
+      if (!lb.isMinSignedValue() && !lb.isMaxSignedValue()) {
+        jumpset.add(getThresholdIndex(lb));
+      }
+      if (!ub.isMinSignedValue() && !ub.isMaxSignedValue()) {
+        jumpset.add(getThresholdIndex(ub));
+      }
+    }
+  }
+
+  jumpset.finish();
+}
+
+// FIXME: do it just for component
+void CropDFS::storeAbstractStates(const SmallPtrSet<VarNode *, 32> &component) {
+  for (VarNode *varNode : component) {
+    varNode->storeAbstractState();
+  }
+}
+
+bool Meet::fixed(BasicOp *op, const JumpSet * /*jumpset*/) {
+  Range oldInterval = op->getSink()->getRange();
+  Range newInterval = op->eval();
+
+  op->getSink()->setRange(newInterval);
+  LOG_TRANSACTION("FIXED::" << op->getSink()->getValue()->getName() << ": "
+                            << oldInterval << " -> " << newInterval)
+  return oldInterval != newInterval;
+}
+
+/// This is the meet operator of the growth analysis. The growth analysis
+/// will change the bounds of each variable, if necessary. Initially, each
+/// variable is bound to either the undefined interval, e.g. [., .], or to
+/// a constant interval, e.g., [3, 15]. After this analysis runs, there will
+/// be no undefined interval. Each variable will be either bound to a
+/// constant interval, or to [-, c], or to [c, +], or to [-, +].
+bool Meet::widen(BasicOp *op, const JumpSet *jumpset) {
+  assert(jumpset != nullptr && "Invalid pointer to jump-set");
+
+  Range oldInterval = op->getSink()->getRange();
+  Range newInterval = op->eval();
+
+  const APInt &oldLower = oldInterval.getLower();
+  const APInt &oldUpper = oldInterval.getUpper();
+  const APInt &newLower = newInterval.getLower();
+  const APInt &newUpper = newInterval.getUpper();
+
+  // Jump-set
+  APInt nlconstant = jumpset->getFirstLess(newLower);
+  APInt nuconstant = jumpset->getFirstGreater(newUpper);
+
+  if (oldInterval.isUnknown()) {
+    op->getSink()->setRange(newInterval);
+  } else {
+    if (newLower.slt(oldLower) && newUpper.sgt(oldUpper)) {
+      op->getSink()->setRange(Range(nlconstant, nuconstant));
+    } else {
+      if (newLower.slt(oldLower)) {
+        op->getSink()->setRange(Range(nlconstant, oldUpper));
+      } else {
+        if (newUpper.sgt(oldUpper)) {
+          op->getSink()->setRange(Range(oldLower, nuconstant));
+        }
+      }
+    }
+  }
+
+  Range sinkInterval = op->getSink()->getRange();
+  LOG_TRANSACTION("WIDEN::" << op->getSink()->getValue()->getName() << ": "
+                            << oldInterval << " -> " << sinkInterval)
+  return oldInterval != sinkInterval;
+}
+
+bool Meet::growth(BasicOp *op, const JumpSet * /*jumpset*/) {
+  Range oldInterval = op->getSink()->getRange();
+  Range newInterval = op->eval();
+
+  if (oldInterval.isUnknown()) {
+    op->getSink()->setRange(newInterval);
+  } else {
+    const APInt &oldLower = oldInterval.getLower();
+    const APInt &oldUpper = oldInterval.getUpper();
+    const APInt &newLower = newInterval.getLower();
+    const APInt &newUpper = newInterval.getUpper();
+    if (newLower.slt(oldLower)) {
+      if (newUpper.sgt(oldUpper)) {
+        op->getSink()->setRange(Range(oldInterval.getBitWidth()));
+      } else {
+        op->getSink()->setRange(Range(
+            APInt::getSignedMinValue(oldInterval.getBitWidth()), oldUpper));
+      }
+    } else if (newUpper.sgt(oldUpper)) {
+      op->getSink()->setRange(Range(
+          oldLower, APInt::getSignedMaxValue(oldInterval.getBitWidth())));
+    }
+  }
+  Range sinkInterval = op->getSink()->getRange();
+  LOG_TRANSACTION("GROWTH::" << op->getSink()->getValue()->getName() << ": "
+                             << oldInterval << " -> " << sinkInterval)
+  return oldInterval != sinkInterval;
+}
+
+/// This is the meet operator of the cropping analysis. Whereas the growth
+/// analysis expands the bounds of each variable, regardless of intersections
+/// in the constraint graph, the cropping analysis shrinks these bounds back
+/// to ranges that respect the intersections.
+bool Meet::narrow(BasicOp *op, const JumpSet * /*jumpset*/) {
+
+  const Range oldInterval = op->getSink()->getRange();
+  APInt oLower = oldInterval.getLower();
+  APInt oUpper = oldInterval.getUpper();
+  Range newInterval = op->eval();
+
+  const APInt &nLower = newInterval.getLower();
+  const APInt &nUpper = newInterval.getUpper();
+
+  bool hasChanged = false;
+
+  if (oldInterval.isLowerMin() && !newInterval.isLowerMin()) {
+    op->getSink()->setRange(Range(nLower, oUpper));
+    hasChanged = true;
+  } else {
+    const APInt &smin = APIntOps::smin(oLower, nLower);
+    if (oLower.ne(smin)) {
+      op->getSink()->setRange(Range(smin, oUpper));
+      hasChanged = true;
+    }
+  }
+
+  if (oldInterval.isUpperMax() && !newInterval.isUpperMax()) {
+    op->getSink()->setRange(
+        Range(op->getSink()->getRange().getLower(), nUpper));
+    hasChanged = true;
+  } else {
+    const APInt &smax = APIntOps::smax(oUpper, nUpper);
+    if (oUpper.ne(smax)) {
+      op->getSink()->setRange(
+          Range(op->getSink()->getRange().getLower(), smax));
+      hasChanged = true;
+    }
+  }
+
+  LOG_TRANSACTION("NARROW::" << op->getSink()->getValue()->getName() << ": "
+                             << Range(oLower, oUpper) << " -> "
+                             << op->getSink()->getRange())
+  return hasChanged;
+}
+
+bool Meet::crop(BasicOp *op, const JumpSet * /*jumpset*/) {
+  Range oldInterval = op->getSink()->getRange();
+  Range newInterval = op->eval();
+
+  bool hasChanged = false;
+  char abstractState = op->getSink()->getAbstractState();
+
+  if ((abstractState == '-' || abstractState == '?') &&
+      newInterval.getLower().sgt(oldInterval.getLower())) {
+    op->getSink()->setRange(
+        Range(newInterval.getLower(), oldInterval.getUpper()));
+    hasChanged = true;
+  }
+
+  if ((abstractState == '+' || abstractState == '?') &&
+      newInterval.getUpper().slt(oldInterval.getUpper())) {
+    op->getSink()->setRange(
+        Range(op->getSink()->getRange().getLower(), newInterval.getUpper()));
+    hasChanged = true;
+  }
+
+  LOG_TRANSACTION("CROP::" << op->getSink()->getValue()->getName() << ": "
+                           << oldInterval << " -> "
+                           << op->getSink()->getRange())
+  return hasChanged;
+}
+
+void Cousot::preUpdate(const ComponentUseMap &compUseMap,
+                       ActiveVars &entryPoints) {
+  updateAtCutPoints(compUseMap, entryPoints, Meet::widen);
+}
+
+void Cousot::posUpdate(const ComponentUseMap &compUseMap,
+                       ActiveVars &entryPoints,
+                       const SmallPtrSet<VarNode *, 32> * /*component*/,
+                       ArrayRef<unsigned> /*componentOps*/) {
+  update(compUseMap, entryPoints, Meet::narrow);
+}
+
+void CropDFS::preUpdate(const ComponentUseMap &compUseMap,
+                        ActiveVars &entryPoints) {
+  updateAtCutPoints(compUseMap, entryPoints, Meet::growth);
+}
+
+void CropDFS::posUpdate(const ComponentUseMap &compUseMap,
+                        ActiveVars & /*entryPoints*/,
+                        const SmallPtrSet<VarNode *, 32> *component,
+                        ArrayRef<unsigned> componentOps) {
+  storeAbstractStates(*component);
+  compUseMap.getWorkspace().cropEpochs.resize(nodes.size());
+  for (unsigned opit : componentOps) {
+    BasicOp *op = ops[opit];
+    // int_op
+    if (isa<UnaryOp>(op) && !op->getSink()->getRange().isMaxRange()) {
+      crop(compUseMap, op);
+    }
+  }
+}
+
+void CropDFS::crop(const ComponentUseMap &compUseMap, BasicOp *op) {
+  ComponentWorkspace &ws = compUseMap.getWorkspace();
+  SmallVectorImpl<unsigned> &cropEpochs = ws.cropEpochs;
+  SmallVectorImpl<BasicOp *> &cropWorklist = ws.cropWorklist;
+  unsigned &cropEpoch = ws.cropEpoch;
+
+  // Start a new epoch, so that no node is marked as visited
+  if (++cropEpoch == 0) {
+    std::fill(cropEpochs.begin(), cropEpochs.end(), 0);
+    cropEpoch = 1;
+  }
+
+  // init the worklist only with the op received
+  cropWorklist.clear();
+  cropWorklist.push_back(op);
+
+  for (unsigned next = 0; next < cropWorklist.size(); ++next) {
+    BasicOp *V = cropWorklist[next];
+    const VarNode *sink = V->getSink();
+
+    // if the sink has been visited go to the next operation
+    if (cropEpochs[sink->getId()] == cropEpoch) {
+      continue;
+    }
+
+    Meet::crop(V, nullptr);
+    cropEpochs[sink->getId()] = cropEpoch;
+
+    // The use list.of sink
+    for (BasicOp *use : compUseMap.getUses(sink)) {
+      if (cropEpochs[use->getSink()->getId()] != cropEpoch) {
+        cropWorklist.push_back(use);
+      }
+    }
+  }
+}
+
+void ConstraintGraph::update(
+    const ComponentUseMap &compUseMap, ActiveVars &actv,
+    bool (*meet)(BasicOp *op, const JumpSet *jumpset)) {
+  if (ctx.numThreads > 1 && ctx.parallelSCCSize != 0 &&
+      compUseMap.size() >= ctx.parallelSCCSize) {
+    updateInParallel(compUseMap, actv, meet, false);
+    return;
+  }
+
+  while (!actv.empty()) {
+    VarNode *V = actv.pop();
+
+#ifdef STATS
+    // Counts the visits of the narrowing
+    if (meet == Meet::narrow) {
+      ++narrowVisits[V->getId()];
+    }
+#endif
+
+    // The use list.
+    for (BasicOp *op : compUseMap.getUses(V)) {
+      if (meet(op, compUseMap.getJumpSet())) {
+        actv.insert(op->getSink());
+      }
+    }
+  }
+}
+
+/// Like update, but meet is only applied to the operations whose sink is a
+/// cut point of the component. The other sinks simply take the value of their
+/// operation, since every cycle already goes through a cut point.
+void ConstraintGraph::updateAtCutPoints(
+    const ComponentUseMap &compUseMap, ActiveVars &actv,
+    bool (*meet)(BasicOp *op, const JumpSet *jumpset)) {
+  if (ctx.numThreads > 1 && ctx.parallelSCCSize != 0 &&
+      compUseMap.size() >= ctx.parallelSCCSize) {
+    updateInParallel(compUseMap, actv, meet, true);
+    return;
+  }
+
+  while (!actv.empty()) {
+    VarNode *V = actv.pop();
+
+    // The use list.
+    for (BasicOp *op : compUseMap.getUses(V)) {
+      const bool changed = compUseMap.isCutPoint(op->getSink())
+                               ? meet(op, compUseMap.getJumpSet())
+                               : Meet::fixed(op, nullptr);
+      if (changed) {
+        actv.insert(op->getSink());
+      }
+    }
+  }
+}
+
+/*
+ *	The positions of the component are split in blocks of consecutive
+ *  positions, one for each thread. A thread evaluates the operations whose
+ *  sink is in its block, so every node has a single writer, and the others
+ *  only read it through the shared bounds table. When the range of a node
+ *  changes, the sinks of its uses are sent to the threads owning them. The
+ *  threads stop once no node waits to be evaluated anywhere. The order of the
+ *  evaluations depends on the timing of the threads, but every sink is
+ *  evaluated after each change of its sources, so the result is a fixed
+ *  point of the same meet operators.
+ */
+void ConstraintGraph::updateInParallel(
+    const ComponentUseMap &compUseMap, ActiveVars &actv,
+    bool (*meet)(BasicOp *op, const JumpSet *jumpset), bool atCutPoints) {
+  const unsigned size = compUseMap.size();
+  const unsigned numBlocks = std::min<unsigned>(ctx.numThreads, size);
+  const unsigned blockSize = (size + numBlocks - 1) / numBlocks;
+
+  // The operations of the component by the position of their sink
+  SmallVector<std::pair<unsigned, BasicOp *>, 0> sinkOps;
+  for (unsigned pos = 0; pos < size; ++pos) {
+    for (BasicOp *op : compUseMap.getUses(compUseMap.getNode(pos))) {
+      sinkOps.push_back(
+          std::make_pair(compUseMap.getPosition(op->getSink()), op));
+    }
+  }
+  std::sort(sinkOps.begin(), sinkOps.end(),
+            [](const std::pair<unsigned, BasicOp *> &A,
+               const std::pair<unsigned, BasicOp *> &B) {
+              return A.first != B.first ? A.first < B.first
+                                        : A.second->getId() < B.second->getId();
+            });
+  sinkOps.erase(std::unique(sinkOps.begin(), sinkOps.end()), sinkOps.end());
+  SmallVector<unsigned, 0> sinkBegin(size + 1, 0);
+  for (const std::pair<unsigned, BasicOp *> &sinkOp : sinkOps) {
+    ++sinkBegin[sinkOp.first + 1];
+  }
+  for (unsigned pos = 0; pos < size; ++pos) {
+    sinkBegin[pos + 1] += sinkBegin[pos];
+  }
+
+  struct Block {
+    // The positions sent by the other threads, protected by lock
+    std::mutex lock;
+    SmallVector<unsigned, 0> inbox;
+    // The positions waiting to be evaluated, as a min-heap
+    SmallVector<unsigned, 0> heap;
+    BitVector inHeap;
+  };
+  std::vector<Block> blocks(numBlocks);
+  // The positions sent and not evaluated yet, by all the threads
+  std::atomic<unsigned> pending(0);
+
+  auto send = [&](unsigned pos) {
+    Block &block = blocks[pos / blockSize];
+    pending.fetch_add(1);
+    std::lock_guard<std::mutex> guard(block.lock);
+    block.inbox.push_back(pos);
+  };
+
+  // The uses of the entry points are the first to be evaluated
+  for (Block &block : blocks) {
+    block.inHeap.resize(blockSize);
+  }
+  while (!actv.empty()) {
+    for (BasicOp *op : compUseMap.getUses(actv.pop())) {
+      send(compUseMap.getPosition(op->getSink()));
+    }
+  }
+
+  auto work = [&](unsigned b) {
+    Block &block = blocks[b];
+    const unsigned first = b * blockSize;
+    SmallVector<unsigned, 0> received;
+
+    for (;;) {
+      {
+        std::lock_guard<std::mutex> guard(block.lock);
+        received.swap(block.inbox);
+      }
+      for (unsigned pos : received) {
+        if (block.inHeap[pos - first]) {
+          pending.fetch_sub(1);
+        } else {
+          block.inHeap.set(pos - first);
+          block.heap.push_back(pos);
+          std::push_heap(block.heap.begin(), block.heap.end(),
+                         std::greater<unsigned>());
+        }
+      }
+      received.clear();
+
+      if (block.heap.empty()) {
+        if (pending.load() == 0) {
+          return;
+        }
+        std::this_thread::yield();
+        continue;
+      }
+
+      std::pop_heap(block.heap.begin(), block.heap.end(),
+                    std::greater<unsigned>());
+      const unsigned pos = block.heap.pop_back_val();
+      block.inHeap.reset(pos - first);
+      VarNode *V = compUseMap.getNode(pos);
+
+#ifdef STATS
+      // Counts the visits of the narrowing
+      if (meet == Meet::narrow) {
+        ++narrowVisits[V->getId()];
+      }
+#endif
+
+      bool changed = false;
+      for (unsigned i = sinkBegin[pos], e = sinkBegin[pos + 1]; i < e; ++i) {
+        BasicOp *op = sinkOps[i].second;
+        changed |= (!atCutPoints || compUseMap.isCutPoint(V))
+                       ? meet(op, compUseMap.getJumpSet())
+                       : Meet::fixed(op, nullptr);
+      }
+      if (changed) {
+        for (BasicOp *op : compUseMap.getUses(V)) {
+          send(compUseMap.getPosition(op->getSink()));
+        }
+      }
+      pending.fetch_sub(1);
+    }
+  };
+
+  std::vector<std::thread> threads;
+  threads.reserve(numBlocks - 1);
+  for (unsigned b = 1; b < numBlocks; ++b) {
+    threads.emplace_back(work, b);
+  }
+  work(0);
+  for (std::thread &thread : threads) {
+    thread.join();
+  }
+}
+
+void ConstraintGraph::update(unsigned nIterations,
+                             const ComponentUseMap &compUseMap,
+                             ActiveVars &actv) {
+  while (!actv.empty()) {
+    VarNode *V = actv.pop();
+    // The use list.
+    for (BasicOp *op : compUseMap.getUses(V)) {
+      if (nIterations == 0) {
+        actv.clear();
+        return;
+      }
+      --nIterations;
+
+      if (Meet::fixed(op, nullptr)) {
+        actv.insert(op->getSink());
+      }
+    }
+  }
+}
+
+void ConstraintGraph::solve() {
+#ifdef STATS
+  Timer *timer = ctx.prof.registerNewTimer(
+      "Nuutila", "Nuutila's algorithm for strongly connected components");
+  timer->startTimer();
+#endif
+  // List of SCCs
+  Nuutila sccList(*this);
+  if (ctx.relayout) {
+    relayout(sccList);
+  }
+#ifdef STATS
+  timer->stopTimer();
+  ctx.prof.addTimeRecord(timer);
+// delete timer;
+#endif
+  // STATS
+  ctx.stats.numSCCs += sccList.size();
+  for (unsigned c = 0, e = sccList.size(); c < e; ++c) {
+    const uint64_t size = sccList.getComponent(c).size();
+    if (size == 1) {
+      ++ctx.stats.numAloneSCCs;
+    } else {
+      ctx.stats.sizeMaxSCC = std::max(ctx.stats.sizeMaxSCC, size);
+    }
+  }
+#ifdef SCC_DEBUG
+  unsigned numberOfSCCs = sccList.size();
+#endif
+
+// For each SCC in graph, do the following
+#ifdef STATS
+  timer =
+      ctx.prof.registerNewTimer("ConstraintSolving", "Constraint solving");
+  timer->startTimer();
+#endif
+
+#ifdef STATS
+  narrowVisits.assign(nodes.size(), 0);
+#endif
+
+  if (ctx.numThreads <= 1) {
+    ComponentWorkspace &ws = getWorkspace(0);
+    for (unsigned c = 0, e = sccList.size(); c < e; ++c) {
+      solveComponent(sccList, c, ws);
+#ifdef SCC_DEBUG
+      --numberOfSCCs;
+#endif
+    }
+  } else {
+    // Threads solving a component together share the ranges of its nodes
+    bool shareBounds = false;
+    for (unsigned c = 0, e = sccList.size(); c < e; ++c) {
+      shareBounds |= ctx.parallelSCCSize != 0 &&
+                     sccList.getComponent(c).size() >= ctx.parallelSCCSize;
+    }
+    bounds.setShared(shareBounds);
+#ifdef SCC_DEBUG
+    numberOfSCCs -=
+#endif
+        solveComponentsInParallel(sccList, ctx.numThreads);
+    bounds.setShared(false);
+  }
+
+#ifdef STATS
+  for (VarNode *node : nodes) {
+    if (narrowVisits[node->getId()] != 0) {
+      ctx.FerMap[node->getValue()] += narrowVisits[node->getId()];
+    }
+  }
+#endif
+
+#ifdef STATS
+  timer->stopTimer();
+  ctx.prof.addTimeRecord(timer);
+#endif
+
+#ifdef SCC_DEBUG
+  ASSERT(numberOfSCCs == 0, "Not all SCCs have been visited")
+#endif
+}
+
+/*
+ *	Solves one component: its nodes are bound to intervals through widening
+ *  and narrowing, or growth and crop, and then the operations where they are
+ *  used are evaluated once, so that the next components have entry points.
+ */
+void ConstraintGraph::solveComponent(const Nuutila &sccList, unsigned scc,
+                                     ComponentWorkspace &ws) {
+  ArrayRef<unsigned> members = sccList.getComponent(scc);
+  if (members.size() == 1) {
+    solveSingleton(members[0]);
+    return;
+  }
+
+  SmallPtrSet<VarNode *, 32> &component = ws.component;
+  component.clear();
+  for (unsigned id : members) {
+    component.insert(nodes[id]);
+  }
+
+
+  ComponentUseMap compUseMap = buildUseMap(sccList, scc, ws);
+
+  // Get the entry points of the SCC
+  ActiveVars entryPoints(compUseMap);
+
+#ifdef JUMPSET
+  // Create vector of constants inside component
+  // Comment this line below to deactivate jump-set
+  buildConstantVector(component, compUseMap);
+#endif
+
+// generateEntryPoints(component, entryPoints);
+// iterate a fixed number of time before widening
+// update(component.size()*2 /*| NUMBER_FIXED_ITERATIONS*/, compUseMap,
+// entryPoints);
+
+#ifdef PRINT_DEBUG
+  if (stepPrinter != nullptr && ctx.numThreads <= 1) {
+    stepPrinter(*this, "cgfixed");
+  }
+#endif
+
+  generateEntryPoints(members, entryPoints);
+  // First iterate till fix point
+  preUpdate(compUseMap, entryPoints);
+  fixIntersects(component);
+
+  // FIXME: Ensure that this code is really needed
+  for (VarNode *varNode : component) {
+    if (varNode->getRange().isUnknown()) {
+      varNode->setRange(Range(varNode->getBitWidth()));
+    }
+  }
+
+// printResultIntervals();
+#ifdef PRINT_DEBUG
+  if (stepPrinter != nullptr && ctx.numThreads <= 1) {
+    stepPrinter(*this, "cgint");
+  }
+#endif
+
+  // Second iterate till fix point
+  ActiveVars activeVars(compUseMap);
+  generateActivesVars(component, activeVars);
+  posUpdate(compUseMap, activeVars, &component,
+            sccList.getComponentOps(scc));
+  propagateToNextSCC(members);
+}
+
+/*
+ *	Solves a component made of node id alone. Most components are, so they
+ *  go straight through the lists of the node, without the set and the use
+ *  map of the larger ones. As in generateEntryPoints, a sigma evaluated
+ *  before the bound of its interval was known is evaluated again, so its
+ *  range does not depend on which of its source and its bound came first.
+ */
+void ConstraintGraph::solveSingleton(unsigned id) {
+  VarNode *var = nodes[id];
+  for (unsigned op : getSymbUses(id)) {
+    ops[op]->fixIntersects(var);
+  }
+  if (defOp[id] != NoOp) {
+    SigmaOp *sigmaop = dyn_cast<SigmaOp>(ops[defOp[id]]);
+    if ((sigmaop != nullptr) && sigmaop->isUnresolved()) {
+      var->setRange(sigmaop->eval());
+      sigmaop->markResolved();
+    }
+  }
+  if (var->getRange().isUnknown()) {
+    var->setRange(Range(var->getBitWidth()));
+  }
+  propagateToNextSCC(id);
+}
+
+/*
+ *	Solves the components of sccList with numThreads threads. A component is
+ *  solved once the components it waits for in their ComponentDAG are, so the
+ *  ranges are the same as when they are solved one after the other. Among the
+ *  components ready to be solved, the one with the lowest number goes first.
+ *  Returns the number of components solved.
+ */
+unsigned ConstraintGraph::solveComponentsInParallel(const Nuutila &sccList,
+                                                    unsigned numThreads) {
+  const unsigned numComponents = sccList.size();
+  numThreads = std::min(numThreads, std::max(numComponents, 1U));
+  ComponentDAG dag(*this, sccList);
+
+  // Workspaces are created before the threads start
+  for (unsigned i = 0; i < numThreads; ++i) {
+    getWorkspace(i);
+  }
+
+  // The following are protected by lock
+  std::mutex lock;
+  std::condition_variable wakeUp;
+  // The number of components each component still waits for
+  SmallVector<unsigned, 0> waiting(numComponents);
+  // The components ready to be solved, as a min-heap
+  SmallVector<unsigned, 0> ready;
+  unsigned numSolved = 0;
+
+  for (unsigned c = 0; c < numComponents; ++c) {
+    waiting[c] = dag.getNumPredecessors(c);
+    if (waiting[c] == 0) {
+      ready.push_back(c);
+    }
+  }
+  std::make_heap(ready.begin(), ready.end(), std::greater<unsigned>());
+
+  auto work = [&](ComponentWorkspace &ws) {
+    std::unique_lock<std::mutex> guard(lock);
+    while (numSolved < numComponents) {
+      if (ready.empty()) {
+        wakeUp.wait(guard);
+        continue;
+      }
+
+      std::pop_heap(ready.begin(), ready.end(), std::greater<unsigned>());
+      const unsigned c = ready.pop_back_val();
+      guard.unlock();
+      solveComponent(sccList, c, ws);
+      guard.lock();
+
+      ++numSolved;
+      for (unsigned succ : dag.getSuccessors(c)) {
+        if (--waiting[succ] == 0) {
+          ready.push_back(succ);
+          std::push_heap(ready.begin(), ready.end(), std::greater<unsigned>());
+          wakeUp.notify_one();
+        }
+      }
+      if (numSolved == numComponents) {
+        wakeUp.notify_all();
+      }
+    }
+  };
+
+  std::vector<std::thread> threads;
+  threads.reserve(numThreads - 1);
+  for (unsigned i = 1; i < numThreads; ++i) {
+    threads.emplace_back(work, std::ref(*workspaces[i]));
+  }
+  work(*workspaces[0]);
+  for (std::thread &thread : threads) {
+    thread.join();
+  }
+
+  return numSolved;
+}
+
+ComponentWorkspace &ConstraintGraph::getWorkspace(unsigned i) {
+  while (workspaces.size() <= i) {
+    workspaces.push_back(std::make_unique<ComponentWorkspace>(&thresholds));
+  }
+  return *workspaces[i];
+}
+
+void ConstraintGraph::generateEntryPoints(ArrayRef<unsigned> component,
+                                          ActiveVars &entryPoints) {
+  // Iterate over the varnodes in the component
+  for (unsigned id : component) {
+    VarNode *varNode = nodes[id];
+    // Only sigmas are defined by a SigmaOp
+    const unsigned def = defOp[varNode->getId()];
+
+    if (def != NoOp) {
+      BasicOp *bop = ops[def];
+      SigmaOp *defop = dyn_cast<SigmaOp>(bop);
+
+      if ((defop != nullptr) && defop->isUnresolved()) {
+
+        defop->getSink()->setRange(bop->eval());
+        defop->markResolved();
+      }
+    }
+
+    if (!varNode->getRange().isUnknown()) {
+      entryPoints.insert(varNode);
+    }
+  }
+}
+
+void ConstraintGraph::fixIntersects(SmallPtrSet<VarNode *, 32> &component) {
+  // Iterate again over the varnodes in the component
+  for (VarNode *varNode : component) {
+    for (unsigned op : getSymbUses(varNode->getId())) {
+      ops[op]->fixIntersects(varNode);
+    }
+  }
+}
+
+void ConstraintGraph::generateActivesVars(
+    SmallPtrSet<VarNode *, 32> &component, ActiveVars &activeVars) {
+
+  for (VarNode *varNode : component) {
+    if (varNode->isConstant()) {
+      continue;
+    }
+
+    activeVars.insert(varNode);
+  }
+}
+
+/// Releases the nodes and operations of the graph. Nothing in the arena
+/// owns heap memory beyond what its destructor frees, so the arena itself
+/// is only rewound.
+void ConstraintGraph::clear() {
+  for (BasicInterval *itv : arenaIntervals) {
+    itv->~BasicInterval();
+  }
+  for (VarNode *node : nodes) {
+    node->~VarNode();
+  }
+  arenaIntervals.clear();
+
+  vars.clear();
+  oprs.clear();
+  defMap.clear();
+  useMap.clear();
+  valuesBranchMap.clear();
+  valuesSwitchMap.clear();
+  pendingSigmas.clear();
+  thresholds.clear();
+  thresholdBegin.clear();
+  thresholdIdx.clear();
+
+  nodes.clear();
+  ops.clear();
+  defOp.clear();
+  useBegin.clear();
+  useOps.clear();
+  symbBegin.clear();
+  symbOps.clear();
+  compPosition.clear();
+#ifdef STATS
+  narrowVisits.clear();
+#endif
+  bounds.clear();
+
+  func = nullptr;
+  stepPrinter = nullptr;
+  addedBounds.clear();
+  name.clear();
+  arena.Reset();
+  adoptedArenas.clear();
+}
+
+/*
+ *	This method builds a map that binds each variable to the operation in
+ *  which this variable is defined.
+ */
+
+// DefMap ConstraintGraph::buildDefMap(const SmallPtrSet<VarNode*, 32>
+// &component)
+//{
+//	std::deque<BasicOp*> list;
+//	for (GenOprs::iterator opit = oprs.begin(), opend = oprs.end(); opit !=
+// opend; ++opit) {
+//		BasicOp *op = *opit;
+//
+//		if (std::find(component.begin(), component.end(), op->getSink())
+//!= component.end()) {
+//			list.push_back(op);
+//		}
+//	}
+//
+//	DefMap defMap;
+//
+//	for (std::deque<BasicOp*>::iterator opit = list.begin(), opend =
+// list.end(); opit != opend; ++opit) {
+//		BasicOp *op = *opit;
+//		defMap[op->getSink()] = op;
+//	}
+//
+//	return defMap;
+//}
+
+/*
+ *	Returns the use lists of the component scc of sccList, restricted to the
+ *  operations whose sink is in the component. The nodes of the component are
+ *  ordered by a depth first search, and the targets of its back edges are
+ *  marked as cut points.
+ */
+ComponentUseMap ConstraintGraph::buildUseMap(const Nuutila &sccList,
+                                             unsigned scc,
+                                             ComponentWorkspace &ws) {
+  ArrayRef<unsigned> sccIds = sccList.getComponentIds();
+  const unsigned Unvisited = ~0U;
+  const unsigned OnStack = ~1U;
+
+  // The depth first search starts from the nodes which already have a range,
+  // that is, the ones reached from the previous components. Ids keep the
+  // order independent from the addresses of the nodes.
+  ArrayRef<unsigned> members = sccList.getComponent(scc);
+  ws.roots.assign(members.begin(), members.end());
+  std::sort(ws.roots.begin(), ws.roots.end());
+  std::stable_partition(ws.roots.begin(), ws.roots.end(),
+                        [this](unsigned id) {
+                          return !nodes[id]->getRange().isUnknown();
+                        });
+  for (unsigned id : ws.roots) {
+    compPosition[id] = Unvisited;
+  }
+
+  // Positions are given in postorder first, and reversed at the end.
+  ws.nodes.clear();
+  ws.backEdgeTargets.clear();
+  for (unsigned root : ws.roots) {
+    if (compPosition[root] != Unvisited) {
+      continue;
+    }
+    compPosition[root] = OnStack;
+    ws.frames.push_back(std::make_pair(nodes[root], 0));
+
+    while (!ws.frames.empty()) {
+      VarNode *var = ws.frames.back().first;
+      ArrayRef<unsigned> uses = getUses(var->getId());
+      unsigned &edge = ws.frames.back().second;
+
+      // Follow the next use of var whose sink is in the component
+      if (edge < uses.size()) {
+        VarNode *sink = ops[uses[edge++]]->getSink();
+        if (sccIds[sink->getId()] != scc) {
+          continue;
+        }
+        if (compPosition[sink->getId()] == Unvisited) {
+          compPosition[sink->getId()] = OnStack;
+          ws.frames.push_back(std::make_pair(sink, 0));
+        } else if (compPosition[sink->getId()] == OnStack) {
+          // A back edge
+          ws.backEdgeTargets.push_back(sink);
+        }
+        continue;
+      }
+
+      ws.frames.pop_back();
+      compPosition[var->getId()] = 0;
+      ws.nodes.push_back(var);
+    }
+  }
+
+  std::reverse(ws.nodes.begin(), ws.nodes.end());
+  const unsigned size = ws.nodes.size();
+  for (unsigned i = 0; i < size; ++i) {
+    compPosition[ws.nodes[i]->getId()] = i;
+  }
+
+  ws.cutPoints.clear();
+  ws.cutPoints.resize(size);
+  for (VarNode *var : ws.backEdgeTargets) {
+    ws.cutPoints.set(compPosition[var->getId()]);
+  }
+
+  return ComponentUseMap(ops, useBegin, useOps, sccIds, scc, compPosition,
+                         &ws);
+}
+
+/*
+ *	Shrinks the graph before it is finalized. A node is fixed when no
+ *  operation defines it and its range is known. The solver never changes
+ *  the range of such a node, so an operation whose sources are all fixed is
+ *  evaluated here once and dropped, and its sink becomes fixed in turn. An
+ *  operation which copies its source, that is, a phi with a single source, a
+ *  sigma with the full interval or a unary operation which keeps the width,
+ *  is dropped too: its sink becomes an alias of the source, which takes its
+ *  uses, and the map of variables sends the value of the sink to the node of
+ *  the source, so getRange still answers for it. Nodes defined by several
+ *  operations are left alone, and so are the symbolic intervals and the
+ *  nodes which bound them.
+ */
+void ConstraintGraph::simplify() {
+  const unsigned numNodes = nodes.size();
+  const unsigned NoNode = ~0U;
+
+  // The number of operations which define each node, and the nodes which
+  // bound symbolic intervals
+  SmallVector<unsigned, 0> writers(numNodes, 0);
+  BitVector isBound(numNodes);
+  for (BasicOp *op : oprs) {
+    ++writers[op->getSink()->getId()];
+    if (SymbInterval *SI = dyn_cast<SymbInterval>(op->getIntersect())) {
+      VarNodes::iterator vit = vars.find(SI->getBound());
+      if (vit != vars.end()) {
+        isBound.set(vit->second->getId());
+      }
+    }
+  }
+
+  auto isFixed = [&](const VarNode *node) {
+    return writers[node->getId()] == 0 && !node->getRange().isUnknown();
+  };
+  // The node copied by op, or NoNode
+  auto getCopiedNode = [&](const BasicOp *op) {
+    bool copies = false;
+    if (isa<PhiOp>(op)) {
+      copies = op->getNumSources() == 1;
+    } else if (const UnaryOp *UO = dyn_cast<UnaryOp>(op)) {
+      const unsigned opcode = UO->getOpcode();
+      copies = UO->getIntersect()->getRange().isMaxRange() &&
+               UO->getSource()->getBitWidth() == UO->getSink()->getBitWidth() &&
+               (isa<SigmaOp>(UO) || (opcode != Instruction::Trunc &&
+                                     opcode != Instruction::ZExt &&
+                                     opcode != Instruction::SExt));
+    }
+    return copies ? op->getSourceAt(0)->getId() : NoNode;
+  };
+  auto removeOp = [&](BasicOp *op) {
+    for (unsigned i = 0, e = op->getNumSources(); i < e; ++i) {
+      useMap.find(op->getSourceAt(i)->getValue())->second.erase(op);
+    }
+    defMap.erase(op->getSink()->getValue());
+    oprs.erase(op);
+    --writers[op->getSink()->getId()];
+  };
+
+  // The nodes whose definition may be simplified, the first ones on top
+  SmallVector<unsigned, 0> worklist;
+  worklist.reserve(numNodes);
+  for (unsigned id = numNodes; id-- > 0;) {
+    worklist.push_back(id);
+  }
+  auto pushUses = [&](const VarNode *node) {
+    for (BasicOp *use : useMap.find(node->getValue())->second) {
+      worklist.push_back(use->getSink()->getId());
+    }
+  };
+
+  // The node each removed node is an alias of
+  SmallVector<VarNode *, 0> aliasOf(numNodes, nullptr);
+  while (!worklist.empty()) {
+    const unsigned id = worklist.pop_back_val();
+    VarNode *sink = nodes[id];
+    if (aliasOf[id] != nullptr || writers[id] != 1) {
+      continue;
+    }
+    DefMap::iterator dit = defMap.find(sink->getValue());
+    if (dit == defMap.end() || isa<SymbInterval>(dit->second->getIntersect())) {
+      continue;
+    }
+    BasicOp *op = dit->second;
+
+    const unsigned copied = getCopiedNode(op);
+    if (copied != NoNode && copied != id && !isBound[id]) {
+      VarNode *source = nodes[copied];
+      removeOp(op);
+      SmallPtrSet<BasicOp *, 8> &sinkUses =
+          useMap.find(sink->getValue())->second;
+      SmallPtrSet<BasicOp *, 8> &sourceUses =
+          useMap.find(source->getValue())->second;
+      // The uses taken by the source may be folded now
+      const bool fixedSource = isFixed(source);
+      for (BasicOp *use : sinkUses) {
+        use->replaceSource(sink, source);
+        sourceUses.insert(use);
+        if (fixedSource) {
+          worklist.push_back(use->getSink()->getId());
+        }
+      }
+      sinkUses.clear();
+      vars[sink->getValue()] = source;
+      aliasOf[id] = source;
+      ++ctx.stats.numAliases;
+      continue;
+    }
+
+    bool fixedSources = true;
+    for (unsigned i = 0, e = op->getNumSources(); i < e; ++i) {
+      fixedSources &= isFixed(op->getSourceAt(i));
+    }
+    if (fixedSources) {
+      sink->setRange(op->eval());
+      removeOp(op);
+      ++ctx.stats.numFoldedOps;
+      if (isFixed(sink)) {
+        pushUses(sink);
+      }
+    }
+  }
+
+  // A node may have become the alias of a node removed later
+  for (auto &pair : vars) {
+    while (aliasOf[pair.second->getId()] != nullptr) {
+      pair.second = aliasOf[pair.second->getId()];
+    }
+  }
+
+  // Number the nodes left densely, keeping their order
+  SmallVector<unsigned, 0> order;
+  SmallVector<VarNode *, 0> newNodes;
+  for (unsigned id = 0; id < numNodes; ++id) {
+    if (aliasOf[id] != nullptr) {
+      nodes[id]->~VarNode();
+      continue;
+    }
+    order.push_back(id);
+    newNodes.push_back(nodes[id]);
+  }
+  if (order.size() == numNodes) {
+    return;
+  }
+  for (unsigned id = 0, e = newNodes.size(); id < e; ++id) {
+    newNodes[id]->setId(id);
+  }
+  bounds.permute(order);
+  nodes.swap(newNodes);
+}
+
+/*
+ *	Builds the finalized form of the graph out of the maps filled during its
+ *  construction. Operations are numbered after the nodes they define, so the
+ *  numbering does not depend on where the operations were allocated.
+ */
+void ConstraintGraph::finalize() {
+  const unsigned numNodes = nodes.size();
+
+  for (BasicOp *op : oprs) {
+    op->setId(NoOp);
+  }
+
+  ops.clear();
+  ops.reserve(oprs.size());
+  defOp.assign(numNodes, NoOp);
+  for (VarNode *node : nodes) {
+    DefMap::iterator dit = defMap.find(node->getValue());
+    if (dit != defMap.end() && dit->second->getId() == NoOp) {
+      defOp[node->getId()] = ops.size();
+      dit->second->setId(ops.size());
+      ops.push_back(dit->second);
+    }
+  }
+  // Operations whose definition was replaced in the def map are still in the
+  // use lists
+  for (BasicOp *op : oprs) {
+    if (op->getId() == NoOp) {
+      op->setId(ops.size());
+      ops.push_back(op);
+    }
+  }
+
+  // Use lists
+  useBegin.resize(numNodes + 1);
+  useOps.clear();
+  for (VarNode *node : nodes) {
+    const unsigned first = useOps.size();
+    useBegin[node->getId()] = first;
+    for (BasicOp *op : useMap.find(node->getValue())->second) {
+      useOps.push_back(op->getId());
+    }
+    std::sort(useOps.begin() + first, useOps.end());
+  }
+  useBegin[numNodes] = useOps.size();
+
+  // Lists of operations bounded by each node
+  SmallVector<unsigned, 0> symbBound(ops.size(), NoOp);
+  symbBegin.assign(numNodes + 1, 0);
+  for (BasicOp *op : ops) {
+    SymbInterval *SI = dyn_cast<SymbInterval>(op->getIntersect());
+    if (SI == nullptr || !isa<UnaryOp>(op)) {
+      continue;
+    }
+
+    VarNodes::iterator vit = vars.find(SI->getBound());
+    if (vit != vars.end()) {
+      symbBound[op->getId()] = vit->second->getId();
+      ++symbBegin[vit->second->getId() + 1];
+    }
+  }
+  for (unsigned i = 0; i < numNodes; ++i) {
+    symbBegin[i + 1] += symbBegin[i];
+  }
+  symbOps.resize(symbBegin[numNodes]);
+  SmallVector<unsigned, 0> next(symbBegin.begin(), symbBegin.end() - 1);
+  for (unsigned op = 0, e = ops.size(); op < e; ++op) {
+    if (symbBound[op] != NoOp) {
+      symbOps[next[symbBound[op]]++] = op;
+    }
+  }
+
+  compPosition.resize(numNodes);
+
+  buildThresholds();
+}
+
+/*
+ *	Numbers the nodes and the operations one component of sccList after the
+ *  other, and moves their ranges and lists to the new ids. Solving a
+ *  component then reads a slice of each array, and the propagation to the
+ *  next components goes forward. Inside a component, ids keep their relative
+ *  order, and each list keeps its order, so the ranges found do not change.
+ *  The nodes and operations themselves stay in the arena, where the maps of
+ *  the graph point to them.
+ */
+void ConstraintGraph::relayout(Nuutila &sccList) {
+  const unsigned numNodes = nodes.size();
+  const unsigned numOps = ops.size();
+
+  // The old id of each new node and operation, and the other way around
+  SmallVector<unsigned, 0> nodeOrder;
+  SmallVector<unsigned, 0> opOrder;
+  nodeOrder.reserve(numNodes);
+  opOrder.reserve(numOps);
+  for (unsigned c = 0, e = sccList.size(); c < e; ++c) {
+    ArrayRef<unsigned> members = sccList.getComponent(c);
+    ArrayRef<unsigned> componentOps = sccList.getComponentOps(c);
+    const unsigned first = nodeOrder.size();
+    nodeOrder.append(members.begin(), members.end());
+    std::sort(nodeOrder.begin() + first, nodeOrder.end());
+    opOrder.append(componentOps.begin(), componentOps.end());
+  }
+  SmallVector<unsigned, 0> newNode(numNodes);
+  for (unsigned id = 0; id < numNodes; ++id) {
+    newNode[nodeOrder[id]] = id;
+  }
+  SmallVector<unsigned, 0> newOp(numOps);
+  for (unsigned op = 0; op < numOps; ++op) {
+    newOp[opOrder[op]] = op;
+  }
+
+  SmallVector<VarNode *, 0> newNodes(numNodes);
+  SmallVector<unsigned, 0> newDefOp(numNodes);
+  SmallVector<unsigned, 0> newUseBegin(numNodes + 1);
+  SmallVector<unsigned, 0> newUseOps;
+  SmallVector<unsigned, 0> newSymbBegin(numNodes + 1);
+  SmallVector<unsigned, 0> newSymbOps;
+  SmallVector<unsigned, 0> newThresholdBegin(numNodes + 1);
+  SmallVector<unsigned, 0> newThresholdIdx;
+  newUseOps.reserve(useOps.size());
+  newSymbOps.reserve(symbOps.size());
+  newThresholdIdx.reserve(thresholdIdx.size());
+  for (unsigned id = 0; id < numNodes; ++id) {
+    const unsigned old = nodeOrder[id];
+    newNodes[id] = nodes[old];
+    newDefOp[id] = defOp[old] == NoOp ? NoOp : newOp[defOp[old]];
+    newUseBegin[id] = newUseOps.size();
+    for (unsigned op : getUses(old)) {
+      newUseOps.push_back(newOp[op]);
+    }
+    newSymbBegin[id] = newSymbOps.size();
+    for (unsigned op : getSymbUses(old)) {
+      newSymbOps.push_back(newOp[op]);
+    }
+    newThresholdBegin[id] = newThresholdIdx.size();
+    newThresholdIdx.append(thresholdIdx.begin() + thresholdBegin[old],
+                           thresholdIdx.begin() + thresholdBegin[old + 1]);
+  }
+  newUseBegin[numNodes] = newUseOps.size();
+  newSymbBegin[numNodes] = newSymbOps.size();
+  newThresholdBegin[numNodes] = newThresholdIdx.size();
+
+  for (unsigned id = 0; id < numNodes; ++id) {
+    newNodes[id]->setId(id);
+  }
+  bounds.permute(nodeOrder);
+
+  SmallVector<BasicOp *, 0> newOps(numOps);
+  for (unsigned op = 0; op < numOps; ++op) {
+    newOps[op] = ops[opOrder[op]];
+    newOps[op]->setId(op);
+  }
+
+  nodes.swap(newNodes);
+  ops.swap(newOps);
+  defOp.swap(newDefOp);
+  useBegin.swap(newUseBegin);
+  useOps.swap(newUseOps);
+  symbBegin.swap(newSymbBegin);
+  symbOps.swap(newSymbOps);
+  thresholdBegin.swap(newThresholdBegin);
+  thresholdIdx.swap(newThresholdIdx);
+
+  sccList.renumber(newNode);
+}
+
+namespace {
+/// Returns the record of R, whose bounds are added to words.
+GraphFile::RangeRecord makeRangeRecord(const Range &R,
+                                       SmallVectorImpl<uint64_t> &words) {
+  GraphFile::RangeRecord RR;
+  RR.bitwidth = R.getBitWidth();
+  RR.type = R.isUnknown() ? Unknown : (R.isEmpty() ? Empty : Regular);
+  RR.words = words.size();
+  for (const APInt &bound : {R.getLower(), R.getUpper()}) {
+    words.append(bound.getRawData(), bound.getRawData() + bound.getNumWords());
+  }
+  return RR;
+}
+
+/// Writes size bytes from data to OS, and then zeros up to a multiple of 8
+/// bytes.
+void writeSection(raw_ostream &OS, const void *data, uint64_t size) {
+  static const char padding[8] = {};
+  OS.write(static_cast<const char *>(data), size);
+  OS.write(padding, alignTo(size, 8) - size);
+}
+
+/// Writes values to OS as a section of little-endian words.
+void writeWords(raw_ostream &OS, ArrayRef<unsigned> values) {
+  SmallVector<GraphFile::Word32, 0> words(values.size());
+  for (unsigned i = 0, e = values.size(); i < e; ++i) {
+    words[i] = values[i];
+  }
+  writeSection(OS, words.data(), words.size() * sizeof(GraphFile::Word32));
+}
+} // end anonymous namespace
+
+/*
+ *	The sources of all the operations are written one after the other, and
+ *  the bounds of all the ranges too. The node which bounds a symbolic
+ *  intersect is found in the bound lists, so it is the one the solver uses.
+ */
+void ConstraintGraph::write(raw_ostream &OS) const {
+  const unsigned numNodes = nodes.size();
+  const unsigned numOps = ops.size();
+  SmallVector<uint64_t, 0> words;
+
+  SmallVector<GraphFile::NodeRecord, 0> nodeRecords(numNodes);
+  for (unsigned id = 0; id < numNodes; ++id) {
+    GraphFile::NodeRecord &NR = nodeRecords[id];
+    NR.flags = nodes[id]->isConstant() ? GraphFile::NodeRecord::ConstantFlag
+                                       : 0;
+    NR.defOp = defOp[id];
+    NR.range = makeRangeRecord(nodes[id]->getRange(), words);
+  }
+
+  SmallVector<unsigned, 0> boundOf(numOps, NoOp);
+  for (unsigned id = 0; id < numNodes; ++id) {
+    for (unsigned op : getSymbUses(id)) {
+      boundOf[op] = id;
+    }
+  }
+  SmallVector<unsigned, 0> sources;
+  SmallVector<GraphFile::OpRecord, 0> opRecords(numOps);
+  for (unsigned id = 0; id < numOps; ++id) {
+    const BasicOp *op = ops[id];
+    GraphFile::OpRecord &OR = opRecords[id];
+    const SigmaOp *sigmaop = dyn_cast<SigmaOp>(op);
+    const SymbInterval *SI = dyn_cast<SymbInterval>(op->getIntersect());
+    OR.kind = static_cast<unsigned>(op->getValueId());
+    OR.flags =
+        (sigmaop != nullptr && sigmaop->isUnresolved()
+             ? GraphFile::OpRecord::UnresolvedFlag
+             : 0) |
+        (SI != nullptr ? GraphFile::OpRecord::SymbolicFlag : 0);
+    OR.opcode = op->getOpcode();
+    OR.sink = op->getSink()->getId();
+    OR.sourceBegin = sources.size();
+    OR.numSources = op->getNumSources();
+    for (unsigned i = 0, e = op->getNumSources(); i < e; ++i) {
+      sources.push_back(op->getSourceAt(i)->getId());
+    }
+    OR.bound = boundOf[id];
+    OR.predicate =
+        SI != nullptr ? static_cast<uint32_t>(SI->getOperation()) : 0U;
+    OR.intersect = makeRangeRecord(op->getIntersect()->getRange(), words);
+  }
+
+  GraphFile::Header H;
+  std::memcpy(H.magic, GraphFile::Magic, sizeof(H.magic));
+  H.version = GraphFile::Version;
+  H.nameSize = name.size();
+  H.numNodes = numNodes;
+  H.numOps = numOps;
+  H.numSources = sources.size();
+  H.numUses = useOps.size();
+  H.numSymbUses = symbOps.size();
+  H.numWords = words.size();
+  H.size = GraphFile::getRecordSize(H);
+
+  SmallVector<GraphFile::Word64, 0> littleWords(words.size());
+  for (unsigned i = 0, e = words.size(); i < e; ++i) {
+    littleWords[i] = words[i];
+  }
+
+  writeSection(OS, &H, sizeof(H));
+  writeSection(OS, name.data(), name.size());
+  writeSection(OS, nodeRecords.data(),
+               numNodes * sizeof(GraphFile::NodeRecord));
+  writeSection(OS, opRecords.data(), numOps * sizeof(GraphFile::OpRecord));
+  writeWords(OS, sources);
+  writeWords(OS, useBegin);
+  writeWords(OS, useOps);
+  writeWords(OS, symbBegin);
+  writeWords(OS, symbOps);
+  writeSection(OS, littleWords.data(),
+               littleWords.size() * sizeof(GraphFile::Word64));
+}
+
+bool ConstraintGraph::readRange(const GraphFile::RangeRecord &RR,
+                                ArrayRef<GraphFile::Word64> words, Range &R) {
+  const unsigned bitwidth = RR.bitwidth;
+  const uint64_t numWords = (uint64_t(bitwidth) + 63) / 64;
+  if (bitwidth == 0 || bitwidth > IntegerType::MAX_INT_BITS ||
+      RR.type > Empty || RR.words + 2 * numWords > words.size()) {
+    return false;
+  }
+
+  SmallVector<uint64_t, 2> lower(words.begin() + RR.words,
+                                 words.begin() + RR.words + numWords);
+  SmallVector<uint64_t, 2> upper(words.begin() + RR.words + numWords,
+                                 words.begin() + RR.words + 2 * numWords);
+  R = Range(APInt(bitwidth, lower), APInt(bitwidth, upper),
+            static_cast<RangeType>(unsigned(RR.type)));
+  return true;
+}
+
+BasicOp *ConstraintGraph::createOpOfKind(BasicOp::OperationId kind,
+                                         unsigned opcode, VarNode *sink,
+                                         ArrayRef<VarNode *> sources,
+                                         BasicInterval *intersect) {
+  // The solver stores what an operation computes in its sink as it is, so
+  // every range it handles has the width of the sink, but for the source of
+  // a cast and the selector of a select.
+  const unsigned bitwidth = sink->getBitWidth();
+  if (intersect->getRange().getBitWidth() != bitwidth) {
+    return nullptr;
+  }
+  for (unsigned i = 0, e = sources.size(); i < e; ++i) {
+    const unsigned sourceWidth = sources[i]->getBitWidth();
+    if (kind == BasicOp::OperationId::TernaryOpId && i == 0) {
+      continue;
+    }
+    if (kind == BasicOp::OperationId::UnaryOpId &&
+        opcode == Instruction::Trunc) {
+      if (sourceWidth <= bitwidth) {
+        return nullptr;
+      }
+    } else if (kind == BasicOp::OperationId::UnaryOpId &&
+               (opcode == Instruction::ZExt || opcode == Instruction::SExt)) {
+      if (sourceWidth >= bitwidth) {
+        return nullptr;
+      }
+    } else if (sourceWidth != bitwidth) {
+      return nullptr;
+    }
+  }
+
+  switch (kind) {
+  case BasicOp::OperationId::UnaryOpId:
+    if (sources.size() == 1) {
+      return createOp<UnaryOp>(intersect, sink, nullptr, sources[0], opcode);
+    }
+    break;
+  case BasicOp::OperationId::SigmaOpId:
+    if (sources.size() == 1) {
+      return createOp<SigmaOp>(intersect, sink, nullptr, sources[0], opcode);
+    }
+    break;
+  case BasicOp::OperationId::BinaryOpId:
+    if (sources.size() == 2) {
+      return createOp<BinaryOp>(intersect, sink, nullptr, sources[0],
+                                sources[1], opcode);
+    }
+    break;
+  case BasicOp::OperationId::TernaryOpId:
+    if (sources.size() == 3) {
+      return createOp<TernaryOp>(intersect, sink, nullptr, sources[0],
+                                 sources[1], sources[2], opcode);
+    }
+    break;
+  case BasicOp::OperationId::PhiOpId: {
+    PhiOp *phiop = createPhiOp(intersect, sink, nullptr, sources.size());
+    for (VarNode *source : sources) {
+      phiop->addSource(source);
+    }
+    return phiop;
+  }
+  }
+  return nullptr;
+}
+
+/*
+ *	The ids in R are checked before they are used, so that a damaged file
+ *  cannot make the solver read out of the graph. The maps of the graph stay
+ *  empty: only the finalized form is built.
+ */
+bool ConstraintGraph::read(const GraphFile::Record &R) {
+  const unsigned numNodes = R.nodes.size();
+  const unsigned numOps = R.ops.size();
+  name = R.name.str();
+
+  auto fail = [&]() {
+    errs() << "ERROR: graph " << name << " is inconsistent\n";
+    clear();
+    return false;
+  };
+  auto isList = [&](ArrayRef<GraphFile::Word32> begin,
+                    ArrayRef<GraphFile::Word32> list) {
+    for (unsigned i = 0; i < numNodes; ++i) {
+      if (begin[i] > begin[i + 1]) {
+        return false;
+      }
+    }
+    for (unsigned op : list) {
+      if (op >= numOps) {
+        return false;
+      }
+    }
+    return begin[0] == 0 && begin[numNodes] == list.size();
+  };
+  if (!isList(R.useBegin, R.useOps) || !isList(R.symbBegin, R.symbOps)) {
+    return fail();
+  }
+
+  for (const GraphFile::NodeRecord &NR : R.nodes) {
+    Range range(1);
+    if (!readRange(NR.range, R.words, range) ||
+        (NR.defOp >= numOps && NR.defOp != NoOp)) {
+      return fail();
+    }
+    const bool isConstant =
+        (NR.flags & GraphFile::NodeRecord::ConstantFlag) != 0;
+    nodes.push_back(new (arena.Allocate<VarNode>())
+                        VarNode(range, isConstant, &bounds));
+  }
+
+  for (const GraphFile::OpRecord &OR : R.ops) {
+    Range range(1);
+    const uint64_t sourceEnd = uint64_t(OR.sourceBegin) + OR.numSources;
+    if (!readRange(OR.intersect, R.words, range) || OR.sink >= numNodes ||
+        sourceEnd > R.sources.size() ||
+        (OR.bound >= numNodes && OR.bound != NoOp)) {
+      return fail();
+    }
+    SmallVector<VarNode *, 3> sources;
+    for (unsigned i = OR.sourceBegin; i < sourceEnd; ++i) {
+      if (R.sources[i] >= numNodes) {
+        return fail();
+      }
+      sources.push_back(nodes[R.sources[i]]);
+    }
+
+    BasicInterval *intersect =
+        (OR.flags & GraphFile::OpRecord::SymbolicFlag) != 0
+            ? createInterval<SymbInterval>(
+                  range, nullptr,
+                  static_cast<CmpInst::Predicate>(unsigned(OR.predicate)))
+            : createInterval<BasicInterval>(range);
+    BasicOp *op = createOpOfKind(
+        static_cast<BasicOp::OperationId>(unsigned(OR.kind)), OR.opcode,
+        nodes[OR.sink], sources, intersect);
+    if (op == nullptr) {
+      return fail();
+    }
+    if ((OR.flags & GraphFile::OpRecord::UnresolvedFlag) != 0) {
+      if (SigmaOp *sigmaop = dyn_cast<SigmaOp>(op)) {
+        sigmaop->markUnresolved();
+      }
+    }
+    op->setId(ops.size());
+    ops.push_back(op);
+  }
+
+  defOp.resize(numNodes);
+  for (unsigned id = 0; id < numNodes; ++id) {
+    defOp[id] = R.nodes[id].defOp;
+    if (defOp[id] != NoOp && ops[defOp[id]]->getSink() != nodes[id]) {
+      return fail();
+    }
+  }
+  useBegin.assign(R.useBegin.begin(), R.useBegin.end());
+  useOps.assign(R.useOps.begin(), R.useOps.end());
+  symbBegin.assign(R.symbBegin.begin(), R.symbBegin.end());
+  symbOps.assign(R.symbOps.begin(), R.symbOps.end());
+  for (unsigned id = 0; id < numNodes; ++id) {
+    for (unsigned op : getSymbUses(id)) {
+      if (!isa<SymbInterval>(ops[op]->getIntersect())) {
+        return fail();
+      }
+    }
+  }
+
+  compPosition.resize(numNodes);
+  buildThresholds();
+  return true;
+}
+
+VarNode *ConstraintGraph::addNode(const Range &R, bool constant) {
+  VarNode *node =
+      new (arena.Allocate<VarNode>()) VarNode(R, constant, &bounds);
+  nodes.push_back(node);
+  defOp.push_back(NoOp);
+  return node;
+}
+
+BasicOp *ConstraintGraph::addOp(BasicOp::OperationId kind, unsigned opcode,
+                                VarNode *sink, ArrayRef<VarNode *> sources,
+                                const Range &intersect, VarNode *bound,
+                                CmpInst::Predicate pred) {
+  const bool isUnary = kind == BasicOp::OperationId::UnaryOpId ||
+                       kind == BasicOp::OperationId::SigmaOpId;
+  if (bound != nullptr && !isUnary) {
+    return nullptr;
+  }
+
+  BasicInterval *itv =
+      bound != nullptr
+          ? createInterval<SymbInterval>(intersect, nullptr, pred)
+          : createInterval<BasicInterval>(intersect);
+  BasicOp *op = createOpOfKind(kind, opcode, sink, sources, itv);
+  if (op == nullptr) {
+    return nullptr;
+  }
+  op->setId(ops.size());
+  ops.push_back(op);
+  addedBounds.push_back(bound);
+  defOp[sink->getId()] = op->getId();
+  return op;
+}
+
+/*
+ *	The lists are built as finalize() builds them from the maps: the uses of
+ *  a node in increasing order of operation, each operation once, and the
+ *  operations bounded by a node in increasing order too.
+ */
+void ConstraintGraph::finishBuild() {
+  const unsigned numNodes = nodes.size();
+
+  useBegin.assign(numNodes + 1, 0);
+  symbBegin.assign(numNodes + 1, 0);
+  // Counting pass, then filling pass, as for compressed sparse rows
+  SmallVector<unsigned, 0> lastUse(numNodes, NoOp);
+  for (BasicOp *op : ops) {
+    for (unsigned i = 0, e = op->getNumSources(); i < e; ++i) {
+      const unsigned id = op->getSourceAt(i)->getId();
+      if (lastUse[id] != op->getId()) {
+        lastUse[id] = op->getId();
+        ++useBegin[id + 1];
+      }
+    }
+    if (addedBounds[op->getId()] != nullptr) {
+      ++symbBegin[addedBounds[op->getId()]->getId() + 1];
+    }
+  }
+  for (unsigned i = 0; i < numNodes; ++i) {
+    useBegin[i + 1] += useBegin[i];
+    symbBegin[i + 1] += symbBegin[i];
+  }
+
+  useOps.resize(useBegin[numNodes]);
+  symbOps.resize(symbBegin[numNodes]);
+  SmallVector<unsigned, 0> nextUse(useBegin.begin(), useBegin.end() - 1);
+  SmallVector<unsigned, 0> nextSymb(symbBegin.begin(), symbBegin.end() - 1);
+  lastUse.assign(numNodes, NoOp);
+  for (BasicOp *op : ops) {
+    for (unsigned i = 0, e = op->getNumSources(); i < e; ++i) {
+      const unsigned id = op->getSourceAt(i)->getId();
+      if (lastUse[id] != op->getId()) {
+        lastUse[id] = op->getId();
+        useOps[nextUse[id]++] = op->getId();
+      }
+    }
+    if (VarNode *bound = addedBounds[op->getId()]) {
+      symbOps[nextSymb[bound->getId()]++] = op->getId();
+    }
+  }
+  addedBounds.clear();
+
+  compPosition.resize(numNodes);
+  buildThresholds();
+}
+
+/*
+ *	This method evaluates once each operation that uses a variable in
+ *  component, so that the next SCCs after component will have entry
+ *  points to kick start the range analysis algorithm.
+ */
+void ConstraintGraph::propagateToNextSCC(ArrayRef<unsigned> component) {
+  for (unsigned id : component) {
+    for (unsigned opit : getUses(id)) {
+      BasicOp *op = ops[opit];
+      SigmaOp *sigmaop = dyn_cast<SigmaOp>(op);
+
+      op->getSink()->setRange(op->eval());
+
+      if ((sigmaop != nullptr) &&
+          sigmaop->getIntersect()->getRange().isUnknown()) {
+        sigmaop->markUnresolved();
+      }
+    }
+  }
+}
+
+/*
+ *	Finds SCCs using Nuutila's algorithm. The search starts from every node
+ *  not visited yet, and goes through the successors of each node: the sinks
+ *  of the operations where it is used, and then the sinks of the operations
+ *  whose intersect it bounds. The second kind of edge ensures that we solve
+ *  a future before fixing its interval. The recursion of the original
+ *  algorithm is replaced by an explicit stack of frames, each holding a node
+ *  and the next of its edges to follow.
+ */
+void Nuutila::findComponents(const ConstraintGraph &G) {
+  const unsigned numNodes = G.getNumNodes();
+  const unsigned Unvisited = ~0U;
+  // The preorder number of each node.
+  SmallVector<unsigned, 0> dfs(numNodes, Unvisited);
+  // The preorder number of the root of each node.
+  SmallVector<unsigned, 0> root(numNodes);
+  BitVector inComponent(numNodes);
+  // The visited nodes which are not roots and wait for their component.
+  SmallVector<unsigned, 0> stack;
+  SmallVector<std::pair<unsigned, unsigned>, 0> frames;
+  unsigned index = 0;
+
+  members.reserve(numNodes);
+  compBegin.push_back(0);
+
+  for (unsigned start = 0; start < numNodes; ++start) {
+    if (dfs[start] != Unvisited) {
+      continue;
+    }
+
+    dfs[start] = root[start] = index++;
+    frames.push_back(std::make_pair(start, 0));
+
+    while (!frames.empty()) {
+      const unsigned V = frames.back().first;
+      const unsigned edge = frames.back().second;
+      ArrayRef<unsigned> uses = G.getUses(V);
+      ArrayRef<unsigned> symbUses = G.getSymbUses(V);
+
+      if (edge < uses.size() + symbUses.size()) {
+        const unsigned op =
+            edge < uses.size() ? uses[edge] : symbUses[edge - uses.size()];
+        const unsigned W = G.getOp(op)->getSink()->getId();
+
+        // Visit W first. The edge is followed again once W is done.
+        if (dfs[W] == Unvisited) {
+          dfs[W] = root[W] = index++;
+          frames.push_back(std::make_pair(W, 0));
+          continue;
+        }
+
+        if (!inComponent[W] && root[V] >= root[W]) {
+          root[V] = root[W];
+        }
+        ++frames.back().second;
+        continue;
+      }
+
+      frames.pop_back();
+
+      // The second phase of the algorithm assigns components to stacked
+      // nodes
+      if (root[V] == dfs[V]) {
+        members.push_back(V);
+        inComponent.set(V);
+
+        while (!stack.empty() && dfs[stack.back()] > dfs[V]) {
+          members.push_back(stack.back());
+          inComponent.set(stack.back());
+          stack.pop_back();
+        }
+
+        compBegin.push_back(members.size());
+      } else {
+        stack.push_back(V);
+      }
+    }
+  }
+
+  // Components are found in reverse topological order. Reverse them, so that
+  // they are numbered in topological order.
+  std::reverse(members.begin(), members.end());
+  std::reverse(compBegin.begin(), compBegin.end());
+  for (unsigned &begin : compBegin) {
+    begin = numNodes - begin;
+  }
+}
+
+/*
+ *	Groups the operations by the component of their sink, so that each
+ *  component can go through its own operations only. Within a component,
+ *  the operations keep the order of their ids.
+ */
+void Nuutila::bucketOperations(const ConstraintGraph &G) {
+  const unsigned numOps = G.getNumOps();
+  componentOf.resize(G.getNumNodes());
+  for (unsigned c = 0, e = size(); c < e; ++c) {
+    for (unsigned id : getComponent(c)) {
+      componentOf[id] = c;
+    }
+  }
+
+  opBegin.assign(size() + 1, 0);
+  for (unsigned op = 0; op < numOps; ++op) {
+    ++opBegin[componentOf[G.getOp(op)->getSink()->getId()] + 1];
+  }
+  for (unsigned c = 0, e = size(); c < e; ++c) {
+    opBegin[c + 1] += opBegin[c];
+  }
+  compOps.resize(numOps);
+  SmallVector<unsigned, 0> next(opBegin.begin(), opBegin.end() - 1);
+  for (unsigned op = 0; op < numOps; ++op) {
+    compOps[next[componentOf[G.getOp(op)->getSink()->getId()]]++] = op;
+  }
+}
+
+void Nuutila::renumber(ArrayRef<unsigned> newIds) {
+  for (unsigned c = 0, e = size(); c < e; ++c) {
+    for (unsigned i = compBegin[c]; i < compBegin[c + 1]; ++i) {
+      members[i] = newIds[members[i]];
+      componentOf[members[i]] = c;
+    }
+  }
+  for (unsigned op = 0, e = compOps.size(); op < e; ++op) {
+    compOps[op] = op;
+  }
+}
+
+/*
+ *	Orders the components which touch a common node or interval. Solving a
+ *  component evaluates the operations whose sink is in it, and propagating
+ *  its ranges evaluates the operations where its nodes are used. Evaluating
+ *  an operation reads its sources and its intersect, and writes its sink.
+ *  Fixing the intersects bounded by a component reads their sinks and writes
+ *  the intersects. For every node and every symbolic intersect, the components
+ *  writing it are chained by their number, and each component reading it is
+ *  placed between the writers around it.
+ */
+ComponentDAG::ComponentDAG(const ConstraintGraph &G, const Nuutila &sccList) {
+  const unsigned numNodes = G.getNumNodes();
+  const unsigned numOps = G.getNumOps();
+  const unsigned numComponents = sccList.size();
+  const unsigned NoComponent = ~0U;
+  ArrayRef<unsigned> sccIds = sccList.getComponentIds();
+
+  // The components which evaluate each operation: the one of its sink, and
+  // the ones of its sources. The list of op is evalComps[evalBegin[op]] up to
+  // evalComps[evalEnd[op]].
+  SmallVector<unsigned, 0> evalBegin(numOps + 1, 0);
+  for (unsigned op = 0; op < numOps; ++op) {
+    evalBegin[op + 1] = 1;
+  }
+  for (unsigned id = 0; id < numNodes; ++id) {
+    for (unsigned op : G.getUses(id)) {
+      ++evalBegin[op + 1];
+    }
+  }
+  for (unsigned op = 0; op < numOps; ++op) {
+    evalBegin[op + 1] += evalBegin[op];
+  }
+  SmallVector<unsigned, 0> evalComps(evalBegin[numOps]);
+  SmallVector<unsigned, 0> evalEnd(evalBegin.begin(), evalBegin.end() - 1);
+  for (unsigned op = 0; op < numOps; ++op) {
+    evalComps[evalEnd[op]++] = sccIds[G.getOp(op)->getSink()->getId()];
+  }
+  for (unsigned id = 0; id < numNodes; ++id) {
+    for (unsigned op : G.getUses(id)) {
+      evalComps[evalEnd[op]++] = sccIds[id];
+    }
+  }
+  for (unsigned op = 0; op < numOps; ++op) {
+    unsigned *first = evalComps.begin() + evalBegin[op];
+    std::sort(first, evalComps.begin() + evalEnd[op]);
+    evalEnd[op] = std::unique(first, evalComps.begin() + evalEnd[op]) -
+                  evalComps.begin();
+  }
+
+  // The operations defining each node, and the component bounding the
+  // intersect of each operation
+  SmallVector<unsigned, 0> defBegin(numNodes + 1, 0);
+  for (unsigned op = 0; op < numOps; ++op) {
+    ++defBegin[G.getOp(op)->getSink()->getId() + 1];
+  }
+  for (unsigned id = 0; id < numNodes; ++id) {
+    defBegin[id + 1] += defBegin[id];
+  }
+  SmallVector<unsigned, 0> defOps(numOps);
+  SmallVector<unsigned, 0> next(defBegin.begin(), defBegin.end() - 1);
+  for (unsigned op = 0; op < numOps; ++op) {
+    defOps[next[G.getOp(op)->getSink()->getId()]++] = op;
+  }
+  SmallVector<unsigned, 0> boundComp(numOps, NoComponent);
+  for (unsigned id = 0; id < numNodes; ++id) {
+    for (unsigned op : G.getSymbUses(id)) {
+      boundComp[op] = sccIds[id];
+    }
+  }
+
+  SmallVector<std::pair<unsigned, unsigned>, 0> edges;
+  SmallVector<unsigned, 8> writers;
+  SmallVector<unsigned, 8> readers;
+  auto addEvaluators = [&](SmallVectorImpl<unsigned> &comps, unsigned op) {
+    comps.append(evalComps.begin() + evalBegin[op],
+                 evalComps.begin() + evalEnd[op]);
+  };
+  auto order = [&]() {
+    std::sort(writers.begin(), writers.end());
+    writers.erase(std::unique(writers.begin(), writers.end()), writers.end());
+    for (unsigned i = 1, e = writers.size(); i < e; ++i) {
+      edges.push_back(std::make_pair(writers[i - 1], writers[i]));
+    }
+    for (unsigned reader : readers) {
+      const unsigned *it =
+          std::lower_bound(writers.begin(), writers.end(), reader);
+      if (it != writers.end() && *it == reader) {
+        continue;
+      }
+      if (it != writers.begin()) {
+        edges.push_back(std::make_pair(*(it - 1), reader));
+      }
+      if (it != writers.end()) {
+        edges.push_back(std::make_pair(reader, *it));
+      }
+    }
+    writers.clear();
+    readers.clear();
+  };
+
+  for (unsigned id = 0; id < numNodes; ++id) {
+    writers.push_back(sccIds[id]);
+    for (unsigned i = defBegin[id], e = defBegin[id + 1]; i < e; ++i) {
+      addEvaluators(writers, defOps[i]);
+      if (boundComp[defOps[i]] != NoComponent) {
+        readers.push_back(boundComp[defOps[i]]);
+      }
+    }
+    for (unsigned op : G.getUses(id)) {
+      addEvaluators(readers, op);
+    }
+    order();
+  }
+  for (unsigned op = 0; op < numOps; ++op) {
+    if (boundComp[op] != NoComponent) {
+      writers.push_back(boundComp[op]);
+      addEvaluators(readers, op);
+      order();
+    }
+  }
+
+  // Successor lists
+  std::sort(edges.begin(), edges.end());
+  edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+  numPreds.assign(numComponents, 0);
+  succBegin.assign(numComponents + 1, 0);
+  succs.reserve(edges.size());
+  for (const std::pair<unsigned, unsigned> &edge : edges) {
+    ++numPreds[edge.second];
+    ++succBegin[edge.first + 1];
+    succs.push_back(edge.second);
+  }
+  for (unsigned c = 0; c < numComponents; ++c) {
+    succBegin[c + 1] += succBegin[c];
+  }
+}
+
+/*
+ *	Finds the strongly connected components in the constraint graph G, which
+ *  has to be finalized.
+ */
+Nuutila::Nuutila(const ConstraintGraph &G, bool single) {
+  const unsigned numNodes = G.getNumNodes();
+
+  if (single) {
+    /* FERNANDO */
+    for (unsigned id = 0; id < numNodes; ++id) {
+      members.push_back(id);
+    }
+    compBegin.push_back(0);
+    if (numNodes != 0) {
+      compBegin.push_back(numNodes);
+    }
+  } else {
+    findComponents(G);
+  }
+
+  bucketOperations(G);
+
+#ifdef SCC_DEBUG
+  ASSERT(checkComponents(G), "a node is not in exactly one component")
+  ASSERT(checkTopologicalSort(G), "topological sort is incorrect")
+#endif
+}
+
+#ifdef SCC_DEBUG
+bool Nuutila::checkComponents(const ConstraintGraph &G) {
+  bool isConsistent = true;
+  SmallVector<unsigned, 0> times(G.getNumNodes(), 0);
+  for (unsigned id : members) {
+    ++times[id];
+  }
+  for (unsigned id = 0, e = times.size(); id < e; ++id) {
+    if (times[id] != 1) {
+      errs() << "[Nuutila::checkComponents] Node " << id << " is in "
+             << times[id] << " components\n";
+      isConsistent = false;
+    }
+  }
+  return isConsistent;
+}
+
+/**
+ * Check that no edge goes from a component to a previous one
+ */
+bool Nuutila::checkTopologicalSort(const ConstraintGraph &G) {
+  bool isConsistent = true;
+  for (unsigned id = 0, e = G.getNumNodes(); id < e; ++id) {
+    for (ArrayRef<unsigned> edges : {G.getUses(id), G.getSymbUses(id)}) {
+      for (unsigned op : edges) {
+        const unsigned sink = G.getOp(op)->getSink()->getId();
+        if (componentOf[sink] < componentOf[id]) {
+          errs() << "[Nuutila::checkTopologicalSort] Component "
+                 << componentOf[id] << " has an edge to component "
+                 << componentOf[sink] << "\n";
+          isConsistent = false;
+        }
+      }
+    }
+  }
+  return isConsistent;
+}
+#endif
+} // namespace RangeAnalysis
@@ -0,0 +1,1735 @@
+//===------------------------- ConstraintGraph.h --------------------------===//
+//===------- The constraint graph of the Range Analysis and its solver ----===//
+//
+//					 The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+// Copyright (C) 2011-2012, 2015, 2017  Victor Hugo Sperle Campos
+//               2011               	  Douglas do Couto Teixeira
+//               2012               	  Igor Rafael de Assis Costa
+//
+//===----------------------------------------------------------------------===//
+// This file contains the constraint graph of the range analysis and the
+// solvers which find the intervals of its variables: the ranges, the nodes
+// and operations of the graph, Nuutila's algorithm for its strongly connected
+// components and the meet operators. It depends on LLVM's support library
+// only, so the graph can also be built and solved outside of a pass: the pass
+// builds it from the IR of a program, in RangeAnalysis.cpp, and other
+// programs either read it from a graph file or build it node by node with
+// addNode and addOp.
+//
+// Opcodes and predicates are those of LLVM's instructions, whose headers are
+// only used for these enumerations.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef _RANGEANALYSIS_CONSTRAINTGRAPH_H
+#define _RANGEANALYSIS_CONSTRAINTGRAPH_H
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <new>
+#include <sstream>
+#include <stack>
+#include <string>
+#include <utility>
+
+#include "llvm/ADT/APInt.h"
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/BitVector.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/SmallPtrSet.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/ADT/iterator.h"
+#include "llvm/ADT/iterator_range.h"
+#include "llvm/IR/InstrTypes.h"
+#include "llvm/Support/Allocator.h"
+#include "llvm/Support/Endian.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/raw_ostream.h"
+#include "llvm/Support/Timer.h"
+
+namespace llvm {
+class BasicBlock;
+class BranchInst;
+class Function;
+class Instruction;
+class PHINode;
+class SwitchInst;
+class Value;
+raw_ostream & dbgs();
+} // namespace llvm
+
+namespace RangeAnalysis {
+
+using namespace llvm;
+
+// Comment the line below to disable the debug of SCCs and optimize the code
+// generated.
+//#define SCC_DEBUG
+
+// Comment the line below to disable the dot printing of Constraint Graphs
+#define PRINT_DEBUG
+
+// Used to enable the stats computing. Comment the below line to disable it
+#define STATS
+
+// Uncomment the line below to activate jump-set widening technique
+// It generally leads to better precision in spite of low overhead in
+// running time, so I recommend leaving it activated
+#define JUMPSET
+
+//#define OVERFLOWHANDLER
+
+// Used to limit the number of iterations of fixed meet operator.
+// This update runs before widening and is necessary to improve the result of
+// some particular cases
+// This option is deprecated. We just used it for testing.
+#define NUMBER_FIXED_ITERATIONS 20
+
+#ifdef SCC_DEBUG
+#define ASSERT(cond, msg)                                                      \
+  if (!cond) {                                                                 \
+    errs() << "ERROR: " << msg << "\n";                                        \
+  }
+#else
+#define ASSERT(cond, msg)
+#endif
+
+//************************** Log Transactions ********************************//
+//#define LOG_TRANSACTIONS
+
+#ifdef LOG_TRANSACTIONS
+std::string _log_ErrorInfo;
+llvm::Twine _log_fileName = "/tmp/ratransactions";
+llvm::raw_fd_ostream _log_file(_log_fileName.str().c_str(), _log_ErrorInfo,
+                               sys::fs::F_Text);
+#define LOG_TRANSACTION(str) _log_file << str << "\n";
+#define FINISH_LOG _log_file.close();
+#else
+#define LOG_TRANSACTION(str)
+#define FINISH_LOG
+#endif
+//****************************************************************************//
+
+/// In our range analysis pass we have to perform operations on ranges all the
+/// time. LLVM has a class to perform operations on ranges: the class
+/// ConstantRange. However, the class ConstantRange doesn't serve very well
+/// our purposes because we need to perform operations with big numbers
+/// (MIN_INT, MAX_INT) a lot of times, without allowing these numbers to wrap
+/// around. And the class ConstantRange allows that. So, I'm writing this class
+/// to
+/// perform operations on ranges, considering these big numbers and without
+/// allowing them to wrap around.
+/// The interface of this class is very similar to LLVM's ConstantRange class.
+/// TODO: probably, a better idea would be perform our range analysis
+/// considering the ranges symbolically, letting them wrap around,
+/// as ConstantRange considers, but it would require big changes
+/// in our algorithm.
+///
+/// Ranges that are at most 64 bits wide keep their bounds in native int64_t
+/// values and use saturating arithmetic built on the compiler's overflow
+/// builtins. Only wider ranges fall back to APInt. The backend is chosen by
+/// the bit width the range is built with, and the bounds of both backends
+/// share the same storage, so that a native range does not pay for APInts.
+///
+/// Every range carries the bit width of the variable it describes, and
+/// -inf/+inf are the signed limits of that width. Operations take operands
+/// of the same width; sextOrTrunc, zextOrTrunc and truncate are the only
+/// ones that move a range to another width.
+
+enum RangeType { Unknown, Regular, Empty };
+
+class Range {
+private:
+  unsigned bitwidth; // The bit width of both bounds.
+  RangeType type{Regular};
+  // isNative() tells which member of each union holds the bound.
+  union {
+    int64_t nl; // The lower bound of the range (native backend).
+    APInt l;    // The lower bound of the range (APInt backend).
+  };
+  union {
+    int64_t nu; // The upper bound of the range (native backend).
+    APInt u;    // The upper bound of the range (APInt backend).
+  };
+
+  Range(int64_t lb, int64_t ub, unsigned bitwidth, RangeType rType = Regular);
+  int64_t getNativeMin() const;
+  int64_t getNativeMax() const;
+  Range nativeAdd(const Range &other) const;
+  Range nativeSub(const Range &other) const;
+  Range nativeMul(const Range &other) const;
+  Range nativeUdiv(const Range &other) const;
+  Range nativeSdiv(const Range &other) const;
+  Range nativeUrem(const Range &other) const;
+  Range nativeSrem(const Range &other) const;
+  Range nativeShl(const Range &other) const;
+  Range nativeLshr(const Range &other) const;
+  Range nativeAshr(const Range &other) const;
+  Range nativeAnd(const Range &other) const;
+  Range nativeAnd_conservative(const Range &other) const;
+  Range nativeOr(const Range &other) const;
+  Range nativeOr_conservative(const Range &other) const;
+  Range nativeTruncate(unsigned bitwidth) const;
+  Range nativeIntersectWith(const Range &other) const;
+  Range nativeUnionWith(const Range &other) const;
+  /// Builds the bounds of the backend of the range from those of other,
+  /// which has the same width.
+  void initBounds(const Range &other) {
+    if (isNative()) {
+      nl = other.nl;
+      nu = other.nu;
+    } else {
+      new (&l) APInt(other.l);
+      new (&u) APInt(other.u);
+    }
+  }
+  void initBounds(Range &&other) {
+    if (isNative()) {
+      nl = other.nl;
+      nu = other.nu;
+    } else {
+      new (&l) APInt(std::move(other.l));
+      new (&u) APInt(std::move(other.u));
+    }
+  }
+  void destroyBounds() {
+    if (!isNative()) {
+      l.~APInt();
+      u.~APInt();
+    }
+  }
+
+  friend class BoundsTable;
+
+public:
+  /// Builds the range [-inf, +inf] of the given bit width.
+  explicit Range(unsigned bitwidth, RangeType rType = Regular);
+  Range(const APInt &lb, const APInt &ub, RangeType rType = Regular);
+  ~Range() { destroyBounds(); }
+  Range(const Range &other) : bitwidth(other.bitwidth), type(other.type) {
+    initBounds(other);
+  }
+  Range(Range &&other) : bitwidth(other.bitwidth), type(other.type) {
+    initBounds(std::move(other));
+  }
+  Range &operator=(const Range &other) {
+    if (!isNative() && !other.isNative()) {
+      l = other.l;
+      u = other.u;
+      bitwidth = other.bitwidth;
+    } else {
+      destroyBounds();
+      bitwidth = other.bitwidth;
+      initBounds(other);
+    }
+    type = other.type;
+    return *this;
+  }
+  Range &operator=(Range &&other) {
+    if (!isNative() && !other.isNative()) {
+      l = std::move(other.l);
+      u = std::move(other.u);
+      bitwidth = other.bitwidth;
+    } else {
+      destroyBounds();
+      bitwidth = other.bitwidth;
+      initBounds(std::move(other));
+    }
+    type = other.type;
+    return *this;
+  }
+
+  APInt getLower() const {
+    return isNative() ? APInt(bitwidth, nl, true) : l;
+  }
+  APInt getUpper() const {
+    return isNative() ? APInt(bitwidth, nu, true) : u;
+  }
+  void setLower(const APInt &newl) {
+    if (isNative()) {
+      this->nl = newl.getSExtValue();
+    } else {
+      this->l = newl;
+    }
+  }
+  void setUpper(const APInt &newu) {
+    if (isNative()) {
+      this->nu = newu.getSExtValue();
+    } else {
+      this->u = newu;
+    }
+  }
+  unsigned getBitWidth() const { return bitwidth; }
+  /// Returns true if the bounds are kept in native integers.
+  bool isNative() const { return bitwidth <= 64; }
+  /// Returns true if the lower bound is greater than the upper bound.
+  bool hasInvertedBounds() const {
+    return isNative() ? nl > nu : l.sgt(u);
+  }
+  /// Returns true if the lower bound is -inf.
+  bool isLowerMin() const {
+    return isNative() ? nl == getNativeMin() : l.isMinSignedValue();
+  }
+  /// Returns true if the upper bound is +inf.
+  bool isUpperMax() const {
+    return isNative() ? nu == getNativeMax() : u.isMaxSignedValue();
+  }
+  bool isUnknown() const { return type == Unknown; }
+  void setUnknown() { type = Unknown; }
+  bool isRegular() const { return type == Regular; }
+  void setRegular() { type = Regular; }
+  bool isEmpty() const { return type == Empty; }
+  void setEmpty() { type = Empty; }
+  bool isMaxRange() const;
+  void print(raw_ostream &OS) const;
+  Range add(const Range &other) const;
+  Range sub(const Range &other) const;
+  Range mul(const Range &other) const;
+  Range udiv(const Range &other) const;
+  Range sdiv(const Range &other) const;
+  Range urem(const Range &other) const;
+  Range srem(const Range &other) const;
+  Range shl(const Range &other) const;
+  Range lshr(const Range &other) const;
+  Range ashr(const Range &other) const;
+  Range And(const Range &other) const;
+  Range And_conservative(const Range &other) const;
+  Range Or(const Range &other) const;
+  Range Or_conservative(const Range &other) const;
+  Range Xor(const Range &other) const;
+  Range truncate(unsigned bitwidth) const;
+  //	Range signExtend(unsigned bitwidth) const;
+  //	Range zeroExtend(unsigned bitwidth) const;
+  Range sextOrTrunc(unsigned bitwidth) const;
+  Range zextOrTrunc(unsigned bitwidth) const;
+  /// Moves the range to another bit width. Unlike the casts above, -inf and
+  /// +inf stay infinite, and bounds that do not fit are clamped.
+  Range resize(unsigned bitwidth) const;
+  Range intersectWith(const Range &other) const;
+  Range unionWith(const Range &other) const;
+  bool operator==(const Range &other) const;
+  bool operator!=(const Range &other) const;
+};
+
+/// The ranges of the variables of a constraint graph, kept in parallel arrays
+/// indexed by the id of each VarNode. Bounds of ranges up to 64 bits wide live
+/// in the lower and upper arrays. For wider ranges, the lower array holds the
+/// position of the APInt bounds in a side table instead.
+class BoundsTable {
+private:
+  SmallVector<int64_t, 0> lower;
+  SmallVector<int64_t, 0> upper;
+  SmallVector<unsigned, 0> widths;
+  SmallVector<RangeType, 0> types;
+  SmallVector<std::pair<APInt, APInt>, 0> wide;
+  // While threads share the table, one spin lock per entry, so that no range
+  // is read half written. Null otherwise.
+  std::unique_ptr<std::atomic<bool>[]> locks;
+
+  Range read(unsigned id) const {
+    if (widths[id] <= 64) {
+      return Range(lower[id], upper[id], widths[id], types[id]);
+    }
+    const std::pair<APInt, APInt> &bounds = wide[lower[id]];
+    return Range(bounds.first, bounds.second, types[id]);
+  }
+  void write(unsigned id, const Range &R) {
+    assert(R.getBitWidth() == widths[id] && "Range of another width");
+    types[id] = R.hasInvertedBounds() ? Empty : R.type;
+    if (R.isNative()) {
+      lower[id] = R.nl;
+      upper[id] = R.nu;
+    } else {
+      wide[lower[id]] = std::make_pair(R.l, R.u);
+    }
+  }
+  void lock(unsigned id) const {
+    while (locks[id].exchange(true, std::memory_order_acquire)) {
+    }
+  }
+  void unlock(unsigned id) const {
+    locks[id].store(false, std::memory_order_release);
+  }
+
+public:
+  BoundsTable() = default;
+  ~BoundsTable() = default;
+  BoundsTable(const BoundsTable &) = delete;
+  BoundsTable(BoundsTable &&) = delete;
+  BoundsTable &operator=(const BoundsTable &) = delete;
+  BoundsTable &operator=(BoundsTable &&) = delete;
+
+  /// Adds an entry holding R and returns its id.
+  unsigned add(const Range &R);
+  /// Returns the range stored in the entry id.
+  Range get(unsigned id) const {
+    if (!locks) {
+      return read(id);
+    }
+    lock(id);
+    Range R = read(id);
+    unlock(id);
+    return R;
+  }
+  /// Stores R in the entry id, or the empty range if the bounds of R are
+  /// inverted. R must keep the width of the entry.
+  void set(unsigned id, const Range &R) {
+    if (!locks) {
+      write(id, R);
+      return;
+    }
+    lock(id);
+    write(id, R);
+    unlock(id);
+  }
+  /// Makes get and set safe to call from several threads at once, as long as
+  /// each entry has a single writer, or back. No entry can be added while
+  /// the table is shared.
+  void setShared(bool shared);
+  unsigned getBitWidth(unsigned id) const { return widths[id]; }
+  unsigned size() const { return widths.size(); }
+  /// Moves the entries so that entry i holds what entry order[i] held. The
+  /// table must not be shared.
+  void permute(ArrayRef<unsigned> order);
+  /// Removes every entry, keeping the memory for the next ones.
+  void clear();
+};
+
+/// This class represents a program variable.
+class VarNode {
+private:
+  // The program variable which is represented.
+  const Value *V;
+  // The table which holds the range associated to the variable, that is, its
+  // interval inferred by the analysis.
+  BoundsTable *bounds;
+  // The dense id of the node in its graph, and of its range in the table.
+  unsigned id;
+  // Used by the crop meet operator
+  char abstractState;
+  // Whether the variable is a constant, whose range is its value.
+  bool constant;
+
+public:
+  VarNode(const Value *V, BoundsTable *bounds);
+  /// Builds a node with no variable, such as one read from a graph file.
+  VarNode(const Range &R, bool constant, BoundsTable *bounds);
+  ~VarNode();
+  VarNode(const VarNode &) = delete;
+  VarNode(VarNode &&) = delete;
+  VarNode &operator=(const VarNode &) = delete;
+  VarNode &operator=(VarNode &&) = delete;
+  /// Initializes the value of the node.
+  void init(bool outside);
+  /// Returns the range of the variable represented by this node.
+  Range getRange() const { return bounds->get(id); }
+  /// Returns the bit width of the variable represented by this node.
+  unsigned getBitWidth() const { return bounds->getBitWidth(id); }
+  /// Returns the variable represented by this node, or null if the node was
+  /// not built from the program.
+  const Value *getValue() const { return V; }
+  /// Returns true if the variable is a constant.
+  bool isConstant() const { return constant; }
+  /// Returns the dense id of this node.
+  unsigned getId() const { return id; }
+  /// Changes the id of this node. Its range has to be moved to the new entry
+  /// of the table too.
+  void setId(unsigned newId) { this->id = newId; }
+  /// Moves the node to a new entry of the table newBounds.
+  void moveTo(BoundsTable *newBounds);
+  /// Changes the status of the variable represented by this node.
+  /// If the lower bound is greater than the upper bound, the range becomes
+  /// empty.
+  void setRange(const Range &newInterval) { bounds->set(id, newInterval); }
+  /// Pretty print.
+  void print(raw_ostream &OS) const;
+  char getAbstractState() { return abstractState; }
+  // The possible states are '0', '+', '-' and '?'.
+  void storeAbstractState();
+};
+
+enum IntervalId { BasicIntervalId, SymbIntervalId };
+
+/// This class represents a basic interval of values. This class could inherit
+/// from LLVM's Range class, since it *is a Range*. However,
+/// LLVM's Range class doesn't have a virtual constructor.
+class BasicInterval {
+private:
+  Range range;
+
+public:
+  explicit BasicInterval(unsigned bitwidth);
+  explicit BasicInterval(Range range);
+  BasicInterval(const APInt &l, const APInt &u);
+  virtual ~BasicInterval(); // This is a base class.
+  BasicInterval(const BasicInterval &) = delete;
+  BasicInterval(BasicInterval &&) = delete;
+  BasicInterval &operator=(const BasicInterval &) = delete;
+  BasicInterval &operator=(BasicInterval &&) = delete;
+
+  // Methods for RTTI
+  virtual IntervalId getValueId() const { return BasicIntervalId; }
+  static bool classof(BasicInterval const * /*unused*/) { return true; }
+  /// Returns the range of this interval.
+  const Range &getRange() const { return this->range; }
+  /// Sets the range of this interval to another range.
+  void setRange(const Range &newRange) {
+    this->range = newRange;
+
+    // Check if lower bound is greater than upper bound. If it is,
+    // set range to empty
+    if (this->range.hasInvertedBounds()) {
+      this->range.setEmpty();
+    }
+  }
+  /// Pretty print. Symbolic intervals are printed by SymbInterval::print, so
+  /// that the vtable of intervals needs no printing code.
+  void print(raw_ostream &OS) const;
+};
+
+/// This is an interval that contains a symbolic limit, which is
+/// given by the bounds of a program name, e.g.: [-inf, ub(b) + 1].
+class SymbInterval : public BasicInterval {
+private:
+  // The bound. It is a node which limits the interval of this range.
+  const Value *bound;
+  // The predicate of the operation in which this interval takes part.
+  // It is useful to know how we can constrain this interval
+  // after we fix the intersects.
+  CmpInst::Predicate pred;
+
+public:
+  SymbInterval(const Range &range, const Value *bound, CmpInst::Predicate pred);
+  ~SymbInterval() override;
+  SymbInterval(const SymbInterval &) = delete;
+  SymbInterval(SymbInterval &&) = delete;
+  SymbInterval &operator=(const SymbInterval &) = delete;
+  SymbInterval &operator=(SymbInterval &&) = delete;
+
+  // Methods for RTTI
+  IntervalId getValueId() const override { return SymbIntervalId; }
+  static bool classof(SymbInterval const * /*unused*/) { return true; }
+  static bool classof(BasicInterval const *BI) {
+    return BI->getValueId() == SymbIntervalId;
+  }
+  /// Returns the opcode of the operation that create this interval.
+  CmpInst::Predicate getOperation() const { return this->pred; }
+  /// Returns the node which is the bound of this interval.
+  const Value *getBound() const { return this->bound; }
+  /// Replace symbolic intervals with hard-wired constants.
+  Range fixIntersects(VarNode *bound, VarNode *sink);
+  /// Prints the content of the interval.
+  void print(raw_ostream &OS) const;
+};
+
+/// This class represents a generic operation in our analysis.
+/// Operations are fixed-size records tagged with their kind. The subclasses
+/// add no data: they only give typed access to the fields kept here, so
+/// evaluating or printing an operation is a switch on the tag rather than a
+/// virtual call, and operations need no destructor.
+class BasicOp {
+public:
+  enum class OperationId : uint8_t {
+    UnaryOpId,
+    SigmaOpId,
+    BinaryOpId,
+    TernaryOpId,
+    PhiOpId
+  };
+  // The largest number of sources kept inside the record.
+  static const unsigned MaxInlineSources = 3;
+
+protected:
+  // The range of the operation. Each operation has a range associated to it.
+  // This range is obtained by inspecting the branches in the source program
+  // and extracting its condition and intervals.
+  BasicInterval *intersect;
+  // The target of the operation, that is, the node which
+  // will store the result of the operation.
+  VarNode *sink;
+  // The instruction that originated this op node
+  const Instruction *inst;
+  union {
+    // The sources of unary, binary and ternary operations.
+    VarNode *inlineSources[MaxInlineSources];
+    // The sources of a phi operation, in an array of the arena of the graph.
+    const VarNode **phiSources;
+  };
+  // The dense id of the operation, given when the graph is finalized.
+  unsigned id{0};
+  // The opcode of the operation.
+  unsigned opcode;
+  // The number of sources of the operation.
+  unsigned numSources{0};
+  // The room of phiSources.
+  unsigned maxSources{0};
+  // The kind of the operation.
+  OperationId kind;
+  // Whether a sigma operation still depends on an unresolved future.
+  bool unresolved{false};
+
+  /// We do not want people creating objects of this class,
+  /// but we want to inherit from it.
+  BasicOp(OperationId kind, BasicInterval *intersect, VarNode *sink,
+          const Instruction *inst, unsigned opcode = 0);
+
+public:
+  ~BasicOp() = default;
+  // We do not want people creating objects of this class.
+  BasicOp(const BasicOp &) = delete;
+  BasicOp(BasicOp &&) = delete;
+  BasicOp &operator=(const BasicOp &) = delete;
+  BasicOp &operator=(BasicOp &&) = delete;
+
+  // Methods for RTTI
+  OperationId getValueId() const { return kind; }
+  static bool classof(BasicOp const * /*unused*/) { return true; }
+  /// Given the input of the operation and the operation that will be
+  /// performed, evaluates the result of the operation.
+  Range eval() const;
+  /// Return the instruction that originated this op node
+  const Instruction *getInstruction() const { return inst; }
+  /// Return the opcode of the operation.
+  unsigned int getOpcode() const { return opcode; }
+  /// Returns the dense id of the operation.
+  unsigned getId() const { return id; }
+  void setId(unsigned newId) { this->id = newId; }
+  /// Replace symbolic intervals with hard-wired constants.
+  void fixIntersects(VarNode *V);
+  /// Returns the range of the operation.
+  BasicInterval *getIntersect() const { return intersect; }
+  /// Changes the interval of the operation.
+  void setIntersect(const Range &newIntersect) {
+    this->intersect->setRange(newIntersect);
+  }
+  /// Returns the target of the operation, that is,
+  /// where the result will be stored.
+  const VarNode *getSink() const { return sink; }
+  /// Returns the target of the operation, that is,
+  /// where the result will be stored.
+  VarNode *getSink() { return sink; }
+  /// Changes the target of the operation.
+  void setSink(VarNode *newSink) { this->sink = newSink; }
+  /// Returns the number of sources of the operation.
+  unsigned getNumSources() const { return numSources; }
+  /// Returns the source identified by index, whatever the kind of the
+  /// operation.
+  const VarNode *getSourceAt(unsigned index) const {
+    return kind == OperationId::PhiOpId ? phiSources[index]
+                                        : inlineSources[index];
+  }
+  /// Replaces the source from of the operation with the node to.
+  void replaceSource(const VarNode *from, VarNode *to);
+  /// Prints the content of the operation.
+  void print(raw_ostream &OS) const;
+};
+
+/// A constraint like sink = operation(source) \intersec [l, u]
+/// Examples: unary instructions such as truncations, sign extensions,
+/// zero extensions.
+class UnaryOp : public BasicOp {
+protected:
+  UnaryOp(OperationId kind, BasicInterval *intersect, VarNode *sink,
+          const Instruction *inst, VarNode *source, unsigned int opcode);
+
+public:
+  UnaryOp(BasicInterval *intersect, VarNode *sink, const Instruction *inst,
+          VarNode *source, unsigned int opcode);
+  ~UnaryOp() = default;
+  UnaryOp(const UnaryOp &) = delete;
+  UnaryOp(UnaryOp &&) = delete;
+  UnaryOp &operator=(const UnaryOp &) = delete;
+  UnaryOp &operator=(UnaryOp &&) = delete;
+
+  // Methods for RTTI
+  static bool classof(UnaryOp const * /*unused*/) { return true; }
+  static bool classof(BasicOp const *BO) {
+    return BO->getValueId() == OperationId::UnaryOpId ||
+           BO->getValueId() == OperationId::SigmaOpId;
+  }
+  /// Computes the interval of the sink based on the interval of the sources,
+  /// the operation and the interval associated to the operation.
+  Range eval() const;
+  /// Returns the source of the operation.
+  VarNode *getSource() const { return inlineSources[0]; }
+  /// Prints the content of the operation. I didn't it an operator overload
+  /// because I had problems to access the members of the class outside it.
+  void print(raw_ostream &OS) const;
+};
+
+// Specific type of UnaryOp used to represent sigma functions
+class SigmaOp : public UnaryOp {
+public:
+  SigmaOp(BasicInterval *intersect, VarNode *sink, const Instruction *inst,
+          VarNode *source, unsigned int opcode);
+  ~SigmaOp() = default;
+  SigmaOp(const SigmaOp &) = delete;
+  SigmaOp(SigmaOp &&) = delete;
+  SigmaOp &operator=(const SigmaOp &) = delete;
+  SigmaOp &operator=(SigmaOp &&) = delete;
+
+  // Methods for RTTI
+  static bool classof(SigmaOp const * /*unused*/) { return true; }
+  static bool classof(UnaryOp const *UO) {
+    return UO->getValueId() == OperationId::SigmaOpId;
+  }
+  static bool classof(BasicOp const *BO) {
+    return BO->getValueId() == OperationId::SigmaOpId;
+  }
+
+  /// Computes the interval of the sink based on the interval of the sources,
+  /// the operation and the interval associated to the operation.
+  Range eval() const;
+
+  bool isUnresolved() const { return unresolved; }
+  void markResolved() { unresolved = false; }
+  void markUnresolved() { unresolved = true; }
+
+  /// Prints the content of the operation. I didn't it an operator overload
+  /// because I had problems to access the members of the class outside it.
+  void print(raw_ostream &OS) const;
+};
+
+/// A constraint like sink = phi(src1, src2, ..., srcN)
+class PhiOp : public BasicOp {
+public:
+  /// The sources are stored in the array sources, which has room for
+  /// maxSources of them.
+  PhiOp(BasicInterval *intersect, VarNode *sink, const Instruction *inst,
+        const VarNode **sources, unsigned maxSources);
+  ~PhiOp() = default;
+  PhiOp(const PhiOp &) = delete;
+  PhiOp(PhiOp &&) = delete;
+  PhiOp &operator=(const PhiOp &) = delete;
+  PhiOp &operator=(PhiOp &&) = delete;
+
+  // Add source to the vector of sources
+  void addSource(const VarNode *newsrc);
+  // Return source identified by index
+  const VarNode *getSource(unsigned index) const { return phiSources[index]; }
+  // Methods for RTTI
+  static bool classof(PhiOp const * /*unused*/) { return true; }
+  static bool classof(BasicOp const *BO) {
+    return BO->getValueId() == OperationId::PhiOpId;
+  }
+  /// Computes the interval of the sink based on the interval of the sources,
+  /// the operation and the interval associated to the operation.
+  Range eval() const;
+  /// Prints the content of the operation. I didn't it an operator overload
+  /// because I had problems to access the members of the class outside it.
+  void print(raw_ostream &OS) const;
+};
+
+/// A constraint like sink = source1 operation source2 intersect [l, u].
+class BinaryOp : public BasicOp {
+public:
+  BinaryOp(BasicInterval *intersect, VarNode *sink, const Instruction *inst,
+           VarNode *source1, VarNode *source2, unsigned int opcode);
+  ~BinaryOp() = default;
+  BinaryOp(const BinaryOp &) = delete;
+  BinaryOp(BinaryOp &&) = delete;
+  BinaryOp &operator=(const BinaryOp &) = delete;
+  BinaryOp &operator=(BinaryOp &&) = delete;
+
+  // Methods for RTTI
+  static bool classof(BinaryOp const * /*unused*/) { return true; }
+  static bool classof(BasicOp const *BO) {
+    return BO->getValueId() == OperationId::BinaryOpId;
+  }
+  /// Computes the interval of the sink based on the interval of the sources,
+  /// the operation and the interval associated to the operation.
+  Range eval() const;
+  /// Returns the first operand of this operation.
+  VarNode *getSource1() const { return inlineSources[0]; }
+  /// Returns the second operand of this operation.
+  VarNode *getSource2() const { return inlineSources[1]; }
+  /// Prints the content of the operation. I didn't it an operator overload
+  /// because I had problems to access the members of the class outside it.
+  void print(raw_ostream &OS) const;
+};
+
+class TernaryOp : public BasicOp {
+public:
+  TernaryOp(BasicInterval *intersect, VarNode *sink, const Instruction *inst,
+            VarNode *source1, VarNode *source2, VarNode *source3,
+            unsigned int opcode);
+  ~TernaryOp() = default;
+  TernaryOp(const TernaryOp &) = delete;
+  TernaryOp(TernaryOp &&) = delete;
+  TernaryOp &operator=(const TernaryOp &) = delete;
+  TernaryOp &operator=(TernaryOp &&) = delete;
+
+  // Methods for RTTI
+  static bool classof(TernaryOp const * /*unused*/) { return true; }
+  static bool classof(BasicOp const *BO) {
+    return BO->getValueId() == OperationId::TernaryOpId;
+  }
+  /// Computes the interval of the sink based on the interval of the sources,
+  /// the operation and the interval associated to the operation.
+  Range eval() const;
+  /// Returns the first operand of this operation.
+  VarNode *getSource1() const { return inlineSources[0]; }
+  /// Returns the second operand of this operation.
+  VarNode *getSource2() const { return inlineSources[1]; }
+  /// Returns the third operand of this operation.
+  VarNode *getSource3() const { return inlineSources[2]; }
+  /// Prints the content of the operation. I didn't it an operator overload
+  /// because I had problems to access the members of the class outside it.
+  void print(raw_ostream &OS) const;
+};
+
+/// This class is used to store the intersections that we get in the branches.
+/// I decided to write it because I think it is better to have an object
+/// to store these information than create a lot of maps
+/// in the ConstraintGraph class.
+class ValueBranchMap {
+private:
+  const Value *V;
+  const BasicBlock *BBTrue;
+  const BasicBlock *BBFalse;
+  BasicInterval *ItvT;
+  BasicInterval *ItvF;
+
+public:
+  ValueBranchMap(const Value *V, const BasicBlock *BBTrue,
+                 const BasicBlock *BBFalse, BasicInterval *ItvT,
+                 BasicInterval *ItvF);
+  ~ValueBranchMap();
+  ValueBranchMap(const ValueBranchMap &) = default;
+  ValueBranchMap(ValueBranchMap &&) = default;
+  ValueBranchMap &operator=(const ValueBranchMap &) = delete;
+  ValueBranchMap &operator=(ValueBranchMap &&) = delete;
+
+  /// Get the "false side" of the branch
+  const BasicBlock *getBBFalse() const { return BBFalse; }
+  /// Get the "true side" of the branch
+  const BasicBlock *getBBTrue() const { return BBTrue; }
+  /// Get the interval associated to the true side of the branch
+  BasicInterval *getItvT() const { return ItvT; }
+  /// Get the interval associated to the false side of the branch
+  BasicInterval *getItvF() const { return ItvF; }
+  /// Get the value associated to the branch.
+  const Value *getV() const { return V; }
+  /// Change the interval associated to the true side of the branch
+  void setItvT(BasicInterval *Itv) { this->ItvT = Itv; }
+  /// Change the interval associated to the false side of the branch
+  void setItvF(BasicInterval *Itv) { this->ItvF = Itv; }
+};
+
+/// This is pretty much the same thing as ValueBranchMap
+/// but implemented specifically for switch instructions
+class ValueSwitchMap {
+private:
+  const Value *V;
+  SmallVector<std::pair<BasicInterval *, const BasicBlock *>, 4> BBsuccs;
+
+public:
+  ValueSwitchMap(
+      const Value *V,
+      SmallVector<std::pair<BasicInterval *, const BasicBlock *>, 4> &BBsuccs);
+  ~ValueSwitchMap();
+  ValueSwitchMap(const ValueSwitchMap &) = default;
+  ValueSwitchMap(ValueSwitchMap &&) = default;
+  ValueSwitchMap &operator=(const ValueSwitchMap &) = delete;
+  ValueSwitchMap &operator=(ValueSwitchMap &&) = delete;
+
+  /// Get the corresponding basic block
+  const BasicBlock *getBB(unsigned idx) const { return BBsuccs[idx].second; }
+  /// Get the interval associated to the switch case idx
+  BasicInterval *getItv(unsigned idx) const { return BBsuccs[idx].first; }
+  // Get how many cases this switch has
+  unsigned getNumOfCases() const { return BBsuccs.size(); }
+  /// Get the value associated to the switch.
+  const Value *getV() const { return V; }
+  /// Change the interval associated to the true side of the branch
+  void setItv(unsigned idx, BasicInterval *Itv) {
+    this->BBsuccs[idx].first = Itv;
+  }
+};
+
+/// This class can be used to gather statistics on running time
+/// and memory footprint. It had been developed before LLVM started
+/// to provide a class for this exact purpose. We'll keep using this
+/// because it works just fine and is well put together.
+class Profile {
+  using AccTimesMap = StringMap<llvm::TimeRecord>;
+  TimerGroup *tg{};
+  SmallVector<Timer *, 4> timers;
+
+  AccTimesMap accumulatedtimes;
+  ssize_t memory{0L};
+
+public:
+  Profile() {
+    tg = new TimerGroup("RangeAnalysis", "Range Analysis algorithm");
+  }
+
+  ~Profile() {
+    delete tg;
+    for (Timer *timer : timers) {
+      delete timer;
+    }
+  }
+
+  Profile(const Profile &) = delete;
+  Profile(Profile &&) = delete;
+  Profile &operator=(const Profile &) = delete;
+  Profile &operator=(Profile &&) = delete;
+
+  ssize_t getMemoryUsage() const { return memory; }
+
+  Timer *registerNewTimer(StringRef key, StringRef descr) {
+    Timer *timer = new Timer(key, descr, *tg);
+    timers.push_back(timer);
+
+    return timer;
+  }
+
+  void addTimeRecord(const Timer *timer) {
+    StringRef key = timer->getName();
+    TimeRecord time = timer->getTotalTime();
+    accumulatedtimes[key] += time;
+  }
+
+  double getTimeDouble(StringRef key) {
+    return accumulatedtimes[key].getUserTime();
+  }
+
+  TimeRecord getTimeRecord(StringRef key) { return accumulatedtimes[key]; }
+
+  /// Adds the times and the memory usage of other to this profile.
+  void merge(const Profile &other) {
+    for (const auto &entry : other.accumulatedtimes) {
+      accumulatedtimes[entry.getKey()] += entry.getValue();
+    }
+    if (other.memory > memory) {
+      memory = other.memory;
+    }
+  }
+
+  void printTime(StringRef key) {
+    double time = getTimeDouble(key);
+    std::ostringstream formatted;
+    formatted << time;
+    errs() << formatted.str() << "\t - " << key << " elapsed time\n";
+  }
+
+  void registerMemoryUsage() {
+    TimeRecord current = TimeRecord::getCurrentTime();
+    ssize_t newmemory = current.getMemUsed();
+    if (newmemory > memory) {
+      memory = newmemory;
+    }
+  }
+
+  void printMemoryUsage() const {
+    std::ostringstream formatted;
+    // Convert bytes to kilobytes
+    double mem = memory;
+    formatted << (mem / 1024);
+    errs() << formatted.str() << "\t - "
+           << "Memory used in KB\n";
+  }
+};
+
+/// The state of one instance of the analysis: its statistics, the pseudo
+/// edges of its dot graphs, its profile and its options. Each pass owns one
+/// and hands it to its graph, so that several analyses can run in the same
+/// process at once.
+class AnalysisContext {
+public:
+  /// The counters behind the statistics of the analysis. They only reach the
+  /// STATISTIC counters of LLVM through publishStatistics.
+  struct Statistics {
+    uint64_t usedBits{0};
+    uint64_t needBits{0};
+    uint64_t numSCCs{0};
+    uint64_t numAloneSCCs{0};
+    uint64_t sizeMaxSCC{0};
+    uint64_t numVars{0};
+    uint64_t numUnknown{0};
+    uint64_t numEmpty{0};
+    uint64_t numCPlusInf{0};
+    uint64_t numCC{0};
+    uint64_t numMinInfC{0};
+    uint64_t numMaxRange{0};
+    uint64_t numConstants{0};
+    uint64_t numZeroUses{0};
+    uint64_t numNotInt{0};
+    uint64_t numOps{0};
+    uint64_t numFoldedOps{0};
+    uint64_t numAliases{0};
+  };
+
+  Statistics stats;
+  // This map is used to store the number of times that the narrow_meet
+  // operator is called on a variable. It was a Fernando's suggestion.
+  DenseMap<const Value *, unsigned> FerMap;
+  // The pseudo edges of the constraint graphs, printed in their dot files.
+  std::string pseudoEdges;
+#ifdef STATS
+  Profile prof;
+#endif
+
+  // The number of threads that solve the components of a graph.
+  unsigned numThreads;
+  // The size from which a component is solved by all the threads together,
+  // or 0.
+  unsigned parallelSCCSize;
+  // Whether graphs are renumbered in the order of their components.
+  bool relayout;
+  // The largest number of rounds of the summary-based inter-procedural
+  // analysis.
+  unsigned summaryRounds;
+  // The total size of the callees it solves again in the context of a call,
+  // or 0.
+  unsigned contextBudget;
+  // Whether graphs are simplified before their components are searched.
+  bool simplify;
+  // The file where graphs are written before they are solved, or empty.
+  std::string graphFile;
+
+  /// Takes the options from the command line.
+  AnalysisContext();
+  ~AnalysisContext() = default;
+  AnalysisContext(const AnalysisContext &) = delete;
+  AnalysisContext(AnalysisContext &&) = delete;
+  AnalysisContext &operator=(const AnalysisContext &) = delete;
+  AnalysisContext &operator=(AnalysisContext &&) = delete;
+
+  /// Adds the statistics, the visits and the profile of other to this
+  /// context.
+  void merge(const AnalysisContext &other);
+  /// Adds the statistics gathered so far to the STATISTIC counters, and
+  /// starts counting again.
+  void publishStatistics();
+};
+
+// The VarNodes type.
+using VarNodes = DenseMap<const Value *, VarNode *>;
+
+// The Operations type.
+using GenOprs = SmallPtrSet<BasicOp *, 32>;
+
+// A map from variables to the operations where these variables are used.
+using UseMap = DenseMap<const Value *, SmallPtrSet<BasicOp *, 8>>;
+
+// A map from varnodes to the operation in which this variable is defined
+using DefMap = DenseMap<const Value *, BasicOp *>;
+
+using ValuesBranchMap = DenseMap<const Value *, ValueBranchMap>;
+
+using ValuesSwitchMap = DenseMap<const Value *, ValueSwitchMap>;
+
+/// The constants that the widening of a component may jump to. The constants
+/// of the whole graph are sorted once, at a common width, and a jump-set keeps
+/// the indices of the constants of its component in the same order, so the
+/// closest constant to a bound is found by binary search.
+class JumpSet {
+private:
+  // The sorted constants of the graph.
+  const SmallVectorImpl<APInt> *constants;
+  // The indices of the constants of the component, sorted.
+  SmallVector<unsigned, 16> indices;
+
+public:
+  explicit JumpSet(const SmallVectorImpl<APInt> *constants)
+      : constants(constants) {}
+
+  void clear() { indices.clear(); }
+  /// Adds the constant at index idx of the graph.
+  void add(unsigned idx) { indices.push_back(idx); }
+  /// Sorts the indices added and removes the duplicates.
+  void finish();
+  /// Returns the smallest constant greater than or equal to val, or the
+  /// largest value of the width of val if there is none.
+  APInt getFirstGreater(const APInt &val) const;
+  /// Returns the largest constant less than or equal to val, or the smallest
+  /// value of the width of val if there is none.
+  APInt getFirstLess(const APInt &val) const;
+};
+
+/// The scratch space of the thread solving a component. Besides the graph,
+/// which threads share, this is all the solving of a component writes to, so
+/// independent components can be solved at the same time, each one with the
+/// workspace of its thread. A workspace is reused from one component to the
+/// next, so it stops allocating once it has grown.
+struct ComponentWorkspace {
+  // The nodes of the component.
+  SmallPtrSet<VarNode *, 32> component;
+  // The nodes of the component in reverse postorder, and whether the node at
+  // each position is a cut point.
+  SmallVector<VarNode *, 0> nodes;
+  BitVector cutPoints;
+  // The scratch space of the search that orders the nodes.
+  SmallVector<unsigned, 0> roots;
+  SmallVector<std::pair<VarNode *, unsigned>, 0> frames;
+  SmallVector<VarNode *, 0> backEdgeTargets;
+  // The constants of the component.
+  JumpSet jumpset;
+  // The crop that last visited each node of the graph. Every crop takes a new
+  // epoch, so the marks never have to be cleared.
+  SmallVector<unsigned, 0> cropEpochs;
+  unsigned cropEpoch = 0;
+  // The operations waiting to be cropped.
+  SmallVector<BasicOp *, 8> cropWorklist;
+
+  explicit ComponentWorkspace(const SmallVectorImpl<APInt> *constants)
+      : jumpset(constants) {}
+};
+
+/// A view of the use lists of the nodes of one strongly connected component,
+/// keeping only the operations whose sink is in the component as well. The
+/// view walks the use lists of the graph and skips the operations whose sink
+/// has another component id, so it copies nothing. The nodes of the component
+/// are ordered by their position, which follows a reverse postorder of the
+/// component. The targets of the back edges of that order are the cut points
+/// of the component: every cycle goes through one of them.
+class ComponentUseMap {
+private:
+  // The operations of the graph and the use lists of its nodes.
+  ArrayRef<BasicOp *> ops;
+  ArrayRef<unsigned> useBegin;
+  ArrayRef<unsigned> useOps;
+  // The component of each node of the graph, and the one of this view.
+  ArrayRef<unsigned> sccIds;
+  unsigned scc;
+  // The position of each node of the graph in the component. Only the entries
+  // of the nodes of the component are meaningful.
+  ArrayRef<unsigned> position;
+  // The workspace where the nodes of the component are ordered.
+  ComponentWorkspace *workspace;
+
+  bool inComponent(unsigned op) const {
+    return sccIds[ops[op]->getSink()->getId()] == scc;
+  }
+
+public:
+  /// Iterates over the operations of the component where a node is used.
+  class use_iterator
+      : public iterator_facade_base<use_iterator, std::forward_iterator_tag,
+                                    BasicOp *const> {
+  private:
+    const ComponentUseMap *map;
+    const unsigned *it;
+    const unsigned *end;
+
+    void skip() {
+      while (it != end && !map->inComponent(*it)) {
+        ++it;
+      }
+    }
+
+  public:
+    use_iterator(const ComponentUseMap *map, const unsigned *it,
+                 const unsigned *end)
+        : map(map), it(it), end(end) {
+      skip();
+    }
+    bool operator==(const use_iterator &other) const { return it == other.it; }
+    BasicOp *const &operator*() const { return map->ops[*it]; }
+    use_iterator &operator++() {
+      ++it;
+      skip();
+      return *this;
+    }
+  };
+
+  ComponentUseMap(ArrayRef<BasicOp *> ops, ArrayRef<unsigned> useBegin,
+                  ArrayRef<unsigned> useOps, ArrayRef<unsigned> sccIds,
+                  unsigned scc, ArrayRef<unsigned> position,
+                  ComponentWorkspace *workspace)
+      : ops(ops), useBegin(useBegin), useOps(useOps), sccIds(sccIds), scc(scc),
+        position(position), workspace(workspace) {}
+
+  /// Returns whether V is a cut point of the component.
+  bool isCutPoint(const VarNode *V) const {
+    return workspace->cutPoints[position[V->getId()]];
+  }
+
+  /// Returns the operations of the component where V is used.
+  iterator_range<use_iterator> getUses(const VarNode *V) const {
+    const unsigned *first = useOps.begin() + useBegin[V->getId()];
+    const unsigned *last = useOps.begin() + useBegin[V->getId() + 1];
+    return make_range(use_iterator(this, first, last),
+                      use_iterator(this, last, last));
+  }
+  /// Returns the number of nodes of the component.
+  unsigned size() const { return workspace->nodes.size(); }
+  /// Returns the position of V in the component.
+  unsigned getPosition(const VarNode *V) const { return position[V->getId()]; }
+  /// Returns the node at position pos of the component.
+  VarNode *getNode(unsigned pos) const { return workspace->nodes[pos]; }
+  /// Returns the workspace of the thread solving the component.
+  ComponentWorkspace &getWorkspace() const { return *workspace; }
+  /// Returns the constants of the component.
+  const JumpSet *getJumpSet() const { return &workspace->jumpset; }
+};
+
+/// The nodes of a component that still have to be visited by the fixed point
+/// iteration. The node with the lowest position in the component is taken
+/// first, so nodes are visited in reverse postorder, after the nodes they
+/// depend on, instead of in hash order.
+class ActiveVars {
+private:
+  const ComponentUseMap *compUseMap;
+  // The positions of the nodes in the list, as a min-heap.
+  SmallVector<unsigned, 32> heap;
+  BitVector inList;
+
+public:
+  explicit ActiveVars(const ComponentUseMap &compUseMap)
+      : compUseMap(&compUseMap), inList(compUseMap.size()) {}
+
+  bool empty() const { return heap.empty(); }
+  /// Adds V to the list, unless it is there already.
+  void insert(VarNode *V) {
+    const unsigned pos = compUseMap->getPosition(V);
+    if (!inList[pos]) {
+      inList.set(pos);
+      heap.push_back(pos);
+      std::push_heap(heap.begin(), heap.end(), std::greater<unsigned>());
+    }
+  }
+  /// Removes the node with the lowest position from the list and returns it.
+  VarNode *pop() {
+    std::pop_heap(heap.begin(), heap.end(), std::greater<unsigned>());
+    const unsigned pos = heap.pop_back_val();
+    inList.reset(pos);
+    return compUseMap->getNode(pos);
+  }
+  void clear() {
+    heap.clear();
+    inList.reset();
+  }
+};
+
+/// A file of constraint graphs, mapped in memory. ConstraintGraph::write
+/// adds a graph to a file as a record, and ConstraintGraph::read builds the
+/// graph back from it, without the program it came from. All the fields are
+/// little-endian, and every section of a record starts 8 bytes aligned:
+///
+///   Header, the name, the nodes, the operations, the sources of the
+///   operations, the use lists and the bound lists in compressed sparse row
+///   form, and the words of the bounds of the ranges.
+///
+/// Opcodes and predicates are those of the LLVM the file was written with.
+class GraphFile {
+public:
+  using Word32 = support::ulittle32_t;
+  using Word64 = support::ulittle64_t;
+
+  /// Bumped whenever the layout of a record changes.
+  static const unsigned Version = 1;
+  static const char Magic[8];
+
+  struct Header {
+    char magic[8];
+    Word32 version;
+    Word32 nameSize;
+    // The size of the whole record, header included.
+    Word64 size;
+    Word32 numNodes;
+    Word32 numOps;
+    Word32 numSources;
+    Word32 numUses;
+    Word32 numSymbUses;
+    Word32 numWords;
+  };
+  /// A range, whose lower bound takes the words from words on, and whose
+  /// upper bound the next ones.
+  struct RangeRecord {
+    Word32 bitwidth;
+    Word32 type;
+    Word32 words;
+  };
+  struct NodeRecord {
+    enum { ConstantFlag = 1 };
+    Word32 flags;
+    // The operation which defines the node, or ~0.
+    Word32 defOp;
+    // The range of the node before the graph is solved.
+    RangeRecord range;
+  };
+  struct OpRecord {
+    enum { UnresolvedFlag = 1, SymbolicFlag = 2 };
+    Word32 kind;
+    Word32 flags;
+    Word32 opcode;
+    Word32 sink;
+    // The sources are sources[sourceBegin] up to sources[sourceBegin +
+    // numSources].
+    Word32 sourceBegin;
+    Word32 numSources;
+    // The node which bounds a symbolic intersect and its predicate, if any.
+    Word32 bound;
+    Word32 predicate;
+    RangeRecord intersect;
+  };
+
+  /// The sections of a record, pointing into the mapped file.
+  struct Record {
+    StringRef name;
+    ArrayRef<NodeRecord> nodes;
+    ArrayRef<OpRecord> ops;
+    ArrayRef<Word32> sources;
+    ArrayRef<Word32> useBegin;
+    ArrayRef<Word32> useOps;
+    ArrayRef<Word32> symbBegin;
+    ArrayRef<Word32> symbOps;
+    ArrayRef<Word64> words;
+  };
+
+private:
+  std::unique_ptr<sys::fs::mapped_file_region> region;
+  SmallVector<Record, 1> records;
+
+  explicit GraphFile(std::unique_ptr<sys::fs::mapped_file_region> region)
+      : region(std::move(region)) {}
+  /// Splits the mapped file into records. Returns false if it is malformed.
+  bool parse();
+
+public:
+  /// Maps the file FileName and checks the layout of its records. Returns
+  /// null, after an error message, if it cannot.
+  static std::unique_ptr<GraphFile> open(const std::string &FileName);
+  /// Returns the size of a record with the counts of H, rounding each
+  /// section up to 8 bytes.
+  static uint64_t getRecordSize(const Header &H);
+  unsigned size() const { return records.size(); }
+  const Record &getRecord(unsigned i) const { return records[i]; }
+};
+
+class Nuutila;
+
+/// This class represents our constraint graph. This graph is used to
+/// perform all computations in our analysis.
+class ConstraintGraph {
+protected:
+  // The state of the analysis which owns the graph.
+  AnalysisContext &ctx;
+
+  // The variables of the source program and the nodes which represent them.
+  VarNodes vars;
+  // The operations of the source program and the nodes which represent them.
+  GenOprs oprs;
+
+  // The arena where nodes, operations and intervals are allocated. clear()
+  // runs their destructors and resets it, so the next function analyzed
+  // reuses the memory.
+  BumpPtrAllocator arena;
+  // The arenas of the graphs added to this one, which hold some of its nodes
+  // and operations.
+  std::vector<BumpPtrAllocator> adoptedArenas;
+  // The intervals allocated in the arena. Operations need no destructor, so
+  // they are not tracked.
+  SmallVector<BasicInterval *, 0> arenaIntervals;
+
+  // The ranges of the variables, indexed by the ids of their nodes.
+  BoundsTable bounds;
+  // The nodes of the graph, indexed by their ids.
+  SmallVector<VarNode *, 0> nodes;
+
+  // The finalized form of the graph, built from the maps below once the
+  // construction is done. Operations are numbered densely, and the use and
+  // bound lists are kept in compressed sparse row form: the uses of node n
+  // are useOps[useBegin[n]] up to useOps[useBegin[n + 1]].
+  SmallVector<BasicOp *, 0> ops;
+  // The operation which defines each node, or NoOp.
+  SmallVector<unsigned, 0> defOp;
+  SmallVector<unsigned, 0> useBegin;
+  SmallVector<unsigned, 0> useOps;
+  // The operations whose intersect is bounded by each node.
+  SmallVector<unsigned, 0> symbBegin;
+  SmallVector<unsigned, 0> symbOps;
+  // The position of each node in its component. Components write only the
+  // entries of their own nodes.
+  SmallVector<unsigned, 0> compPosition;
+  // The workspaces of the threads solving the components. They are kept for
+  // the next graph built.
+  SmallVector<std::unique_ptr<ComponentWorkspace>, 1> workspaces;
+#ifdef STATS
+  // The number of times the narrowing visited each node.
+  SmallVector<unsigned, 0> narrowVisits;
+#endif
+
+  static const unsigned NoOp = ~0U;
+
+  /// Folds the operations on fixed ranges and the copies out of the maps.
+  void simplify();
+  /// Builds the finalized form of the graph from the maps.
+  void finalize();
+
+private:
+  // Save the last Function analyzed
+  const Function *func{nullptr};
+  // The name of the graph in graph files: the function or the module it was
+  // built from.
+  std::string name;
+  // A map from variables to the operations that define them
+  DefMap defMap;
+  // A map from variables to the operations where these variables are used.
+  UseMap useMap;
+  // This data structure is used to store intervals, basic blocks and intervals
+  // obtained in the branches.
+  ValuesBranchMap valuesBranchMap;
+  ValuesSwitchMap valuesSwitchMap;
+  // The sigmas met while the graph is built. Their operations are created
+  // once the branches and switches which constrain them have been seen.
+  SmallVector<const PHINode *, 0> pendingSigmas;
+
+  // The constants of the graph used by the jump-set widening, sorted at the
+  // width of the widest of them, without duplicates.
+  SmallVector<APInt, 0> thresholds;
+  // The indices of the constants contributed by each node: its own value, if
+  // it is a constant, and the constant sources of its definition.
+  SmallVector<unsigned, 0> thresholdBegin;
+  SmallVector<unsigned, 0> thresholdIdx;
+  // The bound of the intersect of each operation added by addOp, or null.
+  SmallVector<VarNode *, 0> addedBounds;
+  // Prints the graph after each step of the solver, if it is set.
+  void (*stepPrinter)(const ConstraintGraph &G, StringRef step){nullptr};
+
+  // The members below build the graph from the IR of a program. They are
+  // defined with the pass, in RangeAnalysis.cpp.
+
+  /// Adds a BinaryOp in the graph.
+  void addBinaryOp(const Instruction *I);
+  /// Adds a TernaryOp in the graph.
+  void addTernaryOp(const Instruction *I);
+  /// Adds a PhiOp in the graph.
+  void addPhiOp(const PHINode *Phi);
+  // Adds the nodes of a sigma to the graph. Its SigmaOp is added later.
+  void addSigmaOp(const PHINode *Sigma);
+  // Adds the SigmaOp of a sigma, once the value maps are complete.
+  void buildSigmaOp(const PHINode *Sigma);
+
+  // Creates varnodes for all operands of I that are constants
+  // void createNodesForConstants(const Instruction *I);
+
+  /// Takes an instruction and creates an operation.
+  void buildOperations(const Instruction *I);
+  void buildValueBranchMap(const BranchInst *br);
+  void buildValueSwitchMap(const SwitchInst *sw);
+  /// Adds the edges from the bounds of symbolic intervals to the pseudo
+  /// edges of the context, printed in the dot file of the graph.
+  void addPseudoEdges() const;
+  /// Prints the graph to the dot file of step in /tmp.
+  static void printStep(const ConstraintGraph &G, StringRef step);
+
+  //	void clearValueMaps();
+
+  /// Builds the sorted constants of the graph and the lists of each node.
+  void buildThresholds();
+  /// Returns the index of the constant C in thresholds.
+  unsigned getThresholdIndex(const APInt &C) const;
+  void buildConstantVector(const SmallPtrSet<VarNode *, 32> &component,
+                           const ComponentUseMap &compusemap);
+  /// Returns the workspace of thread i, creating it if needed.
+  ComponentWorkspace &getWorkspace(unsigned i);
+  /// Solves the component scc of sccList in workspace ws, and propagates its
+  /// ranges to the next components.
+  void solveComponent(const Nuutila &sccList, unsigned scc,
+                      ComponentWorkspace &ws);
+  void solveSingleton(unsigned id);
+  /// Renumbers the nodes and operations in the order of the components of
+  /// sccList, and sccList with them.
+  void relayout(Nuutila &sccList);
+  /// Creates an operation of kind kind, which is not inserted in the graph.
+  /// Returns null if it cannot have sources as sources, or if the widths of
+  /// its sink, sources and intersect do not match.
+  BasicOp *createOpOfKind(BasicOp::OperationId kind, unsigned opcode,
+                          VarNode *sink, ArrayRef<VarNode *> sources,
+                          BasicInterval *intersect);
+  /// Reads a range stored in a graph file. Returns false if its width is not
+  /// the width of an integer, or if its words are not in words.
+  static bool readRange(const GraphFile::RangeRecord &RR,
+                        ArrayRef<GraphFile::Word64> words, Range &R);
+  /// Solves the components of sccList with numThreads threads.
+  unsigned solveComponentsInParallel(const Nuutila &sccList,
+                                     unsigned numThreads);
+  // Perform the widening and narrowing operations
+
+protected:
+  void update(const ComponentUseMap &compUseMap, ActiveVars &actv,
+              bool (*meet)(BasicOp *op, const JumpSet *jumpset));
+  void update(unsigned nIterations, const ComponentUseMap &compUseMap,
+              ActiveVars &actv);
+  void updateAtCutPoints(
+      const ComponentUseMap &compUseMap, ActiveVars &actv,
+      bool (*meet)(BasicOp *op, const JumpSet *jumpset));
+  /// Runs update, or updateAtCutPoints if atCutPoints is set, with several
+  /// threads on a large component.
+  void updateInParallel(const ComponentUseMap &compUseMap, ActiveVars &actv,
+                        bool (*meet)(BasicOp *op, const JumpSet *jumpset),
+                        bool atCutPoints);
+
+  virtual void preUpdate(const ComponentUseMap &compUseMap,
+                         ActiveVars &entryPoints) = 0;
+  virtual void posUpdate(const ComponentUseMap &compUseMap,
+                         ActiveVars &activeVars,
+                         const SmallPtrSet<VarNode *, 32> *component,
+                         ArrayRef<unsigned> componentOps) = 0;
+
+public:
+  /// I'm doing this because I want to use this analysis in an
+  /// inter-procedural pass. So, I have to receive these data structures as
+  // parameters.
+  explicit ConstraintGraph(AnalysisContext &ctx) : ctx(ctx) {}
+  virtual ~ConstraintGraph();
+  ConstraintGraph(const ConstraintGraph &) = delete;
+  ConstraintGraph(ConstraintGraph &&) = delete;
+  ConstraintGraph &operator=(const ConstraintGraph &) = delete;
+  ConstraintGraph &operator=(ConstraintGraph &&) = delete;
+  /// Returns the state of the analysis which owns the graph.
+  AnalysisContext &getContext() const { return ctx; }
+  /// Creates an operation in the arena of the graph. It still has to be
+  /// inserted in the maps of the graph.
+  template <class OpT, class... Args> OpT *createOp(Args &&... args) {
+    return new (arena.Allocate<OpT>()) OpT(std::forward<Args>(args)...);
+  }
+  /// Creates a phi operation with room for numSources sources.
+  PhiOp *createPhiOp(BasicInterval *intersect, VarNode *sink,
+                     const Instruction *inst, unsigned numSources) {
+    const VarNode **sources = arena.Allocate<const VarNode *>(numSources);
+    return createOp<PhiOp>(intersect, sink, inst, sources, numSources);
+  }
+  /// Creates an interval in the arena of the graph.
+  template <class ItvT, class... Args> ItvT *createInterval(Args &&... args) {
+    ItvT *itv = new (arena.Allocate<ItvT>()) ItvT(std::forward<Args>(args)...);
+    arenaIntervals.push_back(itv);
+    return itv;
+  }
+
+  GenOprs *getOprs() { return &oprs; }
+  DefMap *getDefMap() { return &defMap; }
+  UseMap *getUseMap() { return &useMap; }
+  /// Returns the number of nodes of the graph.
+  unsigned getNumNodes() const { return nodes.size(); }
+  /// Returns the node id.
+  VarNode *getNode(unsigned id) const { return nodes[id]; }
+  /// Returns the number of operations of the graph.
+  unsigned getNumOps() const { return ops.size(); }
+  /// Returns the operation id. Operations are numbered by finalize().
+  BasicOp *getOp(unsigned id) const { return ops[id]; }
+  /// Returns the operations where node id is used.
+  ArrayRef<unsigned> getUses(unsigned id) const {
+    return makeArrayRef(useOps).slice(useBegin[id],
+                                      useBegin[id + 1] - useBegin[id]);
+  }
+  /// Returns the operations whose intersect is bounded by node id.
+  ArrayRef<unsigned> getSymbUses(unsigned id) const {
+    return makeArrayRef(symbOps).slice(symbBegin[id],
+                                       symbBegin[id + 1] - symbBegin[id]);
+  }
+  ComponentUseMap buildUseMap(const Nuutila &sccList, unsigned scc,
+                              ComponentWorkspace &ws);
+  /// Evaluates the operations where the nodes of component are used. The
+  /// nodes are taken in the order of their component, which does not depend
+  /// on their addresses, since the result depends on that order.
+  void propagateToNextSCC(ArrayRef<unsigned> component);
+
+  /// Finds the intervals of the variables in a graph already finalized,
+  /// such as one read from a graph file.
+  void solve();
+  void generateEntryPoints(ArrayRef<unsigned> component,
+                           ActiveVars &entryPoints);
+  void fixIntersects(SmallPtrSet<VarNode *, 32> &component);
+  void generateActivesVars(SmallPtrSet<VarNode *, 32> &component,
+                           ActiveVars &activeVars);
+
+  /// Releases the nodes and operations of the graph. The memory is kept for
+  /// the next graph built.
+  void clear();
+  const std::string &getName() const { return name; }
+  void setName(StringRef newName) { this->name = newName.str(); }
+  /// Writes the finalized graph to OS as a record of a graph file, with the
+  /// ranges its nodes have now.
+  void write(raw_ostream &OS) const;
+  /// Builds the graph R of a graph file, finalized, in this graph, which has
+  /// to be empty. Its nodes and operations have no value nor instruction.
+  /// Returns false, after an error message, if R is inconsistent.
+  bool read(const GraphFile::Record &R);
+
+  // The members below build a graph without a program, node by node. The
+  // graph has to be empty, and its nodes have no value nor instruction.
+
+  /// Adds a node whose range is R. A constant node keeps its range.
+  VarNode *addNode(const Range &R, bool constant = false);
+  /// Adds an operation of kind kind, which defines sink from sources. Its
+  /// intersect is intersect, or, if bound is given, the symbolic interval
+  /// which compares with bound through pred, and is R until it is fixed. Only
+  /// unary operations and sigmas may have a bound. opcode is the opcode of
+  /// the instruction of unary and binary operations. Returns null if the
+  /// operation cannot have sources as sources, or if the widths of sink,
+  /// sources and intersect do not match.
+  BasicOp *addOp(BasicOp::OperationId kind, unsigned opcode, VarNode *sink,
+                 ArrayRef<VarNode *> sources, const Range &intersect,
+                 VarNode *bound = nullptr,
+                 CmpInst::Predicate pred = CmpInst::BAD_ICMP_PREDICATE);
+  /// Finalizes the graph built by addNode and addOp, which can then be
+  /// solved.
+  void finishBuild();
+
+  // The members below build the graph from the IR of a program, and report
+  // its ranges. They are defined with the pass, in RangeAnalysis.cpp.
+
+  /// Adds a VarNode in the graph.
+  VarNode *addVarNode(const Value *V);
+  /// Adds an UnaryOp to the graph.
+  void addUnaryOp(const Instruction *I);
+  /// Iterates through all instructions in the function and builds the graph.
+  void buildGraph(const Function &F);
+  /// Takes the nodes and operations of G, which has not been finalized, as
+  /// if G had been built into this graph. G is left empty.
+  void addGraph(ConstraintGraph &G);
+  void buildVarNodes();
+  /// Finds the intervals of the variables in the graph.
+  void findIntervals();
+  /// Prints the content of the graph in dot format. For more informations
+  /// about the dot format, see: http://www.graphviz.org/pdf/dotguide.pdf
+  void print(const Function &F, raw_ostream &OS) const;
+  void printToFile(const Function &F, const std::string &FileName) const;
+  /// Allow easy printing of graphs from the debugger.
+  void dump(const Function &F) const {
+    print(F, dbgs());
+    dbgs() << '\n';
+  };
+  void printResultIntervals();
+  void computeStats();
+  Range getRange(const Value *v);
+  /// Returns the range of v when no graph has a node for it.
+  static Range getUncoveredRange(const Value *v);
+  /// Adds the ranges of the arguments and instructions of the graph to
+  /// ranges.
+  void collectRanges(DenseMap<const Value *, Range> &ranges) const;
+};
+
+class Cousot : public ConstraintGraph {
+private:
+  void preUpdate(const ComponentUseMap &compUseMap,
+                 ActiveVars &entryPoints) override;
+  void posUpdate(const ComponentUseMap &compUseMap, ActiveVars &entryPoints,
+                 const SmallPtrSet<VarNode *, 32> *component,
+                 ArrayRef<unsigned> componentOps) override;
+
+public:
+  explicit Cousot(AnalysisContext &ctx) : ConstraintGraph(ctx) {}
+};
+
+class CropDFS : public ConstraintGraph {
+private:
+  void preUpdate(const ComponentUseMap &compUseMap,
+                 ActiveVars &entryPoints) override;
+  void posUpdate(const ComponentUseMap &compUseMap, ActiveVars &activeVars,
+                 const SmallPtrSet<VarNode *, 32> *component,
+                 ArrayRef<unsigned> componentOps) override;
+  void storeAbstractStates(const SmallPtrSet<VarNode *, 32> &component);
+  void crop(const ComponentUseMap &compUseMap, BasicOp *op);
+
+public:
+  explicit CropDFS(AnalysisContext &ctx) : ConstraintGraph(ctx) {}
+};
+
+/// Finds the strongly connected components of a finalized constraint graph
+/// with Nuutila's algorithm. A node is linked to the sinks of the operations
+/// where it is used and to the sinks of the operations whose intersect it
+/// bounds, so that futures are solved before the intervals that use them.
+/// The search keeps its own stack and works on node ids, so deep graphs do
+/// not overflow the call stack.
+class Nuutila {
+private:
+  // The ids of the nodes of each component, one component after the other.
+  SmallVector<unsigned, 0> members;
+  // Where each component starts in members, plus the end of the last one.
+  SmallVector<unsigned, 0> compBegin;
+  // The ids of the operations whose sink is in each component, in the order
+  // of the components, and where each component starts in compOps.
+  SmallVector<unsigned, 0> compOps;
+  SmallVector<unsigned, 0> opBegin;
+
+  // The component of each node.
+  SmallVector<unsigned, 0> componentOf;
+
+  void findComponents(const ConstraintGraph &G);
+  void bucketOperations(const ConstraintGraph &G);
+#ifdef SCC_DEBUG
+  bool checkComponents(const ConstraintGraph &G);
+  bool checkTopologicalSort(const ConstraintGraph &G);
+#endif
+public:
+  Nuutila(const ConstraintGraph &G, bool single = false);
+  ~Nuutila() = default;
+  Nuutila(const Nuutila &) = delete;
+  Nuutila(Nuutila &&) = delete;
+  Nuutila &operator=(const Nuutila &) = delete;
+  Nuutila &operator=(Nuutila &&) = delete;
+
+  /// Returns the number of components.
+  unsigned size() const { return compBegin.size() - 1; }
+  /// Returns the ids of the nodes of the component c. Components are
+  /// numbered in topological order.
+  ArrayRef<unsigned> getComponent(unsigned c) const {
+    return makeArrayRef(members).slice(compBegin[c],
+                                       compBegin[c + 1] - compBegin[c]);
+  }
+  /// Returns the component of each node, by node id.
+  ArrayRef<unsigned> getComponentIds() const { return componentOf; }
+  /// Returns the ids of the operations whose sink is in the component c,
+  /// in increasing order.
+  ArrayRef<unsigned> getComponentOps(unsigned c) const {
+    return makeArrayRef(compOps).slice(opBegin[c], opBegin[c + 1] - opBegin[c]);
+  }
+  /// Updates the ids after the graph renumbered its nodes, giving node id
+  /// the id newIds[id], and its operations in the order of compOps.
+  void renumber(ArrayRef<unsigned> newIds);
+};
+
+/// The order in which the components of a graph have to be solved when they
+/// are solved in parallel. Solving a component also evaluates the operations
+/// where its nodes are used, so two components may touch the same node or
+/// interval even when no path links them. Such components are ordered as in
+/// the sequential solver, by increasing number; the others are independent.
+/// Every schedule that respects this order therefore gives the same ranges as
+/// solving the components one after the other.
+class ComponentDAG {
+private:
+  // The number of components each component waits for.
+  SmallVector<unsigned, 0> numPreds;
+  // The components waiting for each component, in compressed sparse row form.
+  SmallVector<unsigned, 0> succBegin;
+  SmallVector<unsigned, 0> succs;
+
+public:
+  ComponentDAG(const ConstraintGraph &G, const Nuutila &sccList);
+
+  /// Returns the number of components component c waits for.
+  unsigned getNumPredecessors(unsigned c) const { return numPreds[c]; }
+  /// Returns the components waiting for component c.
+  ArrayRef<unsigned> getSuccessors(unsigned c) const {
+    return makeArrayRef(succs).slice(succBegin[c],
+                                     succBegin[c + 1] - succBegin[c]);
+  }
+};
+
+class Meet {
+
+public:
+  static bool widen(BasicOp *op, const JumpSet *jumpset);
+  static bool narrow(BasicOp *op, const JumpSet *jumpset);
+  static bool crop(BasicOp *op, const JumpSet *jumpset);
+  static bool growth(BasicOp *op, const JumpSet *jumpset);
+  static bool fixed(BasicOp *op, const JumpSet *jumpset);
+};
+} // namespace RangeAnalysis
+#endif // _RANGEANALYSIS_CONSTRAINTGRAPH_H
@@ -15,15 +15,20 @@
 #include "RangeAnalysis.h"
 
 #include <stdint.h>
+#include <algorithm>
 #include <cassert>
+#include <condition_variable>
 #include <iterator>
+#include <mutex>
 #include <string>
 #include <system_error>
+#include <thread>
+#include <type_traits>
 
 #include "llvm/ADT/APInt.h"
+#include "llvm/ADT/BitVector.h"
 #include "llvm/ADT/ilist_iterator.h"
 #include "llvm/ADT/iterator.h"
-#include "llvm/ADT/Statistic.h"
 #include "llvm/IR/Argument.h"
 #include "llvm/IR/CallSite.h"
 #include "llvm/IR/ConstantRange.h"
@@ -39,74 +44,88 @@
 #include "llvm/IR/Value.h"
 #include "llvm/PassAnalysisSupport.h"
 #include "llvm/PassSupport.h"
+#include "llvm/Support/CommandLine.h"
 #include "llvm/Support/FileSystem.h"
-
-int __builtin_clz(unsigned int);
-
-#define DEBUG_TYPE "range-analysis"
+#include "llvm/Support/MathExtras.h"
 
 namespace RangeAnalysis {
 
 using namespace llvm;
 
-// These macros are used to get stats regarding the precision of our analysis.
-STATISTIC(usedBits, "Initial number of bits.");
-STATISTIC(needBits, "Needed bits.");
-STATISTIC(percentReduction, "Percentage of reduction of the number of bits.");
-STATISTIC(numSCCs, "Number of strongly connected components.");
-STATISTIC(numAloneSCCs, "Number of SCCs containing only one node.");
-STATISTIC(sizeMaxSCC, "Size of largest SCC.");
-STATISTIC(numVars, "Number of variables");
-STATISTIC(numUnknown, "Number of unknown variables");
-STATISTIC(numEmpty, "Number of empty-set variables");
-STATISTIC(numCPlusInf, "Number of variables [c, +inf].");
-STATISTIC(numCC, "Number of variables [c, c].");
-STATISTIC(numMinInfC, "Number of variables [-inf, c].");
-STATISTIC(numMaxRange, "Number of variables [-inf, +inf].");
-STATISTIC(numConstants, "Number of constants.");
-STATISTIC(numZeroUses, "Number of variables without any use.");
-STATISTIC(numNotInt, "Number of variables that are not Integer.");
-STATISTIC(numOps, "Number of operations");
-STATISTIC(maxVisit, "Max number of times a value has been visited.");
-
 namespace {
-// The number of bits needed to store the largest variable of the function
-// (APInt).
-unsigned MAX_BIT_INT = 1;
-
-// This map is used to store the number of times that the narrow_meet
-// operator is called on a variable. It was a Fernando's suggestion.
-// TODO(vhscampos): remove this
-DenseMap<const Value *, unsigned> FerMap;
 
 // ========================================================================== //
 // Static global functions and definitions
 // ========================================================================== //
 
-APInt Min, Max, Zero, One;
-
 // String used to identify sigmas
 // IMPORTANT: the range-analysis identifies sigmas by comparing
 // to this hard-coded instruction name prefix.
 // TODO(vhscampos): remove this as we will migrate to PredicateInfo
 const std::string sigmaString = "vSSA_sigma";
 
-// Used to print pseudo-edges in the Constraint Graph dot
-std::string pestring;
-raw_string_ostream pseudoEdgesString(pestring);
+/// Appends the record of a graph to the file FileName. The first record of
+/// the process truncates the file. Records are written whole, one thread at
+/// a time, in the order their graphs are solved.
+void appendGraphRecord(const std::string &FileName, StringRef record) {
+  static std::mutex lock;
+  // The files opened so far, or null for those which could not be
+  static StringMap<std::unique_ptr<raw_fd_ostream>> files;
 
-#ifdef STATS
-// Used to profile
-Profile prof;
-#endif
+  std::lock_guard<std::mutex> guard(lock);
+  auto inserted = files.try_emplace(FileName);
+  std::unique_ptr<raw_fd_ostream> &file = inserted.first->second;
+  if (inserted.second) {
+    std::error_code ErrorInfo;
+    file = std::make_unique<raw_fd_ostream>(FileName, ErrorInfo,
+                                            sys::fs::F_None);
+    if (ErrorInfo) {
+      errs() << "ERROR: file " << FileName << " can't be opened!\n";
+      file->clear_error();
+      file.reset();
+    }
+  }
+  if (file) {
+    *file << record;
+    file->flush();
+  }
+}
+
+/// Creates the contexts of numThreads threads which solve graphs of their
+/// own. Each solves its graphs alone.
+SmallVector<std::unique_ptr<AnalysisContext>, 0>
+createThreadContexts(unsigned numThreads) {
+  SmallVector<std::unique_ptr<AnalysisContext>, 0> contexts;
+  for (unsigned i = 0; i < numThreads; ++i) {
+    contexts.push_back(std::make_unique<AnalysisContext>());
+    contexts.back()->numThreads = 1;
+  }
+  return contexts;
+}
 
 // Print name of variable according to its type
 void printVarName(const Value *V, raw_ostream &OS) {
   const Argument *A = nullptr;
   const Instruction *I = nullptr;
+  const ReturnInst *RI = nullptr;
 
   if ((A = dyn_cast<Argument>(V)) != nullptr) {
     OS << A->getParent()->getName() << "." << A->getName();
+  } else if ((RI = dyn_cast<ReturnInst>(V)) != nullptr) {
+    // The node where the return values of a function meet has no name of
+    // its own. It is named after the position of its return among the
+    // returns of the function.
+    const Function *F = RI->getParent()->getParent();
+    unsigned n = 0;
+    for (const BasicBlock &BB : *F) {
+      if (BB.getTerminator() == RI) {
+        break;
+      }
+      if (isa<ReturnInst>(BB.getTerminator())) {
+        ++n;
+      }
+    }
+    OS << F->getName() << ".ret." << n;
   } else if ((I = dyn_cast<Instruction>(V)) != nullptr) {
     OS << I->getParent()->getParent()->getName() << "."
        << I->getParent()->getName() << "." << I->getName();
@@ -144,80 +163,96 @@ bool isValidInstruction(const Instruction *I) {
 } // end anonymous namespace
 
 // ========================================================================== //
-// RangeAnalysis
+// FunctionRanges
 // ========================================================================== //
-unsigned RangeAnalysis::getMaxBitWidth(const Function &F) {
-  unsigned int InstBitSize = 0, opBitSize = 0, max = 0;
+void FunctionRanges::reset(ArrayRef<const Function *> functions) {
+  functionIds.clear();
+  ranges.clear();
+  ranges.resize(functions.size());
+  for (unsigned f = 0, e = functions.size(); f < e; ++f) {
+    functionIds[functions[f]] = f;
+  }
+}
 
-  // Obtains the maximum bit width of the instructions of the function.
-  for (const Instruction &I : instructions(F)) {
-    InstBitSize = I.getType()->getPrimitiveSizeInBits();
-    if (I.getType()->isIntegerTy() && InstBitSize > max) {
-      max = InstBitSize;
-    }
+Range FunctionRanges::getRange(const Value *v) const {
+  const Function *F = nullptr;
+  if (const Argument *A = dyn_cast<Argument>(v)) {
+    F = A->getParent();
+  } else if (const Instruction *I = dyn_cast<Instruction>(v)) {
+    F = I->getFunction();
+  }
 
-    // Obtains the maximum bit width of the operands of the instruction.
-    for (const Value *operand : I.operands()) {
-      opBitSize = operand->getType()->getPrimitiveSizeInBits();
-      if (operand->getType()->isIntegerTy() && opBitSize > max) {
-        max = opBitSize;
-      }
+  auto fit = functionIds.find(F);
+  if (fit != functionIds.end()) {
+    const DenseMap<const Value *, Range> &functionRanges = ranges[fit->second];
+    auto rit = functionRanges.find(v);
+    if (rit != functionRanges.end()) {
+      return rit->second;
     }
   }
+  return ConstraintGraph::getUncoveredRange(v);
+}
 
-  // Bitwidth equal to 0 is not valid, so we increment to 1
-  if (max == 0) {
-    ++max;
+// ========================================================================== //
+// RangeAnalysis
+// ========================================================================== //
+unsigned RangeAnalysis::getBitWidth(const Value *V) {
+  // The return values of a function meet in the node of its first return
+  // instruction.
+  if (const ReturnInst *RI = dyn_cast<ReturnInst>(V)) {
+    if (RI->getReturnValue() != nullptr) {
+      return getBitWidth(RI->getReturnValue());
+    }
   }
 
-  return max;
-}
+  Type *Ty = V->getType();
 
-void RangeAnalysis::updateConstantIntegers(unsigned maxBitWidth) {
-  // Updates the Min and Max values.
-  Min = APInt::getSignedMinValue(maxBitWidth);
-  Max = APInt::getSignedMaxValue(maxBitWidth);
-  Zero = APInt(MAX_BIT_INT, 0UL, true);
-  One = APInt(MAX_BIT_INT, 1UL, true);
+  // Values that are not integers only reach the graph through parameter and
+  // return value matching, where they are never evaluated.
+  return Ty->isIntegerTy() ? Ty->getIntegerBitWidth() : 1;
 }
 
-// unsigned RangeAnalysis::getBitWidth() {
-//	return MAX_BIT_INT;
-//}
-
 // ========================================================================== //
 // IntraProceduralRangeAnalysis
 // ========================================================================== //
 template<class CGT>
 char IntraProceduralRA<CGT>::ID = 0;
 
-template <class CGT> APInt IntraProceduralRA<CGT>::getMin() { return Min; }
+template <class CGT>
+APInt IntraProceduralRA<CGT>::getMin(const Value *v) {
+  return APInt::getSignedMinValue(getBitWidth(v));
+}
 
-template <class CGT> APInt IntraProceduralRA<CGT>::getMax() { return Max; }
+template <class CGT>
+APInt IntraProceduralRA<CGT>::getMax(const Value *v) {
+  return APInt::getSignedMaxValue(getBitWidth(v));
+}
 
 template <class CGT> Range IntraProceduralRA<CGT>::getRange(const Value *v) {
   return CG->getRange(v);
 }
 
 template <class CGT> bool IntraProceduralRA<CGT>::runOnFunction(Function &F) {
-  //	if(CG) delete CG;
-  CG = new CGT();
-
-  MAX_BIT_INT = getMaxBitWidth(F);
-  updateConstantIntegers(MAX_BIT_INT);
+  // The graph of the previous function is dropped, but its memory is reused.
+  if (CG != nullptr) {
+    CG->clear();
+  } else {
+    CG = new CGT(ctx);
+  }
 
 // Build the graph and find the intervals of the variables.
 #ifdef STATS
-  Timer *timer = prof.registerNewTimer("BuildGraph", "Build constraint graph");
+  Timer *timer =
+      ctx.prof.registerNewTimer("BuildGraph", "Build constraint graph");
   timer->startTimer();
 #endif
   CG->buildGraph(F);
   CG->buildVarNodes();
 #ifdef STATS
   timer->stopTimer();
-  prof.addTimeRecord(timer);
+  ctx.prof.addTimeRecord(timer);
 
-  prof.registerMemoryUsage();
+  ctx.prof.registerMemoryUsage();
 #endif
 #ifdef PRINT_DEBUG
   CG->printToFile(F, "/tmp/" + F.getName().str() + "cgpre.dot");
@@ -238,28 +273,20 @@ void IntraProceduralRA<CGT>::getAnalysisUsage(AnalysisUsage &AU) const {
 
 template <class CGT> IntraProceduralRA<CGT>::~IntraProceduralRA() {
 #ifdef STATS
-  prof.printTime("BuildGraph");
-  prof.printTime("Nuutila");
-  prof.printTime("SCCs resolution");
-  prof.printTime("ComputeStats");
-  prof.printMemoryUsage();
+  ctx.prof.printTime("BuildGraph");
+  ctx.prof.printTime("Nuutila");
+  ctx.prof.printTime("SCCs resolution");
+  ctx.prof.printTime("ComputeStats");
+  ctx.prof.printMemoryUsage();
 
   std::ostringstream formated;
-  formated << 100 * (1.0 - (static_cast<double>(needBits) / usedBits));
+  formated << 100 * (1.0 - (static_cast<double>(ctx.stats.needBits) /
+                            ctx.stats.usedBits));
   errs() << formated.str() << "\t - "
          << " Percentage of reduction\n";
-
-  // max visit computation
-  unsigned maxtimes = 0;
-  for (auto &pair : FerMap) {
-    unsigned times = pair.second;
-    if (times > maxtimes) {
-      maxtimes = times;
-    }
-  }
-  maxVisit = maxtimes;
 #endif
-  //	delete CG;
+  ctx.publishStatistics();
+  delete CG;
 }
 
 // ========================================================================== //
@@ -268,60 +295,59 @@ template <class CGT> IntraProceduralRA<CGT>::~IntraProceduralRA() {
 template<class CGT>
 char InterProceduralRA<CGT>::ID = 0;
 
-template <class CGT> APInt InterProceduralRA<CGT>::getMin() { return Min; }
-
-template <class CGT> APInt InterProceduralRA<CGT>::getMax() { return Max; }
-
-template <class CGT> Range InterProceduralRA<CGT>::getRange(const Value *v) {
-  return CG->getRange(v);
+template <class CGT>
+APInt InterProceduralRA<CGT>::getMin(const Value *v) {
+  return APInt::getSignedMinValue(getBitWidth(v));
 }
 
 template <class CGT>
-unsigned InterProceduralRA<CGT>::getMaxBitWidth(Module &M) {
-  unsigned max = 0U;
-  // Search through the functions for the max int bitwidth
-  for (const Function &F : M.functions()) {
-    if (!F.isDeclaration()) {
-      unsigned bitwidth = RangeAnalysis::getMaxBitWidth(F);
+APInt InterProceduralRA<CGT>::getMax(const Value *v) {
+  return APInt::getSignedMaxValue(getBitWidth(v));
+}
 
-      if (bitwidth > max) {
-        max = bitwidth;
-      }
-    }
-  }
-  return max;
+template <class CGT> Range InterProceduralRA<CGT>::getRange(const Value *v) {
+  return CG->getRange(v);
 }
 
 template <class CGT> bool InterProceduralRA<CGT>::runOnModule(Module &M) {
   // Constraint Graph
-  //	if(CG) delete CG;
-  CG = new CGT();
-
-  MAX_BIT_INT = getMaxBitWidth(M);
-  updateConstantIntegers(MAX_BIT_INT);
+  delete CG;
+  CG = new CGT(ctx);
 
 // Build the Constraint Graph by running on each function
 #ifdef STATS
-  Timer *timer = prof.registerNewTimer("BuildGraph", "Build constraint graph");
+  Timer *timer =
+      ctx.prof.registerNewTimer("BuildGraph", "Build constraint graph");
   timer->startTimer();
 #endif
+  SmallVector<Function *, 0> functions;
   for (Function &F : M.functions()) {
     // If the function is only a declaration, or if it has variable number of
     // arguments, do not match
     if (F.isDeclaration() || F.isVarArg()) {
       continue;
     }
+    functions.push_back(&F);
+  }
 
-    CG->buildGraph(F);
-    MatchParametersAndReturnValues(F, *CG);
+  const unsigned numThreads =
+      std::min<unsigned>(ctx.numThreads, functions.size());
+  if (numThreads > 1) {
+    buildGraphsInParallel(functions, numThreads);
+  } else {
+    for (Function *F : functions) {
+      CG->buildGraph(*F);
+      MatchParametersAndReturnValues(*F, *CG);
+    }
   }
   CG->buildVarNodes();
+  CG->setName(M.getModuleIdentifier());
 
 #ifdef STATS
   timer->stopTimer();
-  prof.addTimeRecord(timer);
+  ctx.prof.addTimeRecord(timer);
 
-  prof.registerMemoryUsage();
+  ctx.prof.registerMemoryUsage();
 #endif
 #ifdef PRINT_DEBUG
   std::string moduleIdentifier = M.getModuleIdentifier();
@@ -338,6 +364,75 @@ template <class CGT> bool InterProceduralRA<CGT>::runOnModule(Module &M) {
   return false;
 }
 
+/*
+ *	Each thread builds the graphs of some functions, each in a graph of its
+ *  own. The graphs are added to the graph of the module in the order of
+ *  functions, and the calls of each function are matched once it is added,
+ *  so the graph of the module is numbered as if it was built directly. The
+ *  threads stay a few functions ahead of the graphs added, so that only a
+ *  few graphs are kept at once.
+ */
+template <class CGT>
+void InterProceduralRA<CGT>::buildGraphsInParallel(
+    ArrayRef<Function *> functions, unsigned numThreads) {
+  const unsigned numFunctions = functions.size();
+  const unsigned window = 4 * numThreads;
+  SmallVector<std::unique_ptr<AnalysisContext>, 0> contexts =
+      createThreadContexts(numThreads);
+
+  // The following are protected by lock
+  std::mutex lock;
+  std::condition_variable wakeUp;
+  // The graphs built and not added yet
+  std::vector<std::unique_ptr<CGT>> graphs(numFunctions);
+  unsigned numAdded = 0;
+  unsigned next = 0;
+
+  auto work = [&](AnalysisContext &threadCtx) {
+    std::unique_lock<std::mutex> guard(lock);
+    while (next < numFunctions) {
+      if (next >= numAdded + window) {
+        wakeUp.wait(guard);
+        continue;
+      }
+
+      const unsigned i = next++;
+      guard.unlock();
+      std::unique_ptr<CGT> G = std::make_unique<CGT>(threadCtx);
+      G->buildGraph(*functions[i]);
+      guard.lock();
+
+      graphs[i] = std::move(G);
+      wakeUp.notify_all();
+    }
+  };
+
+  std::vector<std::thread> threads;
+  threads.reserve(numThreads);
+  for (unsigned i = 0; i < numThreads; ++i) {
+    threads.emplace_back(work, std::ref(*contexts[i]));
+  }
+  for (unsigned i = 0; i < numFunctions; ++i) {
+    std::unique_ptr<CGT> G;
+    {
+      std::unique_lock<std::mutex> guard(lock);
+      wakeUp.wait(guard, [&] { return graphs[i] != nullptr; });
+      G = std::move(graphs[i]);
+      ++numAdded;
+      wakeUp.notify_all();
+    }
+    CG->addGraph(*G);
+    MatchParametersAndReturnValues(*functions[i], *CG);
+  }
+  for (std::thread &thread : threads) {
+    thread.join();
+  }
+
+  for (const std::unique_ptr<AnalysisContext> &threadCtx : contexts) {
+    ctx.merge(*threadCtx);
+  }
+}
+
 template <class CGT>
 void InterProceduralRA<CGT>::getAnalysisUsage(AnalysisUsage &AU) const {
   AU.setPreservesAll();
@@ -374,6 +469,9 @@ void InterProceduralRA<CGT>::MatchParametersAndReturnValues(
   // Creates the data structure which receives the return values of the
   // function, if there is any
   SmallPtrSet<Value *, 4> returnValues;
+  // The first return instruction, which names the node where the return
+  // values meet
+  ReturnInst *firstReturn = nullptr;
 
   if (!noReturn) {
     // Iterate over the basic blocks to fetch all possible return values
@@ -390,7 +488,39 @@ void InterProceduralRA<CGT>::MatchParametersAndReturnValues(
 
       // Get the return value and insert in the data structure
       returnValues.insert(RI->getReturnValue());
+      if (firstReturn == nullptr) {
+        firstReturn = RI;
+      }
+    }
+  }
+
+  // Collect the calls of F, so that the matchers know how many sources they
+  // will have.
+  SmallVector<Instruction *, 8> callers;
+
+  for (Use &U : F.uses()) {
+    User *Us = U.getUser();
+
+    // Ignore blockaddress uses
+    if (isa<BlockAddress>(Us)) {
+      continue;
+    }
+
+    // Used by a non-instruction, or not the callee of a function, do not
+    // match.
+    if (!isa<CallInst>(Us) && !isa<InvokeInst>(Us)) {
+      continue;
+    }
+
+    Instruction *caller = cast<Instruction>(Us);
+
+    CallSite CS(caller);
+
+    if (!CS.isCallee(&U)) {
+      continue;
     }
+
+    callers.push_back(caller);
   }
 
   // For each use of F, get the real parameters and the caller instruction to do
@@ -400,7 +530,9 @@ void InterProceduralRA<CGT>::MatchParametersAndReturnValues(
   for (unsigned i = 0, e = parameters.size(); i < e; ++i) {
     VarNode *sink = G.addVarNode(parameters[i].first);
 
-    matchers[i] = new PhiOp(new BasicInterval(), sink, nullptr);
+    matchers[i] =
+        G.createPhiOp(G.createInterval<BasicInterval>(sink->getBitWidth()),
+                      sink, nullptr, callers.size());
 
     // Insert the operation in the graph.
     G.getOprs()->insert(matchers[i]);
@@ -409,37 +541,41 @@ void InterProceduralRA<CGT>::MatchParametersAndReturnValues(
     (*G.getDefMap())[sink->getValue()] = matchers[i];
   }
 
-  // For each return value, create a node
-  SmallVector<VarNode *, 4> returnVars;
-
-  for (Value *returnValue : returnValues) {
-    // Add VarNode to the CG
-    VarNode *from = G.addVarNode(returnValue);
+  // The return values meet in a single node, which the calls read, so that
+  // their union is evaluated once for all the calls. A single return value
+  // is read directly.
+  VarNode *returnVar = nullptr;
 
-    returnVars.push_back(from);
-  }
+  if (!noReturn && !callers.empty() && !returnValues.empty()) {
+    if (returnValues.size() == 1) {
+      returnVar = G.addVarNode(*returnValues.begin());
+    } else {
+      returnVar = G.addVarNode(firstReturn);
 
-  for (Use &U : F.uses()) {
-    User *Us = U.getUser();
+      PhiOp *phiOp = G.createPhiOp(
+          G.createInterval<BasicInterval>(returnVar->getBitWidth()),
+          returnVar, nullptr, returnValues.size());
 
-    // Ignore blockaddress uses
-    if (isa<BlockAddress>(Us)) {
-      continue;
-    }
+      // Insert the operation in the graph.
+      G.getOprs()->insert(phiOp);
 
-    // Used by a non-instruction, or not the callee of a function, do not
-    // match.
-    if (!isa<CallInst>(Us) && !isa<InvokeInst>(Us)) {
-      continue;
-    }
+      // Insert this definition in defmap
+      (*G.getDefMap())[returnVar->getValue()] = phiOp;
 
-    Instruction *caller = cast<Instruction>(Us);
+      for (Value *returnValue : returnValues) {
+        // Add VarNode to the CG
+        VarNode *from = G.addVarNode(returnValue);
 
-    CallSite CS(caller);
+        phiOp->addSource(from);
 
-    if (!CS.isCallee(&U)) {
-      continue;
+        // Inserts the sources of the operation in the use map list.
+        G.getUseMap()->find(from->getValue())->second.insert(phiOp);
+      }
     }
+  }
+
+  for (Instruction *caller : callers) {
+    CallSite CS(caller);
 
     // Iterate over the real parameters and put them in the data structure
     CallSite::arg_iterator AI;
@@ -470,7 +606,9 @@ void InterProceduralRA<CGT>::MatchParametersAndReturnValues(
       // Add caller instruction to the CG (it receives the return value)
       to = G.addVarNode(caller);
 
-      PhiOp *phiOp = new PhiOp(new BasicInterval(), to, nullptr);
+      PhiOp *phiOp =
+          G.createPhiOp(G.createInterval<BasicInterval>(to->getBitWidth()), to,
+                        nullptr, returnVar != nullptr ? 1 : 0);
 
       // Insert the operation in the graph.
       G.getOprs()->insert(phiOp);
@@ -478,11 +616,11 @@ void InterProceduralRA<CGT>::MatchParametersAndReturnValues(
       // Insert this definition in defmap
       (*G.getDefMap())[to->getValue()] = phiOp;
 
-      for (VarNode *var : returnVars) {
-        phiOp->addSource(var);
+      if (returnVar != nullptr) {
+        phiOp->addSource(returnVar);
 
         // Inserts the sources of the operation in the use map list.
-        G.getUseMap()->find(var->getValue())->second.insert(phiOp);
+        G.getUseMap()->find(returnVar->getValue())->second.insert(phiOp);
       }
     }
 
@@ -501,876 +639,847 @@ template <class CGT> InterProceduralRA<CGT>::~InterProceduralRA() {
   //  prof.printTime("Nuutila");
   //  prof.printTime("SCCs resolution");
   //  prof.printTime("ComputeStats");
-  prof.printMemoryUsage();
+  ctx.prof.printMemoryUsage();
 
   std::ostringstream formated;
-  formated << 100 * (1.0 - (static_cast<double>(needBits) / usedBits));
+  formated << 100 * (1.0 - (static_cast<double>(ctx.stats.needBits) /
+                            ctx.stats.usedBits));
   errs() << formated.str() << "\t - "
          << " Percentage of reduction\n";
-
-  // max visit computation
-  unsigned maxtimes = 0;
-  for (auto &pair : FerMap) {
-    unsigned times = pair.second;
-    if (times > maxtimes) {
-      maxtimes = times;
-    }
-  }
-  maxVisit = maxtimes;
 #endif
+  ctx.publishStatistics();
+  delete CG;
 }
 
-static RegisterPass<IntraProceduralRA<Cousot>>
-    Y("ra-intra-cousot", "Range Analysis (Cousot - intra)");
-static RegisterPass<IntraProceduralRA<CropDFS>>
-    Z("ra-intra-crop", "Range Analysis (Crop - intra)");
-static RegisterPass<InterProceduralRA<Cousot>>
-    W("ra-inter-cousot", "Range Analysis (Cousot - inter)");
-static RegisterPass<InterProceduralRA<CropDFS>>
-    X("ra-inter-crop", "Range Analysis (Crop - inter)");
-
 // ========================================================================== //
-// Range
+// IntraProceduralParallelRangeAnalysis
 // ========================================================================== //
-Range::Range() : l(Min), u(Max) {}
+template <class CGT> char IntraProceduralParallelRA<CGT>::ID = 0;
 
-Range::Range(const APInt &lb, const APInt &ub, RangeType rType)
-    : l(lb), u(ub), type(rType) {
-  if (lb.sgt(ub)) {
-    type = Empty;
-  }
+template <class CGT>
+APInt IntraProceduralParallelRA<CGT>::getMin(const Value *v) {
+  return APInt::getSignedMinValue(getBitWidth(v));
+}
+
+template <class CGT>
+APInt IntraProceduralParallelRA<CGT>::getMax(const Value *v) {
+  return APInt::getSignedMaxValue(getBitWidth(v));
 }
 
-bool Range::isMaxRange() const {
-  return this->getLower().eq(Min) && this->getUpper().eq(Max);
+template <class CGT>
+Range IntraProceduralParallelRA<CGT>::getRange(const Value *v) {
+  return ranges.getRange(v);
 }
 
-/// Add and Mul are commutative. So, they are a little different
-/// than the other operations.
-Range Range::add(const Range &other) const {
-  if (this->isUnknown() || other.isUnknown()) {
-    return Range(Min, Max, Unknown);
+template <class CGT>
+bool IntraProceduralParallelRA<CGT>::runOnModule(Module &M) {
+  SmallVector<const Function *, 0> functions;
+  for (const Function &F : M.functions()) {
+    if (!F.isDeclaration()) {
+      functions.push_back(&F);
+    }
   }
+  ranges.reset(functions);
 
-  const APInt &a = this->getLower();
-  const APInt &b = this->getUpper();
-  const APInt &c = other.getLower();
-  const APInt &d = other.getUpper();
-  APInt l = Min, u = Max;
-  if (a.ne(Min) && c.ne(Min)) {
-    l = a + c;
+  // Each thread has its own context and graph, and fills the ranges of the
+  // functions it solves.
+  const unsigned numThreads = std::max(
+      1U, std::min<unsigned>(ctx.numThreads, functions.size()));
+  SmallVector<std::unique_ptr<AnalysisContext>, 0> contexts =
+      createThreadContexts(numThreads);
+  std::atomic<unsigned> next{0};
 
-    // Overflow handling
-    if (a.isNegative() == c.isNegative() && a.isNegative() != l.isNegative()) {
-      l = Min;
-    }
-  }
+  auto work = [&](AnalysisContext &threadCtx) {
+    CGT G(threadCtx);
+    for (unsigned i = next++, e = functions.size(); i < e; i = next++) {
+      const Function &F = *functions[i];
+      G.clear();
 
-  if (b.ne(Max) && d.ne(Max)) {
-    u = b + d;
+// Build the graph and find the intervals of the variables.
+#ifdef STATS
+      Timer *timer = threadCtx.prof.registerNewTimer(
+          "BuildGraph", "Build constraint graph");
+      timer->startTimer();
+#endif
+      G.buildGraph(F);
+      G.buildVarNodes();
+#ifdef STATS
+      timer->stopTimer();
+      threadCtx.prof.addTimeRecord(timer);
 
-    // Overflow handling
-    if (b.isNegative() == d.isNegative() && b.isNegative() != u.isNegative()) {
-      u = Max;
+      threadCtx.prof.registerMemoryUsage();
+#endif
+#ifdef PRINT_DEBUG
+      G.printToFile(F, "/tmp/" + F.getName().str() + "cgpre.dot");
+#endif
+      G.findIntervals();
+#ifdef PRINT_DEBUG
+      G.printToFile(F, "/tmp/" + F.getName().str() + "cgpos.dot");
+#endif
+      G.collectRanges(ranges.get(i));
     }
-  }
+  };
 
-  return Range(l, u);
-}
+  std::vector<std::thread> threads;
+  threads.reserve(numThreads - 1);
+  for (unsigned i = 1; i < numThreads; ++i) {
+    threads.emplace_back(work, std::ref(*contexts[i]));
+  }
+  work(*contexts[0]);
+  for (std::thread &thread : threads) {
+    thread.join();
+  }
 
-/// [a, b] − [c, d] =
-/// [min (a − c, a − d, b − c, b − d),
-/// max (a − c, a − d, b − c, b − d)] = [a − d, b − c]
-/// The other operations are just like this.
-Range Range::sub(const Range &other) const {
-  if (this->isUnknown() || other.isUnknown()) {
-    return Range(Min, Max, Unknown);
+  for (const std::unique_ptr<AnalysisContext> &threadCtx : contexts) {
+    ctx.merge(*threadCtx);
   }
 
-  const APInt &a = this->getLower();
-  const APInt &b = this->getUpper();
-  const APInt &c = other.getLower();
-  const APInt &d = other.getUpper();
-  APInt l, u;
+  return false;
+}
 
-  const APInt less = (a.slt(c)) ? a : c;
-  const APInt greater = (b.sgt(d)) ? b : d;
+template <class CGT>
+void IntraProceduralParallelRA<CGT>::getAnalysisUsage(
+    AnalysisUsage &AU) const {
+  AU.setPreservesAll();
+}
 
-  // a-d
-  if (a.eq(Min) || d.eq(Max)) {
-    l = Min;
-  } else {
-    l = a - d;
+template <class CGT>
+IntraProceduralParallelRA<CGT>::~IntraProceduralParallelRA() {
+#ifdef STATS
+  ctx.prof.printTime("BuildGraph");
+  ctx.prof.printTime("Nuutila");
+  ctx.prof.printTime("SCCs resolution");
+  ctx.prof.printTime("ComputeStats");
+  ctx.prof.printMemoryUsage();
 
-    // Overflow handling
-    if (a.isNegative() != d.isNegative() && d.isNegative() == l.isNegative()) {
-      l = Min;
-    }
-  }
+  std::ostringstream formated;
+  formated << 100 * (1.0 - (static_cast<double>(ctx.stats.needBits) /
+                            ctx.stats.usedBits));
+  errs() << formated.str() << "\t - "
+         << " Percentage of reduction\n";
+#endif
+  ctx.publishStatistics();
+}
 
-  // b-c
-  if (b.eq(Max) || c.eq(Min)) {
-    u = Max;
-  } else {
-    u = b - c;
+// ========================================================================== //
+// InterProceduralSummaryRangeAnalysis
+// ========================================================================== //
+template <class CGT> char InterProceduralSummaryRA<CGT>::ID = 0;
 
-    // Overflow handling
-    if (b.isNegative() != c.isNegative() && c.isNegative() == u.isNegative()) {
-      u = Max;
-    }
+template <class CGT>
+InterProceduralSummaryRA<CGT>::Summary::Summary(const Function &F)
+    : ret(F.getReturnType()->isIntegerTy()
+              ? F.getReturnType()->getIntegerBitWidth()
+              : 1) {
+  for (const Argument &A : F.args()) {
+    params.push_back(Range(RangeAnalysis::getBitWidth(&A)));
   }
+}
 
-  return Range(l, u);
+template <class CGT>
+APInt InterProceduralSummaryRA<CGT>::getMin(const Value *v) {
+  return APInt::getSignedMinValue(getBitWidth(v));
 }
 
-#define MUL_HELPER(x, y)                                                       \
-  (x).eq(Max)                                                                  \
-      ? ((x).slt(Zero) ? Min : ((x).eq(Zero) ? Zero : Max))                    \
-      : ((x).eq(Max)                                                           \
-             ? ((x).slt(Zero) ? Min : ((x).eq(Zero) ? Zero : Max))             \
-             : ((x).eq(Min)                                                    \
-                    ? ((x).slt(Zero) ? Max : ((x).eq(Zero) ? Zero : Min))      \
-                    : ((x).eq(Min)                                             \
-                           ? ((x).slt(Zero) ? Max                              \
-                                            : ((x).eq(Zero) ? Zero : Min))     \
-                           : ((x) * (x)))))
+template <class CGT>
+APInt InterProceduralSummaryRA<CGT>::getMax(const Value *v) {
+  return APInt::getSignedMaxValue(getBitWidth(v));
+}
 
-#define MUL_OV(x, y, xy)                                                       \
-  ((x).isStrictlyPositive() == (y).isStrictlyPositive()                        \
-       ? ((xy).isNegative() ? Max : (xy))                                      \
-       : ((xy).isStrictlyPositive() ? Min : (xy)))
+template <class CGT>
+Range InterProceduralSummaryRA<CGT>::getRange(const Value *v) {
+  return ranges.getRange(v);
+}
 
-/// Add and Mul are commutatives. So, they are a little different
-/// of the other operations.
-// [a, b] * [c, d] = [Min(a*c, a*d, b*c, b*d), Max(a*c, a*d, b*c, b*d)]
-Range Range::mul(const Range &other) const {
-  if (this->isUnknown() || other.isUnknown()) {
-    return Range(Min, Max, Unknown);
+template <class CGT>
+bool InterProceduralSummaryRA<CGT>::runOnModule(Module &M) {
+  buildCallGraph(M);
+  findCallGraphComponents();
+  selectContextCalls();
+  ranges.reset(functions);
+
+  const unsigned numThreads = std::max(
+      1U, std::min<unsigned>(ctx.numThreads, sccBegin.size() - 1));
+  SmallVector<std::unique_ptr<AnalysisContext>, 0> contexts =
+      createThreadContexts(numThreads);
+  SmallVector<std::unique_ptr<CGT>, 0> graphs;
+  for (const std::unique_ptr<AnalysisContext> &threadCtx : contexts) {
+    graphs.push_back(std::make_unique<CGT>(*threadCtx));
+  }
+
+  // The first round solves every function with the full ranges as
+  // parameters, callees first. The next ones alternate: going top-down, each
+  // function takes its parameters from the arguments of its callers, and
+  // going bottom-up, the return values of its callees. Only the functions
+  // whose inputs changed are solved again. Every round is sound, and they
+  // usually narrow the ranges down, until a round changes nothing.
+  for (unsigned round = 1; round <= std::max(1U, ctx.summaryRounds);
+       ++round) {
+    if (!solveRound(round, graphs)) {
+      break;
+    }
   }
 
-  if (this->isMaxRange() || other.isMaxRange()) {
-    return Range(Min, Max);
+  graphs.clear();
+  for (const std::unique_ptr<AnalysisContext> &threadCtx : contexts) {
+    ctx.merge(*threadCtx);
   }
 
-  const APInt &a = this->getLower();
-  const APInt &b = this->getUpper();
-  const APInt &c = other.getLower();
-  const APInt &d = other.getUpper();
-
-  APInt candidates[4];
-  candidates[0] = MUL_OV(a, c, MUL_HELPER(a, c));
-  candidates[1] = MUL_OV(a, d, MUL_HELPER(a, d));
-  candidates[2] = MUL_OV(b, c, MUL_HELPER(b, c));
-  candidates[3] = MUL_OV(b, d, MUL_HELPER(b, d));
-
-  // Lower bound is the min value from the vector, while upper bound is the max
-  // value
-  APInt *min = &candidates[0];
-  APInt *max = &candidates[0];
+  return false;
+}
 
-  for (unsigned i = 1; i < 4; ++i) {
-    if (candidates[i].sgt(*max)) {
-      max = &candidates[i];
-    } else if (candidates[i].slt(*min)) {
-      min = &candidates[i];
+/*
+ *	Numbers the functions with a body, and collects their return values and
+ *  the calls they make to functions whose parameters and return values are
+ *  matched: functions with a body and a fixed number of arguments, called
+ *  directly.
+ */
+template <class CGT>
+void InterProceduralSummaryRA<CGT>::buildCallGraph(Module &M) {
+  functions.clear();
+  summaries.clear();
+  callBegin.clear();
+  calls.clear();
+  callerBegin.clear();
+  callers.clear();
+  returnBegin.clear();
+  returnValues.clear();
+
+  DenseMap<const Function *, unsigned> functionIds;
+  for (const Function &F : M.functions()) {
+    if (!F.isDeclaration()) {
+      functionIds[&F] = functions.size();
+      functions.push_back(&F);
+      summaries.emplace_back(F);
     }
   }
 
-  return Range(*min, *max);
-}
+  for (Function &F : M.functions()) {
+    if (F.isDeclaration()) {
+      continue;
+    }
 
-#define DIV_HELPER(OP, x, y)                                                   \
-  (x).eq(Max)                                                                  \
-      ? ((y).slt(Zero) ? Min : ((y).eq(Zero) ? Zero : Max))                    \
-      : ((y).eq(Max)                                                           \
-             ? ((x).slt(Zero) ? Min : ((x).eq(Zero) ? Zero : Max))             \
-             : ((x).eq(Min)                                                    \
-                    ? ((y).slt(Zero) ? Max : ((y).eq(Zero) ? Zero : Min))      \
-                    : ((y).eq(Min)                                             \
-                           ? ((x).slt(Zero) ? Max                              \
-                                            : ((x).eq(Zero) ? Zero : Min))     \
-                           : ((x).OP((y))))))
+    callBegin.push_back(calls.size());
+    returnBegin.push_back(returnValues.size());
+    const bool returnsInt = F.getReturnType()->isIntegerTy();
+    for (Instruction &I : instructions(F)) {
+      if (ReturnInst *RI = dyn_cast<ReturnInst>(&I)) {
+        if (returnsInt) {
+          returnValues.push_back(RI->getReturnValue());
+        }
+        continue;
+      }
 
-Range Range::udiv(const Range &other) const {
-  if (this->isUnknown() || other.isUnknown()) {
-    return Range(Min, Max, Unknown);
+      if (!isa<CallInst>(I) && !isa<InvokeInst>(I)) {
+        continue;
+      }
+      const Function *callee = CallSite(&I).getCalledFunction();
+      if (callee == nullptr || callee->isVarArg()) {
+        continue;
+      }
+      auto fit = functionIds.find(callee);
+      if (fit != functionIds.end()) {
+        calls.push_back(std::make_pair(&I, fit->second));
+        summaries[fit->second].called = true;
+      }
+    }
   }
+  callBegin.push_back(calls.size());
+  returnBegin.push_back(returnValues.size());
 
-  const APInt &a = this->getLower();
-  const APInt &b = this->getUpper();
-  const APInt &c = other.getLower();
-  const APInt &d = other.getUpper();
-
-  // Deal with division by 0 exception
-  if (c.ule(Zero) && d.uge(Zero)) {
-    return Range(Min, Max);
+  callerBegin.assign(functions.size() + 1, 0);
+  for (const std::pair<Instruction *, unsigned> &call : calls) {
+    ++callerBegin[call.second + 1];
   }
-
-  APInt candidates[4];
-
-  // value[1]: lb(c) / leastpositive(d)
-  candidates[0] = DIV_HELPER(udiv, a, c);
-  candidates[1] = DIV_HELPER(udiv, a, d);
-  candidates[2] = DIV_HELPER(udiv, b, c);
-  candidates[3] = DIV_HELPER(udiv, b, d);
-
-  // Lower bound is the min value from the vector, while upper bound is the max
-  // value
-  APInt *min = &candidates[0];
-  APInt *max = &candidates[0];
-
-  for (unsigned i = 1; i < 4; ++i) {
-    if (candidates[i].sgt(*max)) {
-      max = &candidates[i];
-    } else if (candidates[i].slt(*min)) {
-      min = &candidates[i];
+  for (unsigned f = 0, e = functions.size(); f < e; ++f) {
+    callerBegin[f + 1] += callerBegin[f];
+  }
+  callers.resize(calls.size());
+  SmallVector<unsigned, 0> next(callerBegin.begin(), callerBegin.end() - 1);
+  for (unsigned f = 0, e = functions.size(); f < e; ++f) {
+    unsigned position = 0;
+    for (unsigned c = callBegin[f]; c < callBegin[f + 1]; ++c) {
+      const unsigned g = calls[c].second;
+      callers[next[g]++] = std::make_pair(f, position);
+      position += functions[g]->arg_size();
     }
   }
-
-  return Range(*min, *max);
 }
 
-Range Range::sdiv(const Range &other) const {
-  if (this->isUnknown() || other.isUnknown()) {
-    return Range(Min, Max, Unknown);
-  }
-
-  const APInt &a = this->getLower();
-  const APInt &b = this->getUpper();
-  const APInt &c = other.getLower();
-  const APInt &d = other.getUpper();
-
-  // Deal with division by 0 exception
-  if (c.sle(Zero) && d.sge(Zero)) {
-    return Range(Min, Max);
-  }
+/*
+ *	Finds the strongly connected components of the call graph with Tarjan's
+ *  algorithm, which finds them callees first. The recursion is replaced by
+ *  an explicit stack of frames, each holding a function and its next call.
+ */
+template <class CGT>
+void InterProceduralSummaryRA<CGT>::findCallGraphComponents() {
+  const unsigned numFunctions = functions.size();
+  const unsigned Unvisited = ~0U;
+  SmallVector<unsigned, 0> index(numFunctions, Unvisited);
+  SmallVector<unsigned, 0> low(numFunctions);
+  BitVector onStack(numFunctions);
+  SmallVector<unsigned, 0> stack;
+  SmallVector<std::pair<unsigned, unsigned>, 0> frames;
+  unsigned next = 0;
+
+  sccMembers.clear();
+  sccBegin.assign(1, 0);
+  sccOf.resize(numFunctions);
+
+  for (unsigned start = 0; start < numFunctions; ++start) {
+    if (index[start] != Unvisited) {
+      continue;
+    }
 
-  APInt candidates[4];
-  candidates[0] = DIV_HELPER(sdiv, a, c);
-  candidates[1] = DIV_HELPER(sdiv, a, d);
-  candidates[2] = DIV_HELPER(sdiv, b, c);
-  candidates[3] = DIV_HELPER(sdiv, b, d);
+    index[start] = low[start] = next++;
+    stack.push_back(start);
+    onStack.set(start);
+    frames.push_back(std::make_pair(start, callBegin[start]));
+
+    while (!frames.empty()) {
+      const unsigned f = frames.back().first;
+      const unsigned call = frames.back().second;
+
+      if (call < callBegin[f + 1]) {
+        const unsigned g = calls[call].second;
+        ++frames.back().second;
+        if (index[g] == Unvisited) {
+          index[g] = low[g] = next++;
+          stack.push_back(g);
+          onStack.set(g);
+          frames.push_back(std::make_pair(g, callBegin[g]));
+        } else if (onStack[g]) {
+          low[f] = std::min(low[f], index[g]);
+        }
+        continue;
+      }
 
-  // Lower bound is the min value from the vector, while upper bound is the max
-  // value
-  APInt *min = &candidates[0];
-  APInt *max = &candidates[0];
+      frames.pop_back();
+      if (!frames.empty()) {
+        const unsigned caller = frames.back().first;
+        low[caller] = std::min(low[caller], low[f]);
+      }
 
-  for (unsigned i = 1; i < 4; ++i) {
-    if (candidates[i].sgt(*max)) {
-      max = &candidates[i];
-    } else if (candidates[i].slt(*min)) {
-      min = &candidates[i];
+      if (low[f] == index[f]) {
+        const unsigned first = sccMembers.size();
+        unsigned g;
+        do {
+          g = stack.pop_back_val();
+          onStack.reset(g);
+          sccOf[g] = sccBegin.size() - 1;
+          sccMembers.push_back(g);
+        } while (g != f);
+        std::sort(sccMembers.begin() + first, sccMembers.end());
+        sccBegin.push_back(sccMembers.size());
+      }
     }
   }
-
-  return Range(*min, *max);
 }
 
-Range Range::urem(const Range &other) const {
-  if (this->isUnknown() || other.isUnknown()) {
-    return Range(Min, Max, Unknown);
+/*
+ *	Chooses the calls whose callees are solved again in their context, within
+ *  the budget of the analysis. The size of a callee is the number of its
+ *  arguments and instructions, which bounds the number of nodes of its
+ *  graph. The calls within a component of the call graph are not chosen, so
+ *  that the solution of a callee in a context never needs another one.
+ */
+template <class CGT>
+void InterProceduralSummaryRA<CGT>::selectContextCalls() {
+  contextCalls.clear();
+  contextCalls.resize(calls.size());
+  contextRets.clear();
+  for (const std::pair<Instruction *, unsigned> &call : calls) {
+    contextRets.push_back(Range(summaries[call.second].ret.getBitWidth()));
+  }
+  if (ctx.contextBudget == 0) {
+    return;
   }
 
-  const APInt &a = this->getLower();
-  const APInt &b = this->getUpper();
-  const APInt &c = other.getLower();
-  const APInt &d = other.getUpper();
-
-  // Deal with mod 0 exception
-  if (c.ule(Zero) && d.uge(Zero)) {
-    return Range(Min, Max);
+  SmallVector<unsigned, 0> sizes;
+  for (const Function *F : functions) {
+    unsigned size = F->arg_size();
+    for (const BasicBlock &BB : *F) {
+      size += BB.size();
+    }
+    sizes.push_back(size);
   }
-
-  APInt candidates[4];
-  candidates[0] = Min;
-  candidates[1] = Min;
-  candidates[2] = Max;
-  candidates[3] = Max;
-
-  if (a.ne(Min) && c.ne(Min)) {
-    candidates[0] = a.urem(c); // lower lower
+  SmallVector<std::pair<unsigned, unsigned>, 0> candidates;
+  for (unsigned f = 0, e = functions.size(); f < e; ++f) {
+    for (unsigned c = callBegin[f]; c < callBegin[f + 1]; ++c) {
+      const unsigned g = calls[c].second;
+      if (sccOf[g] != sccOf[f] && functions[g]->arg_size() != 0 &&
+          calls[c].first->getType()->isIntegerTy()) {
+        candidates.push_back(std::make_pair(sizes[g], c));
+      }
+    }
   }
+  std::sort(candidates.begin(), candidates.end());
 
-  if (a.ne(Min) && d.ne(Max)) {
-    candidates[1] = a.urem(d); // lower upper
+  unsigned budget = ctx.contextBudget;
+  for (const std::pair<unsigned, unsigned> &candidate : candidates) {
+    if (candidate.first > budget) {
+      break;
+    }
+    budget -= candidate.first;
+    contextCalls.set(candidate.second);
   }
+}
 
-  if (b.ne(Max) && c.ne(Min)) {
-    candidates[2] = b.urem(c); // upper lower
+template <class CGT>
+void InterProceduralSummaryRA<CGT>::updateParameters(unsigned f) {
+  Summary &summary = summaries[f];
+  if (!summary.called) {
+    return;
   }
 
-  if (b.ne(Max) && d.ne(Max)) {
-    candidates[3] = b.urem(d); // upper upper
+  // The union of the arguments of the calls of f
+  SmallVector<Range, 4> params;
+  for (const Range &param : summary.params) {
+    params.push_back(Range(param.getBitWidth(), Unknown));
   }
-
-  // Lower bound is the min value from the vector, while upper bound is the max
-  // value
-  APInt *min = &candidates[0];
-  APInt *max = &candidates[0];
-
-  for (unsigned i = 1; i < 4; ++i) {
-    if (candidates[i].sgt(*max)) {
-      max = &candidates[i];
-    } else if (candidates[i].slt(*min)) {
-      min = &candidates[i];
+  for (unsigned i = callerBegin[f]; i < callerBegin[f + 1]; ++i) {
+    const Range *arg =
+        summaries[callers[i].first].callArgs.begin() + callers[i].second;
+    for (Range &param : params) {
+      param = param.unionWith(*arg++);
     }
   }
 
-  return Range(*min, *max);
-}
-
-Range Range::srem(const Range &other) const {
-  if (other == Range(Zero, Zero) || other == Range(Min, Max, Empty)) {
-    return Range(Min, Max, Empty);
-  }
-
-  if (this->isUnknown() || other.isUnknown()) {
-    return Range(Min, Max, Unknown);
-  }
-
-  const APInt &a = this->getLower();
-  const APInt &b = this->getUpper();
-  const APInt &c = other.getLower();
-  const APInt &d = other.getUpper();
-
-  // Deal with mod 0 exception
-  if (c.sle(Zero) && d.sge(Zero)) {
-    return Range(Min, Max);
-  }
-
-  APInt candidates[4];
-  candidates[0] = Min;
-  candidates[1] = Min;
-  candidates[2] = Max;
-  candidates[3] = Max;
-
-  if (a.ne(Min) && c.ne(Min)) {
-    candidates[0] = a.srem(c); // lower lower
-  }
-
-  if (a.ne(Min) && d.ne(Max)) {
-    candidates[1] = a.srem(d); // lower upper
-  }
-
-  if (b.ne(Max) && c.ne(Min)) {
-    candidates[2] = b.srem(c); // upper lower
-  }
-
-  if (b.ne(Max) && d.ne(Max)) {
-    candidates[3] = b.srem(d); // upper upper
+  for (unsigned i = 0, e = params.size(); i < e; ++i) {
+    params[i] = grow(summary.params[i], params[i], summary.growth);
   }
-
-  // Lower bound is the min value from the vector, while upper bound is the max
-  // value
-  APInt *min = &candidates[0];
-  APInt *max = &candidates[0];
-
-  for (unsigned i = 1; i < 4; ++i) {
-    if (candidates[i].sgt(*max)) {
-      max = &candidates[i];
-    } else if (candidates[i].slt(*min)) {
-      min = &candidates[i];
-    }
-  }
-
-  return Range(*min, *max);
-}
-
-// Logic has been borrowed from ConstantRange
-Range Range::shl(const Range &other) const {
-  if (isEmpty()) {
-    return Range(*this);
-  }
-  if (other.isEmpty()) {
-    return Range(other);
-  }
-
-  if (this->isUnknown() || other.isUnknown()) {
-    return Range(Min, Max, Unknown);
-  }
-
-  const APInt &a = this->getLower();
-  const APInt &b = this->getUpper();
-  const APInt &c = other.getLower();
-  const APInt &d = other.getUpper();
-
-  if (a.eq(Min) || c.eq(Min) || b.eq(Max) || d.eq(Max)) {
-    return Range(Min, Max);
-  }
-
-  APInt min = a.shl(c);
-  APInt max = b.shl(d);
-
-  APInt Zeros(MAX_BIT_INT, b.countLeadingZeros());
-  if (Zeros.ugt(d)) {
-    return Range(min, max);
+  if (!std::equal(params.begin(), params.end(), summary.params.begin())) {
+    summary.params = params;
+    summary.paramsChanged = true;
   }
-
-  // [-inf, +inf]
-  return Range(Min, Max);
 }
 
-// Logic has been borrowed from ConstantRange
-Range Range::lshr(const Range &other) const {
-  if (isEmpty()) {
-    return Range(*this);
-  }
-  if (other.isEmpty()) {
-    return Range(other);
-  }
-
-  if (this->isUnknown() || other.isUnknown()) {
-    return Range(Min, Max, Unknown);
-  }
-
-  const APInt &a = this->getLower();
-  const APInt &b = this->getUpper();
-  const APInt &c = other.getLower();
-  const APInt &d = other.getUpper();
-
-  if (a.eq(Min) || c.eq(Min) || b.eq(Max) || d.eq(Max)) {
-    return Range(Min, Max);
+template <class CGT>
+bool InterProceduralSummaryRA<CGT>::solveRound(
+    unsigned round, ArrayRef<std::unique_ptr<CGT>> graphs) {
+  const unsigned numComponents = sccBegin.size() - 1;
+  const bool topDown = round % 2 == 0;
+
+  // The components which wait for each component, in compressed sparse row
+  // form: its callers going bottom-up, its callees going top-down.
+  SmallVector<std::pair<unsigned, unsigned>, 0> edges;
+  for (unsigned f = 0, e = functions.size(); f < e; ++f) {
+    for (unsigned c = callBegin[f]; c < callBegin[f + 1]; ++c) {
+      const unsigned callee = sccOf[calls[c].second];
+      if (callee != sccOf[f]) {
+        edges.push_back(topDown ? std::make_pair(sccOf[f], callee)
+                                : std::make_pair(callee, sccOf[f]));
+      }
+    }
   }
+  std::sort(edges.begin(), edges.end());
+  edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+  SmallVector<unsigned, 0> nextBegin(numComponents + 1, 0);
+  SmallVector<unsigned, 0> nexts;
+  // The following are protected by lock
+  std::mutex lock;
+  std::condition_variable wakeUp;
+  // The number of components each component still waits for
+  SmallVector<unsigned, 0> waiting(numComponents, 0);
+  for (const std::pair<unsigned, unsigned> &edge : edges) {
+    ++nextBegin[edge.first + 1];
+    ++waiting[edge.second];
+    nexts.push_back(edge.second);
+  }
+  for (unsigned s = 0; s < numComponents; ++s) {
+    nextBegin[s + 1] += nextBegin[s];
+  }
+
+  // The components ready to be solved, as a heap giving the first one in
+  // the order of the round
+  auto later = [topDown](unsigned a, unsigned b) {
+    return topDown ? a < b : a > b;
+  };
+  SmallVector<unsigned, 0> ready;
+  unsigned numSolved = 0;
+  bool changed = false;
+  for (unsigned s = 0; s < numComponents; ++s) {
+    if (waiting[s] == 0) {
+      ready.push_back(s);
+    }
+  }
+  std::make_heap(ready.begin(), ready.end(), later);
+
+  auto work = [&](ConstraintGraph &G) {
+    std::unique_lock<std::mutex> guard(lock);
+    while (numSolved < numComponents) {
+      if (ready.empty()) {
+        wakeUp.wait(guard);
+        continue;
+      }
 
-  APInt max = b.lshr(c);
-  APInt min = a.lshr(d);
-
-  return Range(min, max);
-}
-
-Range Range::ashr(const Range &other) const {
-  if (isEmpty()) {
-    return Range(*this);
-  }
-  if (other.isEmpty()) {
-    return Range(other);
-  }
+      std::pop_heap(ready.begin(), ready.end(), later);
+      const unsigned s = ready.pop_back_val();
+      guard.unlock();
+      const bool sccChanged = solveComponent(s, round, G);
+      guard.lock();
+
+      changed |= sccChanged;
+      ++numSolved;
+      for (unsigned i = nextBegin[s]; i < nextBegin[s + 1]; ++i) {
+        if (--waiting[nexts[i]] == 0) {
+          ready.push_back(nexts[i]);
+          std::push_heap(ready.begin(), ready.end(), later);
+          wakeUp.notify_one();
+        }
+      }
+      if (numSolved == numComponents) {
+        wakeUp.notify_all();
+      }
+    }
+  };
 
-  if (this->isUnknown() || other.isUnknown()) {
-    return Range(Min, Max, Unknown);
+  std::vector<std::thread> threads;
+  threads.reserve(graphs.size() - 1);
+  for (unsigned i = 1, e = graphs.size(); i < e; ++i) {
+    threads.emplace_back(work, std::ref(*graphs[i]));
   }
-
-  const APInt &a = this->getLower();
-  const APInt &b = this->getUpper();
-  const APInt &c = other.getLower();
-  const APInt &d = other.getUpper();
-
-  if (a.eq(Min) || c.eq(Min) || b.eq(Max) || d.eq(Max)) {
-    return Range(Min, Max);
+  work(*graphs[0]);
+  for (std::thread &thread : threads) {
+    thread.join();
   }
 
-  APInt max = b.ashr(c);
-  APInt min = a.ashr(d);
-
-  return Range(min, max);
+  return changed;
 }
 
 /*
- * 	This and operation is coded following Hacker's Delight algorithm.
- * 	According to the author, it provides tight results.
+ *	Joins the range computed for a parameter or a return value to its last
+ *  range while its component grows. If the growth widens, the bounds which
+ *  grow jump to the extremes, as in Meet::growth.
  */
-Range Range::And(const Range &other) const {
-  if (this->isUnknown() || other.isUnknown()) {
-    const APInt &umin = APIntOps::umin(getUpper(), other.getUpper());
-    if (umin.isAllOnesValue()) {
-      return Range(Min, Max);
-    }
-    return Range(APInt::getNullValue(MAX_BIT_INT), umin);
-  }
-
-  APInt a = this->getLower();
-  APInt b = this->getUpper();
-  const APInt &c = other.getLower();
-  const APInt &d = other.getUpper();
-
-  if (a.eq(Min) || b.eq(Max) || c.eq(Min) || d.eq(Max)) {
-    return Range(Min, Max);
-  }
-
-  // negate everybody
-  APInt negA = APInt(a);
-  negA.flipAllBits();
-  APInt negB = APInt(b);
-  negB.flipAllBits();
-  APInt negC = APInt(c);
-  negC.flipAllBits();
-  APInt negD = APInt(d);
-  negD.flipAllBits();
-
-  Range inv1 = Range(negB, negA);
-  Range inv2 = Range(negD, negC);
-
-  Range invres = inv1.Or(inv2);
-
-  // negate the result of the 'or'
-  APInt invLower = invres.getUpper();
-  invLower.flipAllBits();
-
-  APInt invUpper = invres.getLower();
-  invUpper.flipAllBits();
-
-  return Range(invLower, invUpper);
-}
-
-// This operator is used when we are dealing with values
-// with more than 64-bits
-Range Range::And_conservative(const Range &other) const {
-  if (isEmpty()) {
-    return Range(*this);
-  }
-  if (other.isEmpty()) {
-    return Range(other);
+template <class CGT>
+Range InterProceduralSummaryRA<CGT>::grow(const Range &last,
+                                          const Range &computed,
+                                          Growth growth) {
+  if (growth == Growth::None || last.isUnknown() || last.isEmpty()) {
+    return computed;
   }
 
-  const APInt &umin = APIntOps::umin(other.getUpper(), getUpper());
-  if (umin.isAllOnesValue()) {
-    return Range(Min, Max);
+  const Range joined = last.unionWith(computed);
+  if (growth == Growth::Join || joined == last) {
+    return joined;
   }
-  return Range(APInt::getNullValue(MAX_BIT_INT), umin);
+  const unsigned width = last.getBitWidth();
+  return Range(joined.getLower().slt(last.getLower())
+                   ? APInt::getSignedMinValue(width)
+                   : last.getLower(),
+               joined.getUpper().sgt(last.getUpper())
+                   ? APInt::getSignedMaxValue(width)
+                   : last.getUpper());
 }
 
-namespace {
-int64_t minOR(int64_t a, int64_t b, int64_t c, int64_t d) {
-  int64_t m, temp;
-
-  m = 0x80000000 >> __builtin_clz(a ^ c);
-  while (m != 0) {
-    if ((~a & c & m) != 0) {
-      temp = (a | m) & -m;
-      if (temp <= b) {
-        a = temp;
-        break;
+/*
+ *	Solves the functions of the component s of the call graph in G. The
+ *  first time a recursive component goes bottom-up, the return values of
+ *  its functions are grown from empty ranges until they are stable, and the
+ *  first time it goes top-down, the arguments of the calls within it are:
+ *  the first iterations join the ranges, and the next ones widen them. The
+ *  return values start empty rather than unknown, since the solver takes an
+ *  unknown input as the full range. Then, in every round, a recursive
+ *  component is solved again while its ranges narrow down, at most for the
+ *  maximum number of rounds.
+ */
+template <class CGT>
+bool InterProceduralSummaryRA<CGT>::solveComponent(unsigned s, unsigned round,
+                                                   ConstraintGraph &G) {
+  const bool topDown = round % 2 == 0;
+  ArrayRef<unsigned> members(sccMembers.begin() + sccBegin[s],
+                             sccMembers.begin() + sccBegin[s + 1]);
+  bool recursive = members.size() > 1;
+  for (unsigned c = callBegin[members[0]]; c < callBegin[members[0] + 1];
+       ++c) {
+    recursive |= calls[c].second == members[0];
+  }
+
+  bool changed = false;
+  if (recursive && round <= 2) {
+    for (unsigned f : members) {
+      Summary &summary = summaries[f];
+      if (!topDown) {
+        summary.ret = Range(summary.ret.getBitWidth(), Empty);
+        continue;
       }
-    } else if ((a & ~c & m) != 0) {
-      temp = (c | m) & -m;
-      if (temp <= d) {
-        c = temp;
-        break;
+      for (Range &param : summary.params) {
+        param = Range(param.getBitWidth(), Unknown);
       }
-    }
-    m = m >> 1;
-  }
-  return a | c;
-}
-
-int64_t maxOR(int64_t a, int64_t b, int64_t c, int64_t d) {
-  int64_t m, temp;
-
-  m = 0x80000000 >> __builtin_clz(b & d);
-  while (m != 0) {
-    if ((b & d & m) != 0) {
-      temp = (b - m) | (m - 1);
-      if (temp >= a) {
-        b = temp;
-        break;
+      for (Range &arg : summary.callArgs) {
+        arg = Range(arg.getBitWidth(), Unknown);
       }
-      temp = (d - m) | (m - 1);
-      if (temp >= c) {
-        d = temp;
-        break;
+      summary.paramsChanged = true;
+    }
+
+    // Widening makes each range grow a bounded number of times, so this
+    // ends.
+    bool stable = false;
+    for (unsigned iteration = 1; !stable; ++iteration) {
+      const Growth growth = iteration <= std::max(1U, ctx.summaryRounds)
+                                ? Growth::Join
+                                : Growth::Widen;
+      for (unsigned f : members) {
+        summaries[f].growth = growth;
+      }
+      stable = true;
+      for (unsigned f : members) {
+        stable &= !solveFunction(f, topDown, G);
       }
     }
-    m = m >> 1;
-  }
-  return b | d;
-}
-} // namespace
 
-// This operator is used when we are dealing with values
-// with more than 64-bits
-Range Range::Or_conservative(const Range &other) const {
-  if (isEmpty()) {
-    return Range(*this);
-  }
-  if (other.isEmpty()) {
-    return Range(other);
-  }
-
-  if (this->isUnknown() || other.isUnknown()) {
-    return Range(Min, Max, Unknown);
-  }
-
-  const APInt &umax = APIntOps::umax(getLower(), other.getLower());
-  if (umax.isMinValue()) {
-    return Range(Min, Max);
+    for (unsigned f : members) {
+      summaries[f].growth = Growth::None;
+      summaries[f].paramsChanged = true;
+    }
+    changed = true;
   }
 
-  return Range(umax, APInt::getNullValue(MAX_BIT_INT));
-}
-
-/*
- * 	This or operation is coded following Hacker's Delight algorithm.
- * 	According to the author, it provides tight results.
- */
-Range Range::Or(const Range &other) const {
-  const APInt &a = this->getLower();
-  const APInt &b = this->getUpper();
-  const APInt &c = other.getLower();
-  const APInt &d = other.getUpper();
-
-  if (this->isUnknown() || other.isUnknown()) {
-    return Range(Min, Max, Unknown);
-  }
-  if (a.eq(Min) || b.eq(Max) || c.eq(Min) || d.eq(Max)) {
-    return Range(Min, Max);
-  }
-
-  unsigned char switchval = 0;
-  switchval += (a.isNonNegative() ? 1 : 0);
-  switchval <<= 1;
-  switchval += (b.isNonNegative() ? 1 : 0);
-  switchval <<= 1;
-  switchval += (c.isNonNegative() ? 1 : 0);
-  switchval <<= 1;
-  switchval += (d.isNonNegative() ? 1 : 0);
-
-  APInt l = Min, u = Max;
-
-  switch (switchval) {
-  case 0:
-    l = minOR(a.getSExtValue(), b.getSExtValue(), c.getSExtValue(),
-              d.getSExtValue());
-    u = maxOR(a.getSExtValue(), b.getSExtValue(), c.getSExtValue(),
-              d.getSExtValue());
-    break;
-  case 1:
-    l = a;
-    u = -1;
-    break;
-  case 3:
-    l = minOR(a.getSExtValue(), b.getSExtValue(), c.getSExtValue(),
-              d.getSExtValue());
-    u = maxOR(a.getSExtValue(), b.getSExtValue(), c.getSExtValue(),
-              d.getSExtValue());
-    break;
-  case 4:
-    l = c;
-    u = -1;
-    break;
-  case 5:
-    l = (a.slt(c) ? a : c);
-    u = maxOR(0, b.getSExtValue(), 0, d.getSExtValue());
-    break;
-  case 7:
-    l = minOR(a.getSExtValue(), 0xFFFFFFFF, c.getSExtValue(), d.getSExtValue());
-    u = minOR(0, b.getSExtValue(), c.getSExtValue(), d.getSExtValue());
-    break;
-  case 12:
-    l = minOR(a.getSExtValue(), b.getSExtValue(), c.getSExtValue(),
-              d.getSExtValue());
-    u = maxOR(a.getSExtValue(), b.getSExtValue(), c.getSExtValue(),
-              d.getSExtValue());
-    break;
-  case 13:
-    l = minOR(a.getSExtValue(), b.getSExtValue(), c.getSExtValue(), 0xFFFFFFFF);
-    u = maxOR(a.getSExtValue(), b.getSExtValue(), 0, d.getSExtValue());
-    break;
-  case 15:
-    l = minOR(a.getSExtValue(), b.getSExtValue(), c.getSExtValue(),
-              d.getSExtValue());
-    u = maxOR(a.getSExtValue(), b.getSExtValue(), c.getSExtValue(),
-              d.getSExtValue());
-    break;
+  for (unsigned iteration = 1;; ++iteration) {
+    bool sweepChanged = false;
+    for (unsigned f : members) {
+      sweepChanged |= solveFunction(f, topDown, G);
+    }
+    changed |= sweepChanged;
+    if (!recursive || !sweepChanged ||
+        iteration >= std::max(1U, ctx.summaryRounds)) {
+      return changed;
+    }
   }
-
-  return Range(l, u);
 }
 
 /*
- * 	We don't have a xor implementation yet.
- * 	To be in safe side, we just give maxrange as result.
+ *	Builds the graph of the function f alone in G and solves it. Its
+ *  parameters take the given ranges, or the full ones if there are none, and
+ *  the calls it makes the return ranges of their callees, narrowed down by
+ *  the ones found in their context. Returns the union of the return values
+ *  of f.
  */
-Range Range::Xor(const Range &other) const {
-  if (this->isUnknown() || other.isUnknown()) {
-    return Range(Min, Max, Unknown);
-  }
-
-  return Range(Min, Max);
-}
-
-// Truncate
-//		- if the source range is entirely inside max bit range, he is
-// the
-// result
-//      - else, the result is the max bit range
-Range Range::truncate(unsigned bitwidth) const {
-  APInt maxupper = APInt::getSignedMaxValue(bitwidth);
-  APInt maxlower = APInt::getSignedMinValue(bitwidth);
+template <class CGT>
+Range InterProceduralSummaryRA<CGT>::solveGraph(unsigned f,
+                                                ArrayRef<Range> params,
+                                                ConstraintGraph &G) {
+  const Function &F = *functions[f];
+  G.clear();
 
-  if (bitwidth < MAX_BIT_INT) {
-    maxupper = maxupper.sext(MAX_BIT_INT);
-    maxlower = maxlower.sext(MAX_BIT_INT);
+// Build the graph and find the intervals of the variables.
+#ifdef STATS
+  AnalysisContext &threadCtx = G.getContext();
+  Timer *timer =
+      threadCtx.prof.registerNewTimer("BuildGraph", "Build constraint graph");
+  timer->startTimer();
+#endif
+  G.buildGraph(F);
+  // The parameters, the calls and their arguments, and the return values
+  // need nodes, even if no operation uses them.
+  SmallVector<VarNode *, 4> paramNodes;
+  if (!params.empty()) {
+    for (const Argument &A : F.args()) {
+      paramNodes.push_back(A.getType()->isIntegerTy() ? G.addVarNode(&A)
+                                                      : nullptr);
+    }
+  }
+  SmallVector<VarNode *, 8> callNodes;
+  for (unsigned c = callBegin[f]; c < callBegin[f + 1]; ++c) {
+    CallSite CS(calls[c].first);
+    for (auto AI = CS.arg_begin(), EI = CS.arg_end(); AI != EI; ++AI) {
+      if ((*AI)->getType()->isIntegerTy()) {
+        G.addVarNode(*AI);
+      }
+    }
+    callNodes.push_back(calls[c].first->getType()->isIntegerTy()
+                            ? G.addVarNode(calls[c].first)
+                            : nullptr);
   }
-
-  // Check if source range is contained by max bit range
-  if (this->getLower().sge(maxlower) && this->getUpper().sle(maxupper)) {
-    return *this;
+  for (unsigned r = returnBegin[f]; r < returnBegin[f + 1]; ++r) {
+    G.addVarNode(returnValues[r]);
   }
-  return Range(maxlower, maxupper);
-}
-
-Range Range::sextOrTrunc(unsigned bitwidth) const { return truncate(bitwidth); }
+  G.buildVarNodes();
 
-Range Range::zextOrTrunc(unsigned bitwidth) const {
-  APInt maxupper = APInt::getSignedMaxValue(bitwidth);
-  APInt maxlower = APInt::getSignedMinValue(bitwidth);
-
-  if (bitwidth < MAX_BIT_INT) {
-    maxupper = maxupper.sext(MAX_BIT_INT);
-    maxlower = maxlower.sext(MAX_BIT_INT);
+  for (unsigned i = 0, e = paramNodes.size(); i < e; ++i) {
+    if (paramNodes[i] != nullptr) {
+      paramNodes[i]->setRange(params[i]);
+    }
   }
-
-  return Range(maxlower, maxupper);
-}
-
-Range Range::intersectWith(const Range &other) const {
-  if (this->isEmpty() || other.isEmpty()) {
-    return Range(Min, Max, Empty);
+  for (unsigned c = callBegin[f]; c < callBegin[f + 1]; ++c) {
+    if (callNodes[c - callBegin[f]] != nullptr) {
+      callNodes[c - callBegin[f]]->setRange(
+          summaries[calls[c].second].ret.intersectWith(contextRets[c]));
+    }
   }
+#ifdef STATS
+  timer->stopTimer();
+  threadCtx.prof.addTimeRecord(timer);
 
-  if (this->isUnknown()) {
-    return other;
-  }
+  threadCtx.prof.registerMemoryUsage();
+#endif
+#ifdef PRINT_DEBUG
+  G.printToFile(F, "/tmp/" + F.getName().str() + "cgpre.dot");
+#endif
+  G.findIntervals();
+#ifdef PRINT_DEBUG
+  G.printToFile(F, "/tmp/" + F.getName().str() + "cgpos.dot");
+#endif
 
-  if (other.isUnknown()) {
-    return *this;
+  Range ret(summaries[f].ret.getBitWidth(), Unknown);
+  for (unsigned r = returnBegin[f]; r < returnBegin[f + 1]; ++r) {
+    ret = ret.unionWith(G.getRange(returnValues[r]));
   }
-
-  APInt l = getLower().sgt(other.getLower()) ? getLower() : other.getLower();
-  APInt u = getUpper().slt(other.getUpper()) ? getUpper() : other.getUpper();
-  return Range(l, u);
+  return ret;
 }
 
-Range Range::unionWith(const Range &other) const {
-  if (this->isEmpty()) {
-    return other;
+/*
+ *	Solves the function f alone in G. Its parameters take the ranges of its
+ *  summary, and the calls it makes the return ranges of their callees. Going
+ *  top-down, the parameters are first computed again from the callers in
+ *  other components of the call graph, which were solved before in this
+ *  round. Going bottom-up, the callees in other components were. The
+ *  function is skipped if none of its inputs changed since it was last
+ *  solved.
+ */
+template <class CGT>
+bool InterProceduralSummaryRA<CGT>::solveFunction(unsigned f, bool topDown,
+                                                  ConstraintGraph &G) {
+  if (topDown) {
+    updateParameters(f);
+  }
+  Summary &summary = summaries[f];
+  bool inputsChanged =
+      summary.solved == 0 || summary.paramsChanged || summary.argsChanged;
+  for (unsigned c = callBegin[f]; c < callBegin[f + 1]; ++c) {
+    // A recursive call takes the return value f found the last time.
+    const unsigned retChanged = summaries[calls[c].second].retChanged;
+    inputsChanged |= retChanged > summary.solved ||
+                     (calls[c].second == f && retChanged == summary.solved);
+  }
+  if (!inputsChanged) {
+    return false;
   }
-
-  if (other.isEmpty()) {
-    return *this;
+  summary.paramsChanged = false;
+  summary.argsChanged = false;
+  summary.solved = ++clock;
+
+  // Solve again, with the arguments of their calls as parameters, the
+  // callees of the calls chosen for context sensitivity. The arguments
+  // found by the last solution of f are sound, so these return values are.
+  const Range *args = summary.callArgs.begin();
+  for (unsigned c = callBegin[f]; c < callBegin[f + 1]; ++c) {
+    const unsigned g = calls[c].second;
+    const unsigned numArgs = functions[g]->arg_size();
+    if (contextCalls[c] && !summary.callArgs.empty()) {
+      // Only the calls with narrower arguments than the other calls of g
+      // may find a narrower return value.
+      bool narrower = false;
+      for (const Argument &A : functions[g]->args()) {
+        narrower |= A.getType()->isIntegerTy() &&
+                    args[A.getArgNo()] != summaries[g].params[A.getArgNo()];
+      }
+      contextRets[c] = narrower
+                           ? solveGraph(g, makeArrayRef(args, numArgs), G)
+                           : Range(summaries[g].ret.getBitWidth());
+    }
+    if (!summary.callArgs.empty()) {
+      args += numArgs;
+    }
   }
 
-  if (this->isUnknown()) {
-    return other;
+  const Range ret = grow(
+      summary.ret,
+      solveGraph(f, summary.called ? summary.params : ArrayRef<Range>(), G),
+      summary.growth);
+  bool changed = ret != summary.ret;
+  if (changed) {
+    summary.ret = ret;
+    summary.retChanged = summary.solved;
   }
 
-  if (other.isUnknown()) {
-    return *this;
+  SmallVector<Range, 0> callArgs;
+  for (unsigned c = callBegin[f]; c < callBegin[f + 1]; ++c) {
+    CallSite CS(calls[c].first);
+    for (auto AI = CS.arg_begin(), EI = CS.arg_end(); AI != EI; ++AI) {
+      callArgs.push_back((*AI)->getType()->isIntegerTy() ? G.getRange(*AI)
+                                                         : Range(1));
+    }
+  }
+  if (callArgs.size() != summary.callArgs.size() ||
+      !std::equal(callArgs.begin(), callArgs.end(),
+                  summary.callArgs.begin())) {
+    summary.callArgs = std::move(callArgs);
+    changed = true;
+    // The calls chosen for context sensitivity take the new arguments in the
+    // next round.
+    for (unsigned c = callBegin[f]; c < callBegin[f + 1]; ++c) {
+      summary.argsChanged |= contextCalls[c];
+    }
   }
 
-  APInt l = getLower().slt(other.getLower()) ? getLower() : other.getLower();
-  APInt u = getUpper().sgt(other.getUpper()) ? getUpper() : other.getUpper();
-  return Range(l, u);
-}
-
-bool Range::operator==(const Range &other) const {
-  return this->type == other.type && getLower().eq(other.getLower()) &&
-         getUpper().eq(other.getUpper());
+  ranges.get(f).clear();
+  G.collectRanges(ranges.get(f));
+  return changed;
 }
 
-bool Range::operator!=(const Range &other) const {
-  return this->type != other.type || getLower().ne(other.getLower()) ||
-         getUpper().ne(other.getUpper());
+template <class CGT>
+void InterProceduralSummaryRA<CGT>::getAnalysisUsage(AnalysisUsage &AU) const {
+  AU.setPreservesAll();
 }
 
-void Range::print(raw_ostream &OS) const {
-  if (this->isUnknown()) {
-    OS << "Unknown";
-    return;
-  }
-
-  if (this->isEmpty()) {
-    OS << "Empty";
-    return;
-  }
-
-  if (getLower().eq(Min)) {
-    OS << "[-inf, ";
-  } else {
-    OS << "[" << getLower() << ", ";
-  }
+template <class CGT>
+InterProceduralSummaryRA<CGT>::~InterProceduralSummaryRA() {
+#ifdef STATS
+  ctx.prof.printTime("BuildGraph");
+  ctx.prof.printTime("Nuutila");
+  ctx.prof.printTime("SCCs resolution");
+  ctx.prof.printTime("ComputeStats");
+  ctx.prof.printMemoryUsage();
 
-  if (getUpper().eq(Max)) {
-    OS << "+inf]";
-  } else {
-    OS << getUpper() << "]";
-  }
+  std::ostringstream formated;
+  formated << 100 * (1.0 - (static_cast<double>(ctx.stats.needBits) /
+                            ctx.stats.usedBits));
+  errs() << formated.str() << "\t - "
+         << " Percentage of reduction\n";
+#endif
+  ctx.publishStatistics();
 }
 
-raw_ostream &operator<<(raw_ostream &OS, const Range &R) {
-  R.print(OS);
-  return OS;
-}
+static RegisterPass<IntraProceduralRA<Cousot>>
+    Y("ra-intra-cousot", "Range Analysis (Cousot - intra)");
+static RegisterPass<IntraProceduralRA<CropDFS>>
+    Z("ra-intra-crop", "Range Analysis (Crop - intra)");
+static RegisterPass<InterProceduralRA<Cousot>>
+    W("ra-inter-cousot", "Range Analysis (Cousot - inter)");
+static RegisterPass<InterProceduralRA<CropDFS>>
+    X("ra-inter-crop", "Range Analysis (Crop - inter)");
+static RegisterPass<IntraProceduralParallelRA<Cousot>>
+    V("ra-intra-parallel-cousot",
+      "Range Analysis (Cousot - intra, all functions in parallel)");
+static RegisterPass<IntraProceduralParallelRA<CropDFS>>
+    U("ra-intra-parallel-crop",
+      "Range Analysis (Crop - intra, all functions in parallel)");
+static RegisterPass<InterProceduralSummaryRA<Cousot>>
+    S("ra-inter-summary-cousot",
+      "Range Analysis (Cousot - inter, bottom-up summaries)");
+static RegisterPass<InterProceduralSummaryRA<CropDFS>>
+    T("ra-inter-summary-crop",
+      "Range Analysis (Crop - inter, bottom-up summaries)");
 
 // ========================================================================== //
 // BasicInterval
 // ========================================================================== //
 
-BasicInterval::BasicInterval(Range range) : range(std::move(range)) {}
-
-BasicInterval::BasicInterval() : range(Range(Min, Max)) {}
-
-BasicInterval::BasicInterval(const APInt &l, const APInt &u)
-    : range(Range(l, u)) {}
-
-// This is a base class, its dtor must be virtual.
-BasicInterval::~BasicInterval() = default;
-
 /// Pretty print.
-void BasicInterval::print(raw_ostream &OS) const { this->getRange().print(OS); }
+void BasicInterval::print(raw_ostream &OS) const {
+  if (const SymbInterval *SI = dyn_cast<SymbInterval>(this)) {
+    SI->print(OS);
+    return;
+  }
+  this->getRange().print(OS);
+}
 
 // ========================================================================== //
 // SymbInterval
 // ========================================================================== //
 
-SymbInterval::SymbInterval(const Range &range, const Value *bound,
-                           CmpInst::Predicate pred)
-    : BasicInterval(range), bound(bound), pred(pred) {}
-
-SymbInterval::~SymbInterval() = default;
-
-Range SymbInterval::fixIntersects(VarNode *bound, VarNode *sink) {
-  // Get the lower and the upper bound of the
-  // node which bounds this intersection.
-  APInt l = bound->getRange().getLower();
-  APInt u = bound->getRange().getUpper();
-
-  // Get the lower and upper bound of the interval of this operation
-  APInt lower = sink->getRange().getLower();
-  APInt upper = sink->getRange().getUpper();
-
-  switch (this->getOperation()) {
-  case ICmpInst::ICMP_EQ: // equal
-    return Range(l, u);
-    break;
-  case ICmpInst::ICMP_SLE: // signed less or equal
-    return Range(lower, u);
-    break;
-  case ICmpInst::ICMP_SLT: // signed less than
-    if (u != Max) {
-      return Range(lower, u - 1);
-    } else {
-      return Range(lower, u);
-    }
-    break;
-  case ICmpInst::ICMP_SGE: // signed greater or equal
-    return Range(l, upper);
-    break;
-  case ICmpInst::ICMP_SGT: // signed greater than
-    if (l != Min) {
-      return Range(l + 1, upper);
-    } else {
-      return Range(l, upper);
-    }
-    break;
-  default:
-    return Range(Min, Max);
-  }
-
-  return Range(Min, Max);
-}
-
 /// Pretty print.
 void SymbInterval::print(raw_ostream &OS) const {
   switch (this->getOperation()) {
@@ -1411,27 +1520,22 @@ void SymbInterval::print(raw_ostream &OS) const {
 // ========================================================================== //
 
 /// The ctor.
-VarNode::VarNode(const Value *V)
-    : V(V), interval(Range(Min, Max, Unknown)), abstractState(0) {}
-
-/// The dtor.
-VarNode::~VarNode() = default;
+VarNode::VarNode(const Value *V, BoundsTable *bounds)
+    : V(V), bounds(bounds),
+      id(bounds->add(Range(RangeAnalysis::getBitWidth(V), Unknown))),
+      abstractState(0), constant(isa<ConstantInt>(V)) {}
 
 /// Initializes the value of the node.
 void VarNode::init(bool outside) {
   const Value *V = this->getValue();
   if (const ConstantInt *CI = dyn_cast<ConstantInt>(V)) {
-    APInt tmp = CI->getValue();
-    if (tmp.getBitWidth() < MAX_BIT_INT) {
-      tmp = tmp.sext(MAX_BIT_INT);
-    }
-    this->setRange(Range(tmp, tmp));
+    this->setRange(Range(CI->getValue(), CI->getValue()));
   } else {
     if (!outside) {
       // Initialize with a basic, unknown, interval.
-      this->setRange(Range(Min, Max, Unknown));
+      this->setRange(Range(getBitWidth(), Unknown));
     } else {
-      this->setRange(Range(Min, Max));
+      this->setRange(Range(getBitWidth()));
     }
   }
 }
@@ -1447,23 +1551,6 @@ void VarNode::print(raw_ostream &OS) const {
   this->getRange().print(OS);
 }
 
-void VarNode::storeAbstractState() {
-  ASSERT(!this->interval.isUnknown(),
-         "storeAbstractState doesn't handle empty set")
-
-  if (this->interval.getLower().eq(Min)) {
-    if (this->interval.getUpper().eq(Max)) {
-      this->abstractState = '?';
-    } else {
-      this->abstractState = '-';
-    }
-  } else if (this->interval.getUpper().eq(Max)) {
-    this->abstractState = '+';
-  } else {
-    this->abstractState = '0';
-  }
-}
-
 raw_ostream &operator<<(raw_ostream &OS, const VarNode *VN) {
   VN->print(OS);
   return OS;
@@ -1473,85 +1560,31 @@ raw_ostream &operator<<(raw_ostream &OS, const VarNode *VN) {
 // BasicOp
 // ========================================================================== //
 
-/// We can not want people creating objects of this class,
-/// but we want to inherit of it.
-BasicOp::BasicOp(BasicInterval *intersect, VarNode *sink,
-                 const Instruction *inst)
-    : intersect(intersect), sink(sink), inst(inst) {}
-
-/// We can not want people creating objects of this class,
-/// but we want to inherit of it.
-BasicOp::~BasicOp() { delete intersect; }
-
-/// Replace symbolic intervals with hard-wired constants.
-void BasicOp::fixIntersects(VarNode *V) {
-  if (SymbInterval *SI = dyn_cast<SymbInterval>(getIntersect())) {
-    Range r = SI->fixIntersects(V, getSink());
-    this->setIntersect(SI->fixIntersects(V, getSink()));
+/// Prints the operation according to its kind.
+void BasicOp::print(raw_ostream &OS) const {
+  switch (kind) {
+  case OperationId::UnaryOpId:
+    static_cast<const UnaryOp *>(this)->print(OS);
+    break;
+  case OperationId::SigmaOpId:
+    static_cast<const SigmaOp *>(this)->print(OS);
+    break;
+  case OperationId::BinaryOpId:
+    static_cast<const BinaryOp *>(this)->print(OS);
+    break;
+  case OperationId::TernaryOpId:
+    static_cast<const TernaryOp *>(this)->print(OS);
+    break;
+  case OperationId::PhiOpId:
+    static_cast<const PhiOp *>(this)->print(OS);
+    break;
   }
 }
 
-// ========================================================================== //
-// ControlDep
-// ========================================================================== //
-
-ControlDep::ControlDep(VarNode *sink, VarNode *source)
-    : BasicOp(new BasicInterval(), sink, nullptr), source(source) {}
-
-ControlDep::~ControlDep() = default;
-
-Range ControlDep::eval() const { return Range(Min, Max); }
-
-void ControlDep::print(raw_ostream & /*OS*/) const {}
-
 // ========================================================================== //
 // UnaryOp
 // ========================================================================== //
 
-UnaryOp::UnaryOp(BasicInterval *intersect, VarNode *sink,
-                 const Instruction *inst, VarNode *source, unsigned int opcode)
-    : BasicOp(intersect, sink, inst), source(source), opcode(opcode) {}
-
-// The dtor.
-UnaryOp::~UnaryOp() = default;
-
-/// Computes the interval of the sink based on the interval of the sources,
-/// the operation and the interval associated to the operation.
-Range UnaryOp::eval() const {
-
-  unsigned bw = getSink()->getValue()->getType()->getPrimitiveSizeInBits();
-  Range oprnd = source->getRange();
-  Range result(Min, Max, Unknown);
-
-  if (oprnd.isRegular()) {
-    switch (this->getOpcode()) {
-    case Instruction::Trunc:
-      result = oprnd.truncate(bw);
-      break;
-    case Instruction::ZExt:
-      result = oprnd.zextOrTrunc(bw);
-      break;
-    case Instruction::SExt:
-      result = oprnd.sextOrTrunc(bw);
-      break;
-    default:
-      // Loads and Stores are handled here.
-      result = oprnd;
-      break;
-    }
-  } else if (oprnd.isEmpty()) {
-    result = Range(Min, Max, Empty);
-  }
-
-  if (!getIntersect()->getRange().isMaxRange()) {
-    Range aux(getIntersect()->getRange());
-    result = result.intersectWith(aux);
-  }
-
-  // To ensure that we always are dealing with the correct bit width.
-  return result;
-}
-
 /// Prints the content of the operation. I didn't it an operator overload
 /// because I had problems to access the members of the class outside it.
 void UnaryOp::print(raw_ostream &OS) const {
@@ -1598,20 +1631,6 @@ void UnaryOp::print(raw_ostream &OS) const {
 // SigmaOp
 // ========================================================================== //
 
-SigmaOp::SigmaOp(BasicInterval *intersect, VarNode *sink,
-                 const Instruction *inst, VarNode *source, unsigned int opcode)
-    : UnaryOp(intersect, sink, inst, source, opcode), unresolved(false) {}
-
-/// Computes the interval of the sink based on the interval of the sources,
-/// the operation and the interval associated to the operation.
-Range SigmaOp::eval() const {
-  Range result = this->getSource()->getRange();
-
-  result = result.intersectWith(getIntersect()->getRange());
-
-  return result;
-}
-
 /// Prints the content of the operation. I didn't it an operator overload
 /// because I had problems to access the members of the class outside it.
 void SigmaOp::print(raw_ostream &OS) const {
@@ -1638,98 +1657,6 @@ void SigmaOp::print(raw_ostream &OS) const {
 // BinaryOp
 // ========================================================================== //
 
-// The ctor.
-BinaryOp::BinaryOp(BasicInterval *intersect, VarNode *sink,
-                   const Instruction *inst, VarNode *source1, VarNode *source2,
-                   unsigned int opcode)
-    : BasicOp(intersect, sink, inst), source1(source1), source2(source2),
-      opcode(opcode) {}
-
-/// Computes the interval of the sink based on the interval of the sources,
-/// the operation and the interval associated to the operation.
-/// Basically, this function performs the operation indicated in its opcode
-/// taking as its operands the source1 and the source2.
-Range BinaryOp::eval() const {
-
-  Range op1 = this->getSource1()->getRange();
-  Range op2 = this->getSource2()->getRange();
-  Range result(Min, Max, Unknown);
-
-  // only evaluate if all operands are Regular
-  if (op1.isRegular() && op2.isRegular()) {
-    switch (this->getOpcode()) {
-    case Instruction::Add:
-      result = op1.add(op2);
-      break;
-    case Instruction::Sub:
-      result = op1.sub(op2);
-      break;
-    case Instruction::Mul:
-      result = op1.mul(op2);
-      break;
-    case Instruction::UDiv:
-      result = op1.udiv(op2);
-      break;
-    case Instruction::SDiv:
-      result = op1.sdiv(op2);
-      break;
-    case Instruction::URem:
-      result = op1.urem(op2);
-      break;
-    case Instruction::SRem:
-      result = op1.srem(op2);
-      break;
-    case Instruction::Shl:
-      result = op1.shl(op2);
-      break;
-    case Instruction::LShr:
-      result = op1.lshr(op2);
-      break;
-    case Instruction::AShr:
-      result = op1.ashr(op2);
-      break;
-    case Instruction::And:
-      result = op1.And(op2);
-      break;
-    case Instruction::Or:
-      // We have two versions of the 'or' operator
-      // One of them gives tight results, but only works
-      // for 64-bit values or less.
-      if (MAX_BIT_INT <= 64) {
-        result = op1.Or(op2);
-      } else {
-        result = op1.Or_conservative(op2);
-      }
-      break;
-    case Instruction::Xor:
-      result = op1.Xor(op2);
-      break;
-    default:
-      break;
-    }
-
-    // If resulting interval has become inconsistent, set it to max range for
-    // safety
-    if (result.getLower().sgt(result.getUpper())) {
-      result = Range(Min, Max);
-    }
-
-    // FIXME: check if this intersection happens
-    bool test = this->getIntersect()->getRange().isMaxRange();
-
-    if (!test) {
-      Range aux = this->getIntersect()->getRange();
-      result = result.intersectWith(aux);
-    }
-  } else {
-    if (op1.isEmpty() || op2.isEmpty()) {
-      result = Range(Min, Max, Empty);
-    }
-  }
-
-  return result;
-}
-
 /// Pretty print.
 void BinaryOp::print(raw_ostream &OS) const {
   const char *quot = R"(")";
@@ -1764,59 +1691,6 @@ void BinaryOp::print(raw_ostream &OS) const {
 // TernaryOp
 // ========================================================================== //
 
-// The ctor.
-TernaryOp::TernaryOp(BasicInterval *intersect, VarNode *sink,
-                     const Instruction *inst, VarNode *source1,
-                     VarNode *source2, VarNode *source3, unsigned int opcode)
-    : BasicOp(intersect, sink, inst), source1(source1), source2(source2),
-      source3(source3), opcode(opcode) {}
-
-Range TernaryOp::eval() const {
-
-  Range op1 = this->getSource1()->getRange();
-  Range op2 = this->getSource2()->getRange();
-  Range op3 = this->getSource3()->getRange();
-  Range result(Min, Max, Unknown);
-
-  // only evaluate if all operands are Regular
-  if (op1.isRegular() && op2.isRegular() && op3.isRegular()) {
-    switch (this->getOpcode()) {
-    case Instruction::Select: {
-      // Source1 is the selector
-      if (op1 == Range(One, One)) {
-        result = op2;
-      } else if (op1 == Range(Zero, Zero)) {
-        result = op3;
-      } else {
-        result = op2.unionWith(op3);
-      }
-    } break;
-    default:
-      break;
-    }
-
-    // If resulting interval has become inconsistent, set it to max range for
-    // safety
-    if (result.getLower().sgt(result.getUpper())) {
-      result = Range(Min, Max);
-    }
-
-    // FIXME: check if this intersection happens
-    bool test = this->getIntersect()->getRange().isMaxRange();
-
-    if (!test) {
-      Range aux = this->getIntersect()->getRange();
-      result = result.intersectWith(aux);
-    }
-  } else {
-    if (op1.isEmpty() || op2.isEmpty() || op3.isEmpty()) {
-      result = Range(Min, Max, Empty);
-    }
-  }
-
-  return result;
-}
-
 /// Pretty print.
 void TernaryOp::print(raw_ostream &OS) const {
   const char *quot = R"(")";
@@ -1860,30 +1734,6 @@ void TernaryOp::print(raw_ostream &OS) const {
 // PhiOp
 // ========================================================================== //
 
-// The ctor.
-PhiOp::PhiOp(BasicInterval *intersect, VarNode *sink, const Instruction *inst)
-    : BasicOp(intersect, sink, inst) {}
-
-// Add source to the vector of sources
-void PhiOp::addSource(const VarNode *newsrc) {
-  this->sources.push_back(newsrc);
-}
-
-/// Computes the interval of the sink based on the interval of the sources.
-/// The result of evaluating a phi-function is the union of the ranges of
-/// every variable used in the phi.
-Range PhiOp::eval() const {
-
-  Range result = this->getSource(0)->getRange();
-
-  // Iterate over the sources of the phiop
-  for (const VarNode *varNode : sources) {
-    result = result.unionWith(varNode->getRange());
-  }
-
-  return result;
-}
-
 /// Prints the content of the operation. I didn't it an operator overload
 /// because I had problems to access the members of the class outside it.
 void PhiOp::print(raw_ostream &OS) const {
@@ -1892,8 +1742,8 @@ void PhiOp::print(raw_ostream &OS) const {
   OS << "phi";
   OS << "\"]\n";
 
-  for (const VarNode *varNode : sources) {
-    const Value *V = varNode->getValue();
+  for (unsigned i = 0; i < numSources; ++i) {
+    const Value *V = phiSources[i]->getValue();
     if (const ConstantInt *C = dyn_cast<ConstantInt>(V)) {
       OS << " " << C->getValue() << " -> " << quot << this << quot << "\n";
     } else {
@@ -1910,113 +1760,61 @@ void PhiOp::print(raw_ostream &OS) const {
 }
 
 // ========================================================================== //
-// ValueBranchMap
+// ConstraintGraph
 // ========================================================================== //
 
-ValueBranchMap::ValueBranchMap(const Value *V, const BasicBlock *BBTrue,
-                               const BasicBlock *BBFalse, BasicInterval *ItvT,
-                               BasicInterval *ItvF)
-    : V(V), BBTrue(BBTrue), BBFalse(BBFalse), ItvT(ItvT), ItvF(ItvF) {}
-
-ValueBranchMap::~ValueBranchMap() = default;
-
-void ValueBranchMap::clear() {
-  if (ItvT != nullptr) {
-    delete ItvT;
-    ItvT = nullptr;
-  }
+Range ConstraintGraph::getRange(const Value *v) {
+  VarNodes::iterator vit = this->vars.find(v);
 
-  if (ItvF != nullptr) {
-    delete ItvF;
-    ItvF = nullptr;
+  if (vit == this->vars.end()) {
+    return getUncoveredRange(v);
   }
-}
-
-// ========================================================================== //
-// ValueSwitchMap
-// ========================================================================== //
-
-ValueSwitchMap::ValueSwitchMap(
-    const Value *V,
-    SmallVector<std::pair<BasicInterval *, const BasicBlock *>, 4> &BBsuccs)
-    : V(V), BBsuccs(BBsuccs) {}
 
-ValueSwitchMap::~ValueSwitchMap() = default;
-
-void ValueSwitchMap::clear() {
-  for (auto &succ : BBsuccs) {
-    if (succ.first != nullptr) {
-      delete succ.first;
-      succ.first = nullptr;
-    }
-  }
+  return vit->second->getRange();
 }
 
-// ========================================================================== //
-// ConstraintGraph
-// ========================================================================== //
-
-/// The dtor.
-ConstraintGraph::~ConstraintGraph() {
-  for (auto &pair : vars) {
-    delete pair.second;
-  }
-
-  for (BasicOp *op : oprs) {
-    delete op;
+Range ConstraintGraph::getUncoveredRange(const Value *v) {
+  // If the value doesn't have a range,
+  // it wasn't considered by the range analysis
+  // for some reason.
+  // It gets an unknown range if it's a variable,
+  // or the tight range if it's a constant
+  //
+  // I decided NOT to insert these uncovered
+  // values to the node set after their range
+  // is created here.
+  const ConstantInt *ci = dyn_cast<ConstantInt>(v);
+  if (ci == nullptr) {
+    return Range(RangeAnalysis::getBitWidth(v), Unknown);
   }
 
-  for (auto &pair : valuesBranchMap) {
-    pair.second.clear();
-  }
-
-  for (auto &pair : valuesSwitchMap) {
-    pair.second.clear();
-  }
+  return Range(ci->getValue(), ci->getValue());
 }
 
-Range ConstraintGraph::getRange(const Value *v) {
-  VarNodes::iterator vit = this->vars.find(v);
-
-  if (vit == this->vars.end()) {
-    // If the value doesn't have a range,
-    // it wasn't considered by the range analysis
-    // for some reason.
-    // It gets an unknown range if it's a variable,
-    // or the tight range if it's a constant
-    //
-    // I decided NOT to insert these uncovered
-    // values to the node set after their range
-    // is created here.
-    const ConstantInt *ci = dyn_cast<ConstantInt>(v);
-    if (ci == nullptr) {
-      return Range(Min, Max, Unknown);
-    }
-    APInt tmp = ci->getValue();
-    if (tmp.getBitWidth() < MAX_BIT_INT) {
-      tmp = tmp.sext(MAX_BIT_INT);
+void ConstraintGraph::collectRanges(
+    DenseMap<const Value *, Range> &ranges) const {
+  ranges.reserve(ranges.size() + vars.size());
+  for (const auto &pair : vars) {
+    if (isa<Argument>(pair.first) || isa<Instruction>(pair.first)) {
+      ranges.try_emplace(pair.first, pair.second->getRange());
     }
-
-    return Range(tmp, tmp);
   }
-
-  return vit->second->getRange();
 }
 
 /// Adds a VarNode to the graph.
 VarNode *ConstraintGraph::addVarNode(const Value *V) {
-  VarNodes::iterator vit = this->vars.find(V);
+  std::pair<VarNodes::iterator, bool> vit = this->vars.try_emplace(V);
 
-  if (vit != this->vars.end()) {
-    return vit->second;
+  if (!vit.second) {
+    return vit.first->second;
   }
 
-  VarNode *node = new VarNode(V);
-  this->vars.insert(std::make_pair(V, node));
+  VarNode *node = new (arena.Allocate<VarNode>()) VarNode(V, &bounds);
+  vit.first->second = node;
+  this->nodes.push_back(node);
 
   // Inserts the node in the use map list.
-  SmallPtrSet<BasicOp *, 8> useList;
-  this->useMap.insert(std::make_pair(V, useList));
+  this->useMap.try_emplace(V);
   return node;
 }
 
@@ -2045,24 +1843,24 @@ void ConstraintGraph::addUnaryOp(const Instruction *I) {
 
 #ifndef OVERFLOWHANDLER
   // Create the operation using the intersect to constrain sink's interval.
-  UOp = new UnaryOp(new BasicInterval(), sink, I, source, I->getOpcode());
+  UOp = createOp<UnaryOp>(createInterval<BasicInterval>(sink->getBitWidth()),
+                          sink, I, source, I->getOpcode());
 #else
   // I can only be an Add instruction if it is a newdef overflow instruction
   if (I->getOpcode() == Instruction::Add) {
     BasicBlock::const_iterator it(I);
     --it;
 
+    const unsigned bw = sink->getBitWidth();
     APInt constant;
-    APInt lower = Min, upper = Max;
+    APInt lower = APInt::getSignedMinValue(bw);
+    APInt upper = APInt::getSignedMaxValue(bw);
     APInt candidates[2];
-    Range result;
 
     switch (it->getOpcode()) {
     case Instruction::Add:
-      constant = cast<ConstantInt>(it->getOperand(1))->getValue();
-      if (constant.getBitWidth() < MAX_BIT_INT) {
-        constant = constant.sext(MAX_BIT_INT);
-      }
+      constant =
+          cast<ConstantInt>(it->getOperand(1))->getValue().sextOrTrunc(bw);
 
       if (constant.isStrictlyPositive()) {
         upper -= constant;
@@ -2070,15 +1868,13 @@ void ConstraintGraph::addUnaryOp(const Instruction *I) {
         lower -= constant;
       }
 
-      UOp = new UnaryOp(new BasicInterval(lower, upper), sink, I, source,
-                        I->getOpcode());
+      UOp = createOp<UnaryOp>(createInterval<BasicInterval>(lower, upper), sink,
+                              I, source, I->getOpcode());
       break;
 
     case Instruction::Sub:
-      constant = cast<ConstantInt>(it->getOperand(1))->getValue();
-      if (constant.getBitWidth() < MAX_BIT_INT) {
-        constant = constant.sext(MAX_BIT_INT);
-      }
+      constant =
+          cast<ConstantInt>(it->getOperand(1))->getValue().sextOrTrunc(bw);
 
       if (constant.isStrictlyPositive()) {
         lower += constant;
@@ -2086,15 +1882,13 @@ void ConstraintGraph::addUnaryOp(const Instruction *I) {
         upper += constant;
       }
 
-      UOp = new UnaryOp(new BasicInterval(lower, upper), sink, I, source,
-                        I->getOpcode());
+      UOp = createOp<UnaryOp>(createInterval<BasicInterval>(lower, upper), sink,
+                              I, source, I->getOpcode());
       break;
 
     case Instruction::Mul:
-      constant = cast<ConstantInt>(it->getOperand(1))->getValue();
-      if (constant.getBitWidth() < MAX_BIT_INT) {
-        constant = constant.sext(MAX_BIT_INT);
-      }
+      constant =
+          cast<ConstantInt>(it->getOperand(1))->getValue().sextOrTrunc(bw);
 
       candidates[0] = lower.sdiv(constant);
       candidates[1] = upper.sdiv(constant);
@@ -2107,33 +1901,28 @@ void ConstraintGraph::addUnaryOp(const Instruction *I) {
         candidates[1] = swap;
       }
 
-      UOp = new UnaryOp(new BasicInterval(candidates[0], candidates[1]), sink,
-                        I, source, I->getOpcode());
+      UOp = createOp<UnaryOp>(
+          createInterval<BasicInterval>(candidates[0], candidates[1]), sink, I,
+          source, I->getOpcode());
       break;
 
     case Instruction::Trunc:
       const TruncInst *trunc = cast<TruncInst>(it);
       unsigned numbits = trunc->getType()->getPrimitiveSizeInBits();
 
-      APInt minvalue = APInt::getSignedMinValue(numbits);
-      if (minvalue.getBitWidth() < MAX_BIT_INT) {
-        minvalue = minvalue.sext(MAX_BIT_INT);
-      }
-
-      APInt maxvalue = APInt::getSignedMaxValue(numbits);
-      if (maxvalue.getBitWidth() < MAX_BIT_INT) {
-        maxvalue = maxvalue.sext(MAX_BIT_INT);
-      }
+      APInt minvalue = APInt::getSignedMinValue(numbits).sextOrTrunc(bw);
+      APInt maxvalue = APInt::getSignedMaxValue(numbits).sextOrTrunc(bw);
 
       Range truncInterval(minvalue, maxvalue, Regular);
 
-      UOp = new UnaryOp(new BasicInterval(truncInterval), sink, I, source,
-                        I->getOpcode());
+      UOp = createOp<UnaryOp>(createInterval<BasicInterval>(truncInterval),
+                              sink, I, source, I->getOpcode());
       break;
     }
   } else {
     // Create the operation using the intersect to constrain sink's interval.
-    UOp = new UnaryOp(new BasicInterval(), sink, I, source, I->getOpcode());
+    UOp = createOp<UnaryOp>(createInterval<BasicInterval>(sink->getBitWidth()),
+                            sink, I, source, I->getOpcode());
   }
 #endif
 
@@ -2160,8 +1949,9 @@ void ConstraintGraph::addBinaryOp(const Instruction *I) {
   VarNode *source2 = addVarNode(I->getOperand(1));
 
   // Create the operation using the intersect to constrain sink's interval.
-  BasicInterval *BI = new BasicInterval();
-  BinaryOp *BOp = new BinaryOp(BI, sink, I, source1, source2, I->getOpcode());
+  BasicInterval *BI = createInterval<BasicInterval>(sink->getBitWidth());
+  BinaryOp *BOp =
+      createOp<BinaryOp>(BI, sink, I, source1, source2, I->getOpcode());
 
   // Insert the operation in the graph.
   this->oprs.insert(BOp);
@@ -2185,9 +1975,10 @@ void ConstraintGraph::addTernaryOp(const Instruction *I) {
   VarNode *source3 = addVarNode(I->getOperand(2));
 
   // Create the operation using the intersect to constrain sink's interval.
-  BasicInterval *BI = new BasicInterval();
+  BasicInterval *BI = createInterval<BasicInterval>(sink->getBitWidth());
   TernaryOp *TOp =
-      new TernaryOp(BI, sink, I, source1, source2, source3, I->getOpcode());
+      createOp<TernaryOp>(BI, sink, I, source1, source2, source3,
+                          I->getOpcode());
 
   // Insert the operation in the graph.
   this->oprs.insert(TOp);
@@ -2205,7 +1996,9 @@ void ConstraintGraph::addTernaryOp(const Instruction *I) {
 void ConstraintGraph::addPhiOp(const PHINode *Phi) {
   // Create the sink.
   VarNode *sink = addVarNode(Phi);
-  PhiOp *phiOp = new PhiOp(new BasicInterval(), sink, Phi);
+  PhiOp *phiOp =
+      createPhiOp(createInterval<BasicInterval>(sink->getBitWidth()), sink,
+                  Phi, Phi->getNumOperands());
 
   // Insert the operation in the graph.
   this->oprs.insert(phiOp);
@@ -2225,6 +2018,13 @@ void ConstraintGraph::addPhiOp(const PHINode *Phi) {
 
 void ConstraintGraph::addSigmaOp(const PHINode *Sigma) {
   assert(Sigma->getNumOperands() == 1U);
+  // The nodes are created in the order of the instructions, as the others
+  addVarNode(Sigma);
+  addVarNode(Sigma->getOperand(0));
+  pendingSigmas.push_back(Sigma);
+}
+
+void ConstraintGraph::buildSigmaOp(const PHINode *Sigma) {
   // Create the sink.
   VarNode *sink = addVarNode(Sigma);
   BasicInterval *BItv = nullptr;
@@ -2272,10 +2072,12 @@ void ConstraintGraph::addSigmaOp(const PHINode *Sigma) {
     }
 
     if (BItv == nullptr) {
-      sigmaOp = new SigmaOp(new BasicInterval(), sink, Sigma, source,
-                            Sigma->getOpcode());
+      sigmaOp = createOp<SigmaOp>(
+          createInterval<BasicInterval>(sink->getBitWidth()), sink, Sigma,
+          source, Sigma->getOpcode());
     } else {
-      sigmaOp = new SigmaOp(BItv, sink, Sigma, source, Sigma->getOpcode());
+      sigmaOp =
+          createOp<SigmaOp>(BItv, sink, Sigma, source, Sigma->getOpcode());
     }
 
     // Insert the operation in the graph.
@@ -2341,6 +2143,21 @@ void ConstraintGraph::buildOperations(const Instruction *I) {
   }
 }
 
+/*
+ * Moves a branch interval to the operand of a cast. We do not know whether the
+ * cast extends with sign or zeros, so an interval that does not fit in the
+ * operand's width tells us nothing about it.
+ */
+static Range getCastOperandRange(const Range &R, const Value *V) {
+  const unsigned bitwidth = RangeAnalysis::getBitWidth(V);
+  if (R.isRegular() && bitwidth < R.getBitWidth() &&
+      ((!R.isLowerMin() && !R.getLower().isSignedIntN(bitwidth)) ||
+       (!R.isUpperMax() && !R.getUpper().isSignedIntN(bitwidth)))) {
+    return Range(bitwidth);
+  }
+  return R.resize(bitwidth);
+}
+
 void ConstraintGraph::buildValueSwitchMap(const SwitchInst *sw) {
   const Value *condition = sw->getCondition();
 
@@ -2368,13 +2185,10 @@ void ConstraintGraph::buildValueSwitchMap(const SwitchInst *sw) {
   BasicBlock *succ = sw->getDefaultDest();
 
   if (succ != nullptr) {
-    APInt sigMin = Min;
-    APInt sigMax = Max;
-
-    Range Values = Range(sigMin, sigMax);
+    Range Values = Range(RangeAnalysis::getBitWidth(condition));
 
     // Create the interval using the intersection in the branch.
-    BasicInterval *BI = new BasicInterval(Values);
+    BasicInterval *BI = createInterval<BasicInterval>(Values);
 
     BBsuccs.push_back(std::make_pair(BI, succ));
   }
@@ -2391,21 +2205,10 @@ void ConstraintGraph::buildValueSwitchMap(const SwitchInst *sw) {
     APInt sigMin = constant->getValue();
     APInt sigMax = sigMin;
 
-    if (sigMin.getBitWidth() < MAX_BIT_INT) {
-      sigMin = sigMin.sext(MAX_BIT_INT);
-    }
-    if (sigMax.getBitWidth() < MAX_BIT_INT) {
-      sigMax = sigMax.sext(MAX_BIT_INT);
-    }
-
-    //		if (sigMax.slt(sigMin)) {
-    //			sigMax = APInt::getSignedMaxValue(MAX_BIT_INT);
-    //		}
-
     Range Values = Range(sigMin, sigMax);
 
     // Create the interval using the intersection in the branch.
-    BasicInterval *BI = new BasicInterval(Values);
+    BasicInterval *BI = createInterval<BasicInterval>(Values);
 
     BBsuccs.push_back(std::make_pair(BI, succ));
   }
@@ -2414,6 +2217,12 @@ void ConstraintGraph::buildValueSwitchMap(const SwitchInst *sw) {
   valuesSwitchMap.insert(std::make_pair(condition, VSM));
 
   if (Op0_0 != nullptr) {
+    // The operand of the cast gets its own intervals, in its own width.
+    for (auto &BBsucc : BBsuccs) {
+      BBsucc.first = createInterval<BasicInterval>(
+          getCastOperandRange(BBsucc.first->getRange(), Op0_0));
+    }
+
     ValueSwitchMap VSM_0(Op0_0, BBsuccs);
     valuesSwitchMap.insert(std::make_pair(Op0_0, VSM_0));
   }
@@ -2487,15 +2296,8 @@ void ConstraintGraph::buildValueBranchMap(const BranchInst *br) {
     APInt sigMin = tmpT.getSignedMin();
     APInt sigMax = tmpT.getSignedMax();
 
-    if (sigMin.getBitWidth() < MAX_BIT_INT) {
-      sigMin = sigMin.sext(MAX_BIT_INT);
-    }
-    if (sigMax.getBitWidth() < MAX_BIT_INT) {
-      sigMax = sigMax.sext(MAX_BIT_INT);
-    }
-
     if (sigMax.slt(sigMin)) {
-      sigMax = Max;
+      sigMax = APInt::getSignedMaxValue(sigMax.getBitWidth());
     }
 
     Range TValues = Range(sigMin, sigMax);
@@ -2505,22 +2307,15 @@ void ConstraintGraph::buildValueBranchMap(const BranchInst *br) {
     sigMin = tmpF.getSignedMin();
     sigMax = tmpF.getSignedMax();
 
-    if (sigMin.getBitWidth() < MAX_BIT_INT) {
-      sigMin = sigMin.sext(MAX_BIT_INT);
-    }
-    if (sigMax.getBitWidth() < MAX_BIT_INT) {
-      sigMax = sigMax.sext(MAX_BIT_INT);
-    }
-
     if (sigMax.slt(sigMin)) {
-      sigMax = Max;
+      sigMax = APInt::getSignedMaxValue(sigMax.getBitWidth());
     }
 
     Range FValues = Range(sigMin, sigMax);
 
     // Create the interval using the intersection in the branch.
-    BasicInterval *BT = new BasicInterval(TValues);
-    BasicInterval *BF = new BasicInterval(FValues);
+    BasicInterval *BT = createInterval<BasicInterval>(TValues);
+    BasicInterval *BF = createInterval<BasicInterval>(FValues);
 
     ValueBranchMap VBM(variable, TBlock, FBlock, BT, BF);
     valuesBranchMap.insert(std::make_pair(variable, VBM));
@@ -2531,8 +2326,10 @@ void ConstraintGraph::buildValueBranchMap(const BranchInst *br) {
     if ((castinst = dyn_cast<CastInst>(variable)) != nullptr) {
       const Value *variable_0 = castinst->getOperand(0);
 
-      BasicInterval *BT = new BasicInterval(TValues);
-      BasicInterval *BF = new BasicInterval(FValues);
+      BasicInterval *BT = createInterval<BasicInterval>(
+          getCastOperandRange(TValues, variable_0));
+      BasicInterval *BF = createInterval<BasicInterval>(
+          getCastOperandRange(FValues, variable_0));
 
       ValueBranchMap VBM(variable_0, TBlock, FBlock, BT, BF);
       valuesBranchMap.insert(std::make_pair(variable_0, VBM));
@@ -2544,11 +2341,11 @@ void ConstraintGraph::buildValueBranchMap(const BranchInst *br) {
     CmpInst::Predicate pred = ici->getPredicate();
     CmpInst::Predicate invPred = ici->getInversePredicate();
 
-    Range CR(Min, Max, Unknown);
+    Range CR(RangeAnalysis::getBitWidth(Op0), Unknown);
 
     // Symbolic intervals for op0
-    SymbInterval *STOp0 = new SymbInterval(CR, Op1, pred);
-    SymbInterval *SFOp0 = new SymbInterval(CR, Op1, invPred);
+    SymbInterval *STOp0 = createInterval<SymbInterval>(CR, Op1, pred);
+    SymbInterval *SFOp0 = createInterval<SymbInterval>(CR, Op1, invPred);
 
     ValueBranchMap VBMOp0(Op0, TBlock, FBlock, STOp0, SFOp0);
     valuesBranchMap.insert(std::make_pair(Op0, VBMOp0));
@@ -2557,17 +2354,18 @@ void ConstraintGraph::buildValueBranchMap(const BranchInst *br) {
     const CastInst *castinst = nullptr;
     if ((castinst = dyn_cast<CastInst>(Op0)) != nullptr) {
       const Value *Op0_0 = castinst->getOperand(0);
+      Range CR_0(RangeAnalysis::getBitWidth(Op0_0), Unknown);
 
-      SymbInterval *STOp1_1 = new SymbInterval(CR, Op1, pred);
-      SymbInterval *SFOp1_1 = new SymbInterval(CR, Op1, invPred);
+      SymbInterval *STOp1_1 = createInterval<SymbInterval>(CR_0, Op1, pred);
+      SymbInterval *SFOp1_1 = createInterval<SymbInterval>(CR_0, Op1, invPred);
 
       ValueBranchMap VBMOp1_1(Op0_0, TBlock, FBlock, STOp1_1, SFOp1_1);
       valuesBranchMap.insert(std::make_pair(Op0_0, VBMOp1_1));
     }
 
     // Symbolic intervals for op1
-    SymbInterval *STOp1 = new SymbInterval(CR, Op0, invPred);
-    SymbInterval *SFOp1 = new SymbInterval(CR, Op0, pred);
+    SymbInterval *STOp1 = createInterval<SymbInterval>(CR, Op0, invPred);
+    SymbInterval *SFOp1 = createInterval<SymbInterval>(CR, Op0, pred);
     ValueBranchMap VBMOp1(Op1, TBlock, FBlock, STOp1, SFOp1);
     valuesBranchMap.insert(std::make_pair(Op1, VBMOp1));
 
@@ -2575,9 +2373,10 @@ void ConstraintGraph::buildValueBranchMap(const BranchInst *br) {
     castinst = nullptr;
     if ((castinst = dyn_cast<CastInst>(Op1)) != nullptr) {
       const Value *Op0_0 = castinst->getOperand(0);
+      Range CR_0(RangeAnalysis::getBitWidth(Op0_0), Unknown);
 
-      SymbInterval *STOp1_1 = new SymbInterval(CR, Op1, pred);
-      SymbInterval *SFOp1_1 = new SymbInterval(CR, Op1, invPred);
+      SymbInterval *STOp1_1 = createInterval<SymbInterval>(CR_0, Op1, pred);
+      SymbInterval *SFOp1_1 = createInterval<SymbInterval>(CR_0, Op1, invPred);
 
       ValueBranchMap VBMOp1_1(Op0_0, TBlock, FBlock, STOp1_1, SFOp1_1);
       valuesBranchMap.insert(std::make_pair(Op0_0, VBMOp1_1));
@@ -2585,183 +2384,30 @@ void ConstraintGraph::buildValueBranchMap(const BranchInst *br) {
   }
 }
 
-void ConstraintGraph::buildValueMaps(const Function &F) {
-  for (const BasicBlock &BB : F) {
-    const TerminatorInst *ti = BB.getTerminator();
-    const BranchInst *br = dyn_cast<BranchInst>(ti);
-    const SwitchInst *sw = dyn_cast<SwitchInst>(ti);
-
-    if (br != nullptr) {
-      buildValueBranchMap(br);
-    } else if (sw != nullptr) {
-      buildValueSwitchMap(sw);
-    }
-  }
-}
-
 // void ConstraintGraph::clearValueMaps()
 //{
 //	valuesSwitchMap.clear();
 //	valuesBranchMap.clear();
 //}
 
-/*
- * Used to insert constant in the right position
- */
-void ConstraintGraph::insertConstantIntoVector(APInt constantval) {
-  if (constantval.getBitWidth() < MAX_BIT_INT) {
-    constantval = constantval.sext(MAX_BIT_INT);
-  }
-
-  constantvector.push_back(constantval);
-}
-
-/*
- * Get the first constant from vector greater than val
- */
-APInt getFirstGreaterFromVector(const SmallVector<APInt, 2> &constantvector,
-                                const APInt &val) {
-  for (const APInt &vapint : constantvector) {
-    if (vapint.sge(val)) {
-      return vapint;
-    }
-  }
-
-  return Max;
-}
-
-/*
- * Get the first constant from vector less than val
- */
-APInt getFirstLessFromVector(const SmallVector<APInt, 2> &constantvector,
-                             const APInt &val) {
-  for (SmallVectorImpl<APInt>::const_reverse_iterator
-           vit = constantvector.rbegin(),
-           vend = constantvector.rend();
-       vit != vend; ++vit) {
-    const APInt &vapint = *vit;
-
-    if (vapint.sle(val)) {
-      return vapint;
-    }
-  }
-
-  return Min;
-}
-
-/*
- * Create a vector containing all constants related to the component
- * They include:
- *   - Constants inside component
- *   - Constants that are source of an edge to an entry point
- *   - Constants from intersections generated by sigmas
- */
-void ConstraintGraph::buildConstantVector(
-    const SmallPtrSet<VarNode *, 32> &component, const UseMap &compusemap) {
-  // Remove all elements from the vector
-  constantvector.clear();
-
-  // Get constants inside component (TODO: may not be necessary, since
-  // components with more than 1 node may
-  // never have a constant inside them)
-  for (VarNode *varNode : component) {
-    const Value *V = varNode->getValue();
-    const ConstantInt *ci = nullptr;
-
-    if ((ci = dyn_cast<ConstantInt>(V)) != nullptr) {
-      insertConstantIntoVector(ci->getValue());
-    }
-  }
-
-  // Get constants that are sources of operations whose sink belong to the
-  // component
-  for (VarNode *varNode : component) {
-    const Value *V = varNode->getValue();
+/// Iterates through all instructions in the function and builds the graph,
+/// in a single pass. The branch or switch which constrains a sigma may come
+/// after it, so the operations of the sigmas are created after the pass.
+void ConstraintGraph::buildGraph(const Function &F) {
+  this->func = &F;
+  this->name = F.getName().str();
+  this->stepPrinter = printStep;
 
-    DefMap::iterator dfit = defMap.find(V);
-    if (dfit == defMap.end()) {
+  for (const Instruction &I : instructions(F)) {
+    if (const BranchInst *br = dyn_cast<BranchInst>(&I)) {
+      buildValueBranchMap(br);
       continue;
     }
-
-    // Handle BinaryOp case
-    const BinaryOp *bop = dyn_cast<BinaryOp>(dfit->second);
-    const PhiOp *pop = dyn_cast<PhiOp>(dfit->second);
-    if (bop != nullptr) {
-      const VarNode *source1 = bop->getSource1();
-      const Value *sourceval1 = source1->getValue();
-      const VarNode *source2 = bop->getSource2();
-      const Value *sourceval2 = source2->getValue();
-
-      const ConstantInt *const1, *const2;
-
-      if ((const1 = dyn_cast<ConstantInt>(sourceval1)) != nullptr) {
-        insertConstantIntoVector(const1->getValue());
-      }
-      if ((const2 = dyn_cast<ConstantInt>(sourceval2)) != nullptr) {
-        insertConstantIntoVector(const2->getValue());
-      }
-    }
-    // Handle PhiOp case
-    else if (pop != nullptr) {
-      for (unsigned i = 0, e = pop->getNumSources(); i < e; ++i) {
-        const VarNode *source = pop->getSource(i);
-        const Value *sourceval = source->getValue();
-
-        const ConstantInt *consti;
-
-        if ((consti = dyn_cast<ConstantInt>(sourceval)) != nullptr) {
-          insertConstantIntoVector(consti->getValue());
-        }
-      }
-    }
-  }
-
-  // Get constants used in intersections generated for sigmas
-  for (auto &pair : compusemap) {
-    for (BasicOp *op : pair.second) {
-      const SigmaOp *sigma = dyn_cast<SigmaOp>(op);
-
-      if (sigma != nullptr) {
-        // Symbolic intervals are discarded, as they don't have fixed values yet
-        if (isa<SymbInterval>(sigma->getIntersect())) {
-          continue;
-        }
-
-        Range rintersect = sigma->getIntersect()->getRange();
-
-        const APInt &lb = rintersect.getLower();
-        const APInt &ub = rintersect.getUpper();
-
-        if (lb.ne(Min) && lb.ne(Max)) {
-          insertConstantIntoVector(lb);
-        }
-        if (ub.ne(Min) && ub.ne(Max)) {
-          insertConstantIntoVector(ub);
-        }
-      }
+    if (const SwitchInst *sw = dyn_cast<SwitchInst>(&I)) {
+      buildValueSwitchMap(sw);
+      continue;
     }
-  }
-
-  // Sort vector in ascending order and remove duplicates
-  std::sort(constantvector.begin(), constantvector.end(),
-            [](const APInt &i1, const APInt &i2) { return i1.slt(i2); });
-
-  // std::unique doesn't remove duplicate elements, only
-  // move them to the end
-  // This is why erase is necessary. To remove these duplicates
-  // that will be now at the end.
-  SmallVector<APInt, 2>::iterator last =
-      std::unique(constantvector.begin(), constantvector.end());
-
-  constantvector.erase(last, constantvector.end());
-}
-
-/// Iterates through all instructions in the function and builds the graph.
-void ConstraintGraph::buildGraph(const Function &F) {
-  this->func = &F;
-  buildValueMaps(F);
 
-  for (const Instruction &I : instructions(F)) {
     const Type *ty = I.getType();
 
     // createNodesForConstants(inst);
@@ -2777,471 +2423,140 @@ void ConstraintGraph::buildGraph(const Function &F) {
 
     buildOperations(&I);
   }
-}
 
-void ConstraintGraph::buildVarNodes() {
-  // Initializes the nodes and the use map structure.
-  for (auto &pair : vars) {
-    pair.second->init(this->defMap.count(pair.first) == 0u);
+  for (const PHINode *Sigma : pendingSigmas) {
+    buildSigmaOp(Sigma);
   }
+  pendingSigmas.clear();
 }
 
-// FIXME: do it just for component
-void CropDFS::storeAbstractStates(const SmallPtrSet<VarNode *, 32> &component) {
-  for (VarNode *varNode : component) {
-    varNode->storeAbstractState();
-  }
-}
-
-bool Meet::fixed(BasicOp *op,
-                 const SmallVector<APInt, 2> * /*constantvector*/) {
-  Range oldInterval = op->getSink()->getRange();
-  Range newInterval = op->eval();
-
-  op->getSink()->setRange(newInterval);
-  LOG_TRANSACTION("FIXED::" << op->getSink()->getValue()->getName() << ": "
-                            << oldInterval << " -> " << newInterval)
-  return oldInterval != newInterval;
-}
-
-/// This is the meet operator of the growth analysis. The growth analysis
-/// will change the bounds of each variable, if necessary. Initially, each
-/// variable is bound to either the undefined interval, e.g. [., .], or to
-/// a constant interval, e.g., [3, 15]. After this analysis runs, there will
-/// be no undefined interval. Each variable will be either bound to a
-/// constant interval, or to [-, c], or to [c, +], or to [-, +].
-bool Meet::widen(BasicOp *op, const SmallVector<APInt, 2> *constantvector) {
-  assert(constantvector != nullptr && "Invalid pointer to constant vector");
-
-  Range oldInterval = op->getSink()->getRange();
-  Range newInterval = op->eval();
-
-  const APInt &oldLower = oldInterval.getLower();
-  const APInt &oldUpper = oldInterval.getUpper();
-  const APInt &newLower = newInterval.getLower();
-  const APInt &newUpper = newInterval.getUpper();
-
-  // Jump-set
-  APInt nlconstant = getFirstLessFromVector(*constantvector, newLower);
-  APInt nuconstant = getFirstGreaterFromVector(*constantvector, newUpper);
-
-  if (oldInterval.isUnknown()) {
-    op->getSink()->setRange(newInterval);
-  } else {
-    if (newLower.slt(oldLower) && newUpper.sgt(oldUpper)) {
-      op->getSink()->setRange(Range(nlconstant, nuconstant));
-    } else {
-      if (newLower.slt(oldLower)) {
-        op->getSink()->setRange(Range(nlconstant, oldUpper));
-      } else {
-        if (newUpper.sgt(oldUpper)) {
-          op->getSink()->setRange(Range(oldLower, nuconstant));
-        }
-      }
+/*
+ *	Takes the nodes of G in the order they were created in, so they are
+ *  numbered as if G had been built here, with the operations and the memory
+ *  of G. A node of G whose value already has a node here is dropped, and the
+ *  operations of G use the node here instead.
+ */
+void ConstraintGraph::addGraph(ConstraintGraph &G) {
+  func = G.func;
+  stepPrinter = printStep;
+
+  DenseMap<const VarNode *, VarNode *> replaced;
+  for (VarNode *node : G.nodes) {
+    const Value *V = node->getValue();
+    std::pair<VarNodes::iterator, bool> vit = vars.try_emplace(V, node);
+    SmallPtrSet<BasicOp *, 8> &uses = G.useMap.find(V)->second;
+    if (vit.second) {
+      node->moveTo(&bounds);
+      nodes.push_back(node);
+      useMap.try_emplace(V, std::move(uses));
+      continue;
     }
-  }
-
-  Range sinkInterval = op->getSink()->getRange();
-  LOG_TRANSACTION("WIDEN::" << op->getSink()->getValue()->getName() << ": "
-                            << oldInterval << " -> " << sinkInterval)
-  return oldInterval != sinkInterval;
-}
-
-bool Meet::growth(BasicOp *op,
-                  const SmallVector<APInt, 2> * /*constantvector*/) {
-  Range oldInterval = op->getSink()->getRange();
-  Range newInterval = op->eval();
 
-  if (oldInterval.isUnknown()) {
-    op->getSink()->setRange(newInterval);
-  } else {
-    const APInt &oldLower = oldInterval.getLower();
-    const APInt &oldUpper = oldInterval.getUpper();
-    const APInt &newLower = newInterval.getLower();
-    const APInt &newUpper = newInterval.getUpper();
-    if (newLower.slt(oldLower)) {
-      if (newUpper.sgt(oldUpper)) {
-        op->getSink()->setRange(Range());
-      } else {
-        op->getSink()->setRange(Range(Min, oldUpper));
-      }
-    } else if (newUpper.sgt(oldUpper)) {
-      op->getSink()->setRange(Range(oldLower, Max));
+    VarNode *existing = vit.first->second;
+    SmallPtrSet<BasicOp *, 8> &existingUses = useMap.find(V)->second;
+    for (BasicOp *op : uses) {
+      op->replaceSource(node, existing);
+      existingUses.insert(op);
     }
+    replaced[node] = existing;
   }
-  Range sinkInterval = op->getSink()->getRange();
-  LOG_TRANSACTION("GROWTH::" << op->getSink()->getValue()->getName() << ": "
-                             << oldInterval << " -> " << sinkInterval)
-  return oldInterval != sinkInterval;
-}
-
-/// This is the meet operator of the cropping analysis. Whereas the growth
-/// analysis expands the bounds of each variable, regardless of intersections
-/// in the constraint graph, the cropping analysis shrinks these bounds back
-/// to ranges that respect the intersections.
-bool Meet::narrow(BasicOp *op,
-                  const SmallVector<APInt, 2> * /*constantvector*/) {
-
-  APInt oLower = op->getSink()->getRange().getLower();
-  APInt oUpper = op->getSink()->getRange().getUpper();
-  Range newInterval = op->eval();
 
-  const APInt &nLower = newInterval.getLower();
-  const APInt &nUpper = newInterval.getUpper();
-
-  bool hasChanged = false;
-
-  if (oLower.eq(Min) && nLower.ne(Min)) {
-    op->getSink()->setRange(Range(nLower, oUpper));
-    hasChanged = true;
-  } else {
-    const APInt &smin = APIntOps::smin(oLower, nLower);
-    if (oLower.ne(smin)) {
-      op->getSink()->setRange(Range(smin, oUpper));
-      hasChanged = true;
+  for (BasicOp *op : G.oprs) {
+    DenseMap<const VarNode *, VarNode *>::iterator rit =
+        replaced.find(op->getSink());
+    if (rit != replaced.end()) {
+      op->setSink(rit->second);
     }
+    oprs.insert(op);
   }
-
-  if (oUpper.eq(Max) && nUpper.ne(Max)) {
-    op->getSink()->setRange(
-        Range(op->getSink()->getRange().getLower(), nUpper));
-    hasChanged = true;
-  } else {
-    const APInt &smax = APIntOps::smax(oUpper, nUpper);
-    if (oUpper.ne(smax)) {
-      op->getSink()->setRange(
-          Range(op->getSink()->getRange().getLower(), smax));
-      hasChanged = true;
-    }
-  }
-
-  LOG_TRANSACTION("NARROW::" << op->getSink()->getValue()->getName() << ": "
-                             << Range(oLower, oUpper) << " -> "
-                             << op->getSink()->getRange())
-  return hasChanged;
-}
-
-bool Meet::crop(BasicOp *op, const SmallVector<APInt, 2> * /*constantvector*/) {
-  Range oldInterval = op->getSink()->getRange();
-  Range newInterval = op->eval();
-
-  bool hasChanged = false;
-  char abstractState = op->getSink()->getAbstractState();
-
-  if ((abstractState == '-' || abstractState == '?') &&
-      newInterval.getLower().sgt(oldInterval.getLower())) {
-    op->getSink()->setRange(
-        Range(newInterval.getLower(), oldInterval.getUpper()));
-    hasChanged = true;
+  for (const auto &pair : G.defMap) {
+    defMap[pair.first] = pair.second;
   }
-
-  if ((abstractState == '+' || abstractState == '?') &&
-      newInterval.getUpper().slt(oldInterval.getUpper())) {
-    op->getSink()->setRange(
-        Range(op->getSink()->getRange().getLower(), newInterval.getUpper()));
-    hasChanged = true;
-  }
-
-  LOG_TRANSACTION("CROP::" << op->getSink()->getValue()->getName() << ": "
-                           << oldInterval << " -> "
-                           << op->getSink()->getRange())
-  return hasChanged;
-}
-
-void Cousot::preUpdate(const UseMap &compUseMap,
-                       SmallPtrSet<const Value *, 6> &entryPoints) {
-  update(compUseMap, entryPoints, Meet::widen);
-}
-
-void Cousot::posUpdate(const UseMap &compUseMap,
-                       SmallPtrSet<const Value *, 6> &entryPoints,
-                       const SmallPtrSet<VarNode *, 32> * /*component*/) {
-  update(compUseMap, entryPoints, Meet::narrow);
-}
-
-void CropDFS::preUpdate(const UseMap &compUseMap,
-                        SmallPtrSet<const Value *, 6> &entryPoints) {
-  update(compUseMap, entryPoints, Meet::growth);
-}
-
-void CropDFS::posUpdate(const UseMap &compUseMap,
-                        SmallPtrSet<const Value *, 6> & /*entryPoints*/,
-                        const SmallPtrSet<VarNode *, 32> *component) {
-  storeAbstractStates(*component);
-  GenOprs::iterator obgn = oprs.begin(), oend = oprs.end();
-  for (; obgn != oend; ++obgn) {
-    BasicOp *op = *obgn;
-
-    if (component->count(op->getSink()) != 0u) {
-      // int_op
-      if (isa<UnaryOp>(op) && (op->getSink()->getRange().getLower().ne(Min) ||
-                               op->getSink()->getRange().getUpper().ne(Max))) {
-        crop(compUseMap, op);
-      }
-    }
-  }
-}
-
-void CropDFS::crop(const UseMap &compUseMap, BasicOp *op) {
-  SmallPtrSet<BasicOp *, 8> activeOps;
-  SmallPtrSet<const VarNode *, 8> visitedOps;
-
-  // init the activeOps only with the op received
-  activeOps.insert(op);
-
-  while (!activeOps.empty()) {
-    BasicOp *V = *activeOps.begin();
-    activeOps.erase(V);
-    const VarNode *sink = V->getSink();
-
-    // if the sink has been visited go to the next activeOps
-    if (visitedOps.count(sink) != 0u) {
-      continue;
-    }
-
-    Meet::crop(V, nullptr);
-    visitedOps.insert(sink);
-
-    // The use list.of sink
-    const SmallPtrSet<BasicOp *, 8> &L =
-        compUseMap.find(sink->getValue())->second;
-
-    for (BasicOp *op : L) {
-      activeOps.insert(op);
-    }
+  for (const auto &pair : replaced) {
+    pair.first->~VarNode();
   }
-}
-
-void ConstraintGraph::update(
-    const UseMap &compUseMap, SmallPtrSet<const Value *, 6> &actv,
-    bool (*meet)(BasicOp *op, const SmallVector<APInt, 2> *constantvector)) {
-  while (!actv.empty()) {
-    const Value *V = *actv.begin();
-    actv.erase(V);
-
-#ifdef STATS
-    // Updates Fermap
-    if (meet == Meet::narrow) {
-      FerMap[V]++;
-    }
-#endif
-
-    // The use list.
-    const SmallPtrSet<BasicOp *, 8> &L = compUseMap.find(V)->second;
 
-    for (BasicOp *op : L) {
-      if (meet(op, &constantvector)) {
-        // I want to use it as a set, but I also want
-        // keep an order or insertions and removals.
-        actv.insert(op->getSink()->getValue());
-      }
-    }
-  }
+  // G is left empty, without running the destructors of what it gave away
+  arenaIntervals.append(G.arenaIntervals.begin(), G.arenaIntervals.end());
+  adoptedArenas.push_back(std::move(G.arena));
+  G.arenaIntervals.clear();
+  G.nodes.clear();
+  G.clear();
 }
 
-void ConstraintGraph::update(unsigned nIterations, const UseMap &compUseMap,
-                             SmallPtrSet<const Value *, 6> &actv) {
-  while (!actv.empty()) {
-    const Value *V = *actv.begin();
-    actv.erase(V);
-    // The use list.
-    const SmallPtrSet<BasicOp *, 8> &L = compUseMap.find(V)->second;
-    for (BasicOp *op : L) {
-      if (nIterations == 0) {
-        actv.clear();
-        return;
-      }
-      --nIterations;
-
-      if (Meet::fixed(op, nullptr)) {
-        actv.insert(op->getSink()->getValue());
-      }
-    }
+void ConstraintGraph::buildVarNodes() {
+  // Initializes the nodes and the use map structure.
+  for (auto &pair : vars) {
+    pair.second->init(this->defMap.count(pair.first) == 0u);
   }
 }
-
 /// Finds the intervals of the variables in the graph.
 void ConstraintGraph::findIntervals() {
 //	clearValueMaps();
-
-// Builds symbMap
-#ifdef STATS
-  Timer *timer = prof.registerNewTimer(
-      "Nuutila", "Nuutila's algorithm for strongly connected components");
-  timer->startTimer();
-#endif
-  buildSymbolicIntersectMap();
-
-  // List of SCCs
-  Nuutila sccList(&vars, &useMap, &symbMap);
-#ifdef STATS
-  timer->stopTimer();
-  prof.addTimeRecord(timer);
-// delete timer;
-#endif
-  // STATS
-  numSCCs += sccList.worklist.size();
-#ifdef SCC_DEBUG
-  unsigned numberOfSCCs = numSCCs;
-#endif
-
-// For each SCC in graph, do the following
-#ifdef STATS
-  timer = prof.registerNewTimer("ConstraintSolving", "Constraint solving");
-  timer->startTimer();
-#endif
-
-  for (Nuutila::iterator nit = sccList.begin(), nend = sccList.end();
-       nit != nend; ++nit) {
-    SmallPtrSet<VarNode *, 32> &component = *sccList.components[*nit];
-#ifdef SCC_DEBUG
-    --numberOfSCCs;
-#endif
-
-    if (component.size() == 1) {
-      ++numAloneSCCs;
-      fixIntersects(component);
-
-      VarNode *var = *component.begin();
-      if (var->getRange().isUnknown()) {
-        var->setRange(Range(Min, Max));
-      }
-    } else {
-      if (component.size() > sizeMaxSCC) {
-        sizeMaxSCC = component.size();
-      }
-
-      UseMap compUseMap = buildUseMap(component);
-
-      // Get the entry points of the SCC
-      SmallPtrSet<const Value *, 6> entryPoints;
-
-#ifdef JUMPSET
-      // Create vector of constants inside component
-      // Comment this line below to deactivate jump-set
-      buildConstantVector(component, compUseMap);
-#endif
-
-// generateEntryPoints(component, entryPoints);
-// iterate a fixed number of time before widening
-// update(component.size()*2 /*| NUMBER_FIXED_ITERATIONS*/, compUseMap,
-// entryPoints);
-
-#ifdef PRINT_DEBUG
-      if (func != nullptr) {
-        printToFile(*func, "/tmp/" + func->getName().str() + "cgfixed.dot");
-      }
-#endif
-
-      generateEntryPoints(component, entryPoints);
-      // First iterate till fix point
-      preUpdate(compUseMap, entryPoints);
-      fixIntersects(component);
-
-      // FIXME: Ensure that this code is really needed
-      for (VarNode *varNode : component) {
-        if (varNode->getRange().isUnknown()) {
-          varNode->setRange(Range(Min, Max));
-        }
-      }
-
-// printResultIntervals();
-#ifdef PRINT_DEBUG
-      if (func != nullptr) {
-        printToFile(*func, "/tmp/" + func->getName().str() + "cgint.dot");
-      }
-#endif
-
-      // Second iterate till fix point
-      SmallPtrSet<const Value *, 6> activeVars;
-      generateActivesVars(component, activeVars);
-      posUpdate(compUseMap, activeVars, &component);
-    }
-    propagateToNextSCC(component);
+  if (ctx.simplify) {
+    simplify();
   }
+  finalize();
+  addPseudoEdges();
 
-#ifdef STATS
-  timer->stopTimer();
-  prof.addTimeRecord(timer);
-#endif
-
-#ifdef SCC_DEBUG
-  ASSERT(numberOfSCCs == 0, "Not all SCCs have been visited")
-#endif
+  if (!ctx.graphFile.empty()) {
+    std::string record;
+    raw_string_ostream OS(record);
+    write(OS);
+    appendGraphRecord(ctx.graphFile, OS.str());
+  }
+  solve();
 
 #ifdef STATS
-  timer = prof.registerNewTimer("ComputeStats", "Compute statistics");
+  Timer *timer =
+      ctx.prof.registerNewTimer("ComputeStats", "Compute statistics");
   timer->startTimer();
 
   computeStats();
 
   timer->stopTimer();
-  prof.addTimeRecord(timer);
+  ctx.prof.addTimeRecord(timer);
 #endif
 }
 
-void ConstraintGraph::generateEntryPoints(
-    SmallPtrSet<VarNode *, 32> &component,
-    SmallPtrSet<const Value *, 6> &entryPoints) {
-  // Iterate over the varnodes in the component
-  for (VarNode *varNode : component) {
-    const Value *V = varNode->getValue();
-
-    if (V->getName().startswith(sigmaString)) {
-      DefMap::iterator dit = this->defMap.find(V);
-
-      if (dit != this->defMap.end()) {
-        BasicOp *bop = dit->second;
-        SigmaOp *defop = dyn_cast<SigmaOp>(bop);
-
-        if ((defop != nullptr) && defop->isUnresolved()) {
-
-          defop->getSink()->setRange(bop->eval());
-          defop->markResolved();
-        }
-      }
-    }
-
-    if (!varNode->getRange().isUnknown()) {
-      entryPoints.insert(V);
+/*
+ *	The edges from the bounds of symbolic intervals are printed as pseudo
+ *  edges in the dot file of the graph.
+ */
+void ConstraintGraph::addPseudoEdges() const {
+  raw_string_ostream pseudoEdgesString(ctx.pseudoEdges);
+  for (unsigned id = 0, e = getNumNodes(); id < e; ++id) {
+    // Nodes read from a graph file have no name to print
+    if (getNode(id)->getValue() == nullptr) {
+      continue;
     }
-  }
-}
-
-void ConstraintGraph::fixIntersects(SmallPtrSet<VarNode *, 32> &component) {
-  // Iterate again over the varnodes in the component
-  for (VarNode *varNode : component) {
-    const Value *V = varNode->getValue();
+    for (unsigned op : getSymbUses(id)) {
+      // Add pseudo edge to the string
+      const Value *V = getNode(id)->getValue();
+      if (const ConstantInt *C = dyn_cast<ConstantInt>(V)) {
+        pseudoEdgesString << " " << C->getValue() << " -> ";
+      } else {
+        pseudoEdgesString << " " << '"';
+        printVarName(V, pseudoEdgesString);
+        pseudoEdgesString << '"' << " -> ";
+      }
 
-    SymbMap::iterator sit = symbMap.find(V);
+      const Value *VS = getOp(op)->getSink()->getValue();
+      pseudoEdgesString << '"';
+      printVarName(VS, pseudoEdgesString);
+      pseudoEdgesString << '"';
 
-    if (sit != symbMap.end()) {
-      for (BasicOp *op : sit->second) {
-        op->fixIntersects(varNode);
-      }
+      pseudoEdgesString << " [style=dashed]\n";
     }
   }
 }
 
-void ConstraintGraph::generateActivesVars(
-    SmallPtrSet<VarNode *, 32> &component,
-    SmallPtrSet<const Value *, 6> &activeVars) {
-
-  for (VarNode *varNode : component) {
-    const Value *V = varNode->getValue();
-
-    const ConstantInt *CI = dyn_cast<ConstantInt>(V);
-    if (CI != nullptr) {
-      continue;
-    }
-
-    activeVars.insert(V);
-  }
+/// Prints the graph to the dot file of step in /tmp.
+void ConstraintGraph::printStep(const ConstraintGraph &G, StringRef step) {
+  G.printToFile(*G.func,
+                "/tmp/" + G.func->getName().str() + step.str() + ".dot");
 }
 
-// TODO(vhscampos):
-/// Releases the memory used by the graph.
-void ConstraintGraph::clear() {}
 
 /// Prints the content of the graph in dot format. For more informations
 /// about the dot format, see: http://www.graphviz.org/pdf/dotguide.pdf
@@ -3271,14 +2586,14 @@ void ConstraintGraph::print(const Function &F, raw_ostream &OS) const {
     OS << '\n';
   }
 
-  OS << pseudoEdgesString.str();
+  OS << ctx.pseudoEdges;
 
   // Print the footer of the .dot file.
   OS << "}\n";
 }
 
 void ConstraintGraph::printToFile(const Function &F,
-                                  const std::string &FileName) {
+                                  const std::string &FileName) const {
   std::error_code ErrorInfo;
   raw_fd_ostream file(FileName, ErrorInfo, sys::fs::F_Text);
 
@@ -3308,52 +2623,58 @@ void ConstraintGraph::printResultIntervals() {
 
 void ConstraintGraph::computeStats() {
   for (const auto &pair : vars) {
+    // The nodes where the return values of a function meet are not variables
+    // of the program.
+    if (isa<ReturnInst>(pair.first)) {
+      continue;
+    }
+
     // We only count the instructions that have uses.
     if (pair.first->getNumUses() == 0) {
-      ++numZeroUses;
+      ++ctx.stats.numZeroUses;
       // continue;
     }
 
     // ConstantInts must NOT be counted!!
     if (isa<ConstantInt>(pair.first)) {
-      ++numConstants;
+      ++ctx.stats.numConstants;
       continue;
     }
 
     // Variables that are not IntegerTy are ignored
     if (!pair.first->getType()->isIntegerTy()) {
-      ++numNotInt;
+      ++ctx.stats.numNotInt;
       continue;
     }
 
     // Count original (used) bits
     unsigned total = pair.first->getType()->getPrimitiveSizeInBits();
-    usedBits += total;
+    ctx.stats.usedBits += total;
     Range CR = pair.second->getRange();
 
     // If range is unknown, we have total needed bits
     if (CR.isUnknown()) {
-      ++numUnknown;
-      needBits += total;
+      ++ctx.stats.numUnknown;
+      ctx.stats.needBits += total;
       continue;
     }
 
     // If range is empty, we have 0 needed bits
     if (CR.isEmpty()) {
-      ++numEmpty;
+      ++ctx.stats.numEmpty;
       continue;
     }
 
-    if (CR.getLower().eq(Min)) {
-      if (CR.getUpper().eq(Max)) {
-        ++numMaxRange;
+    if (CR.isLowerMin()) {
+      if (CR.isUpperMax()) {
+        ++ctx.stats.numMaxRange;
       } else {
-        ++numMinInfC;
+        ++ctx.stats.numMinInfC;
       }
-    } else if (CR.getUpper().eq(Max)) {
-      ++numCPlusInf;
+    } else if (CR.isUpperMax()) {
+      ++ctx.stats.numCPlusInf;
     } else {
-      ++numCC;
+      ++ctx.stats.numCC;
     }
 
     unsigned ub, lb;
@@ -3380,444 +2701,13 @@ void ConstraintGraph::computeStats() {
     }
 
     if (nBits < total) {
-      needBits += nBits;
-    } else {
-      needBits += total;
-    }
-  }
-
-  double totalB = usedBits;
-  double needB = needBits;
-  double reduction = (totalB - needB) * 100 / totalB;
-  percentReduction = static_cast<unsigned int>(reduction);
-
-  numVars += this->vars.size();
-  numOps += this->oprs.size();
-}
-
-/*
- *	This method builds a map that binds each variable to the operation in
- *  which this variable is defined.
- */
-
-// DefMap ConstraintGraph::buildDefMap(const SmallPtrSet<VarNode*, 32>
-// &component)
-//{
-//	std::deque<BasicOp*> list;
-//	for (GenOprs::iterator opit = oprs.begin(), opend = oprs.end(); opit !=
-// opend; ++opit) {
-//		BasicOp *op = *opit;
-//
-//		if (std::find(component.begin(), component.end(), op->getSink())
-//!= component.end()) {
-//			list.push_back(op);
-//		}
-//	}
-//
-//	DefMap defMap;
-//
-//	for (std::deque<BasicOp*>::iterator opit = list.begin(), opend =
-// list.end(); opit != opend; ++opit) {
-//		BasicOp *op = *opit;
-//		defMap[op->getSink()] = op;
-//	}
-//
-//	return defMap;
-//}
-
-/*
- *	This method builds a map that binds each variable label to the
- *operations
- *  where this variable is used.
- */
-UseMap
-ConstraintGraph::buildUseMap(const SmallPtrSet<VarNode *, 32> &component) {
-  UseMap compUseMap;
-
-  for (SmallPtrSetIterator<VarNode *> vit = component.begin(),
-                                      vend = component.end();
-       vit != vend; ++vit) {
-    const VarNode *var = *vit;
-    const Value *V = var->getValue();
-
-    // Get the component's use list for V (it does not exist until we try to get
-    // it)
-    SmallPtrSet<BasicOp *, 8> &list = compUseMap[V];
-
-    // Get the use list of the variable in component
-    UseMap::iterator p = this->useMap.find(V);
-
-    // For each operation in the list, verify if its sink is in the component
-    for (BasicOp *opit : p->second) {
-      VarNode *sink = opit->getSink();
-
-      // If it is, add op to the component's use map
-      if (component.count(sink) != 0u) {
-        list.insert(opit);
-      }
-    }
-  }
-
-  return compUseMap;
-}
-
-/*
- *	This method builds a map of variables to the lists of operations where
- *  these variables are used as futures. Its C++ type should be something like
- *  map<VarNode, List<Operation>>.
- */
-void ConstraintGraph::buildSymbolicIntersectMap() {
-  // Creates the symbolic intervals map
-  // FIXME: Why this map is beeing recreated?
-  symbMap = SymbMap();
-
-  // Iterate over the operations set
-  for (BasicOp *op : oprs) {
-    // If the operation is unary and its interval is symbolic
-    UnaryOp *uop = dyn_cast<UnaryOp>(op);
-
-    if ((uop != nullptr) && isa<SymbInterval>(uop->getIntersect())) {
-      SymbInterval *symbi = cast<SymbInterval>(uop->getIntersect());
-
-      const Value *V = symbi->getBound();
-      SymbMap::iterator p = symbMap.find(V);
-
-      if (p != symbMap.end()) {
-        p->second.insert(uop);
-      } else {
-        SmallPtrSet<BasicOp *, 8> l;
-
-        l.insert(uop);
-        symbMap.insert(std::make_pair(V, l));
-      }
-    }
-  }
-}
-
-/*
- *	This method evaluates once each operation that uses a variable in
- *  component, so that the next SCCs after component will have entry
- *  points to kick start the range analysis algorithm.
- */
-void ConstraintGraph::propagateToNextSCC(
-    const SmallPtrSet<VarNode *, 32> &component) {
-  for (VarNode *var : component) {
-    const Value *V = var->getValue();
-
-    UseMap::iterator p = this->useMap.find(V);
-
-    for (BasicOp *op : p->second) {
-      SigmaOp *sigmaop = dyn_cast<SigmaOp>(op);
-
-      op->getSink()->setRange(op->eval());
-
-      if ((sigmaop != nullptr) &&
-          sigmaop->getIntersect()->getRange().isUnknown()) {
-        sigmaop->markUnresolved();
-      }
-    }
-  }
-}
-
-/*
- *	Adds the edges that ensure that we solve a future before fixing its
- *  interval. I have created a new class: ControlDep edges, to represent
- *  the control dependences. In this way, in order to delete these edges,
- *  one just need to go over the map of uses removing every instance of the
- *  ControlDep class.
- */
-void Nuutila::addControlDependenceEdges(SymbMap *symbMap, UseMap *useMap,
-                                        VarNodes *vars) {
-  for (SymbMap::iterator sit = symbMap->begin(), send = symbMap->end();
-       sit != send; ++sit) {
-    for (SmallPtrSetIterator<BasicOp *> opit = sit->second.begin(),
-                                        opend = sit->second.end();
-         opit != opend; ++opit) {
-      // Cria uma operação pseudo-aresta
-      VarNodes::iterator source_value = vars->find(sit->first);
-      VarNode *source = source_value->second;
-
-      //			if (source_value != vars.end()) {
-      //				source = vars.find(sit->first)->second;
-      //			}
-
-      //			if (source == nullptr) {
-      //				continue;
-      //			}
-
-      BasicOp *cdedge = new ControlDep((*opit)->getSink(), source);
-      //			BasicOp *cdedge = new
-      // ControlDep((cast<UnaryOp>(*opit))->getSource(), source);
-
-      //(*useMap)[(*opit)->getSink()->getValue()].insert(cdedge);
-      (*useMap)[sit->first].insert(cdedge);
-    }
-  }
-}
-
-/*
- *	Removes the control dependence edges from the constraint graph.
- */
-void Nuutila::delControlDependenceEdges(UseMap *useMap) {
-  for (UseMap::iterator it = useMap->begin(), end = useMap->end(); it != end;
-       ++it) {
-
-    std::deque<ControlDep *> ops;
-
-    for (BasicOp *sit : it->second) {
-      ControlDep *op = nullptr;
-
-      if ((op = dyn_cast<ControlDep>(sit)) != nullptr) {
-        ops.push_back(op);
-      }
-    }
-
-    for (ControlDep *op : ops) {
-      // Add pseudo edge to the string
-      const Value *V = op->getSource()->getValue();
-      if (const ConstantInt *C = dyn_cast<ConstantInt>(V)) {
-        pseudoEdgesString << " " << C->getValue() << " -> ";
-      } else {
-        pseudoEdgesString << " " << '"';
-        printVarName(V, pseudoEdgesString);
-        pseudoEdgesString << '"' << " -> ";
-      }
-
-      const Value *VS = op->getSink()->getValue();
-      pseudoEdgesString << '"';
-      printVarName(VS, pseudoEdgesString);
-      pseudoEdgesString << '"';
-
-      pseudoEdgesString << " [style=dashed]\n";
-
-      // Remove pseudo edge from the map
-      it->second.erase(op);
-    }
-  }
-}
-
-/*
- *	Finds SCCs using Nuutila's algorithm. This algorithm is divided in
- *  two parts. The first calls the recursive visit procedure on every node
- *  in the constraint graph. The second phase revisits these nodes,
- *  grouping them in components.
- */
-void Nuutila::visit(Value *V, std::stack<Value *> &stack, UseMap *useMap) {
-  dfs[V] = index;
-  ++index;
-  root[V] = V;
-
-  // Visit every node defined in an instruction that uses V
-  for (SmallPtrSetIterator<BasicOp *> sit = (*useMap)[V].begin(),
-                                      send = (*useMap)[V].end();
-       sit != send; ++sit) {
-    BasicOp *op = *sit;
-    Value *name = const_cast<Value *>(op->getSink()->getValue());
-
-    if (dfs[name] < 0) {
-      visit(name, stack, useMap);
-    }
-
-    if ((!static_cast<bool>(inComponent.count(name))) &&
-        (dfs[root[V]] >= dfs[root[name]])) {
-      root[V] = root[name];
-    }
-  }
-
-  // The second phase of the algorithm assigns components to stacked nodes
-  if (root[V] == V) {
-    // Neither the worklist nor the map of components is part of Nuutila's
-    // original algorithm. We are using these data structures to get a
-    // topological ordering of the SCCs without having to go over the root
-    // list once more.
-    worklist.push_back(V);
-
-    SmallPtrSet<VarNode *, 32> *SCC = new SmallPtrSet<VarNode *, 32>;
-
-    SCC->insert((*variables)[V]);
-
-    inComponent.insert(V);
-
-    while (!stack.empty() && (dfs[stack.top()] > dfs[V])) {
-      Value *node = stack.top();
-      stack.pop();
-
-      inComponent.insert(node);
-
-      SCC->insert((*variables)[node]);
-    }
-
-    components[V] = SCC;
-  } else {
-    stack.push(V);
-  }
-}
-
-/*
- *	Finds the strongly connected components in the constraint graph formed
- *by
- *	Variables and UseMap. The class receives the map of futures to insert
- *the
- *  control dependence edges in the contraint graph. These edges are removed
- *  after the class is done computing the SCCs.
- */
-Nuutila::Nuutila(VarNodes *varNodes, UseMap *useMap, SymbMap *symbMap,
-                 bool single) {
-  if (single) {
-    /* FERNANDO */
-    SmallPtrSet<VarNode *, 32> *SCC = new SmallPtrSet<VarNode *, 32>;
-    for (VarNodes::iterator vit = varNodes->begin(), vend = varNodes->end();
-         vit != vend; ++vit) {
-      SCC->insert(vit->second);
-    }
-
-    for (VarNodes::iterator vit = varNodes->begin(), vend = varNodes->end();
-         vit != vend; ++vit) {
-      Value *V = const_cast<Value *>(vit->first);
-      components[V] = SCC;
-    }
-
-    if (!varNodes->empty()) {
-      this->worklist.push_back(const_cast<Value *>(varNodes->begin()->first));
-    }
-  } else {
-    // Copy structures
-    this->variables = varNodes;
-    this->index = 0;
-
-    // Iterate over all varnodes of the constraint graph
-    for (VarNodes::iterator vit = varNodes->begin(), vend = varNodes->end();
-         vit != vend; ++vit) {
-      // Initialize DFS control variable for each Value in the graph
-      Value *V = const_cast<Value *>(vit->first);
-      dfs[V] = -1;
-    }
-
-    addControlDependenceEdges(symbMap, useMap, varNodes);
-
-    // Iterate again over all varnodes of the constraint graph
-    for (VarNodes::iterator vit = varNodes->begin(), vend = varNodes->end();
-         vit != vend; ++vit) {
-      Value *V = const_cast<Value *>(vit->first);
-
-      // If the Value has not been visited yet, call visit for him
-      if (dfs[V] < 0) {
-        std::stack<Value *> pilha;
-
-        visit(V, pilha, useMap);
-      }
-    }
-
-    delControlDependenceEdges(useMap);
-  }
-
-#ifdef SCC_DEBUG
-  ASSERT(checkWorklist(), "an inconsistency in SCC worklist have been found")
-  ASSERT(checkComponents(), "a component has been used more than once")
-  ASSERT(checkTopologicalSort(useMap), "topological sort is incorrect")
-#endif
-}
-
-Nuutila::~Nuutila() {
-  for (DenseMap<Value *, SmallPtrSet<VarNode *, 32> *>::iterator
-           mit = components.begin(),
-           mend = components.end();
-       mit != mend; ++mit) {
-    delete mit->second;
-  }
-}
-
-#ifdef SCC_DEBUG
-bool Nuutila::checkWorklist() {
-  bool consistent = true;
-  for (Nuutila::iterator nit = this->begin(), nend = this->end(); nit != nend;
-       ++nit) {
-    Value *v = *nit;
-    for (Nuutila::iterator nit2 = this->begin(), nend2 = this->end();
-         nit2 != nend2; ++nit2) {
-      Value *v2 = *nit2;
-      if (v == v2 && nit != nit2) {
-        errs() << "[Nuutila::checkWorklist] Duplicated entry in worklist\n";
-        v->dump();
-        consistent = false;
-      }
-    }
-  }
-  return consistent;
-}
-
-bool Nuutila::checkComponents() {
-  bool isConsistent = true;
-  for (Nuutila::iterator nit = this->begin(), nend = this->end(); nit != nend;
-       ++nit) {
-    SmallPtrSet<VarNode *, 32> *component = this->components[*nit];
-    for (Nuutila::iterator nit2 = this->begin(), nend2 = this->end();
-         nit2 != nend2; ++nit2) {
-      SmallPtrSet<VarNode *, 32> *component2 = this->components[*nit2];
-      if (component == component2 && nit != nit2) {
-        errs() << "[Nuutila::checkComponent] Component [" << component << ", "
-               << component->size() << "]\n";
-        isConsistent = false;
-      }
-    }
-  }
-  return isConsistent;
-}
-
-/**
- * Check if a component has an edge to another component
- */
-bool Nuutila::hasEdge(SmallPtrSet<VarNode *, 32> *componentFrom,
-                      SmallPtrSet<VarNode *, 32> *componentTo, UseMap *useMap) {
-  for (SmallPtrSetIterator<VarNode *> vit = componentFrom->begin(),
-                                      vend = componentFrom->end();
-       vit != vend; ++vit) {
-    const Value *source = (*vit)->getValue();
-    for (SmallPtrSetIterator<BasicOp *> sit = (*useMap)[source].begin(),
-                                        send = (*useMap)[source].end();
-         sit != send; ++sit) {
-      BasicOp *op = *sit;
-      if (componentTo->count(op->getSink())) {
-        return true;
-      }
-    }
-  }
-  return false;
-}
-
-bool Nuutila::checkTopologicalSort(UseMap *useMap) {
-  bool isConsistent = true;
-  DenseMap<SmallPtrSet<VarNode *, 32> *, bool> visited;
-  for (Nuutila::iterator nit = this->begin(), nend = this->end(); nit != nend;
-       ++nit) {
-    SmallPtrSet<VarNode *, 32> *component = this->components[*nit];
-    visited[component] = false;
-  }
-
-  for (Nuutila::iterator nit = this->begin(), nend = this->end(); nit != nend;
-       ++nit) {
-    SmallPtrSet<VarNode *, 32> *component = this->components[*nit];
-
-    if (!visited[component]) {
-      visited[component] = true;
-      // check if this component points to another component that has already
-      // been visited
-      for (Nuutila::iterator nit2 = this->begin(), nend2 = this->end();
-           nit2 != nend2; ++nit2) {
-        SmallPtrSet<VarNode *, 32> *component2 = this->components[*nit2];
-        if (nit != nit2 && visited[component2] &&
-            hasEdge(component, component2, useMap)) {
-          isConsistent = false;
-        }
-      }
+      ctx.stats.needBits += nBits;
     } else {
-      errs() << "[Nuutila::checkTopologicalSort] Component visited more than "
-                "once time\n";
+      ctx.stats.needBits += total;
     }
   }
 
-  return isConsistent;
+  ctx.stats.numVars += this->vars.size();
+  ctx.stats.numOps += this->oprs.size();
 }
-
-#endif
 } // namespace RangeAnalysis
@@ -0,0 +1,644 @@
+//===------------------------------ ra-solve.cpp --------------------------===//
+//===---------- Solves constraint graphs outside of the compiler ----------===//
+//
+//					 The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+// This tool finds the ranges of the variables of constraint graphs without
+// running the pass, and prints them. It reads two kinds of files:
+//
+//  - graph files, written by the pass with -ra-write-graphs. The range of
+//    each node is printed after its id, in the order of the file.
+//  - the .dat graphs of the Python prototype, in
+//    prototype/PythonRangeAnalysis/graphs. The range of each variable is
+//    printed after its name, in the order of the Variables dictionary. A
+//    variable which several operations define takes the union of their
+//    results.
+//
+// Example:
+//   ra-solve prototype/PythonRangeAnalysis/graphs/g9.dat
+//   ra-solve -crop graphs.rag
+//
+//===----------------------------------------------------------------------===//
+
+#include <cctype>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "ConstraintGraph.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/ADT/StringSwitch.h"
+#include "llvm/IR/Instruction.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/ErrorOr.h"
+#include "llvm/Support/ManagedStatic.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/raw_ostream.h"
+
+using namespace llvm;
+using namespace RangeAnalysis;
+
+namespace {
+
+cl::opt<std::string> InputFilename(cl::Positional, cl::Required,
+                                   cl::desc("<graph file>"));
+
+// Growth and crop instead of widening and narrowing
+cl::opt<bool> Crop("crop", cl::init(false),
+                   cl::desc("Solve the graphs with the growth and crop "
+                            "meet operators of CropDFS"));
+
+// The bit width of the variables of the prototype, whose integers are
+// unbounded.
+const unsigned PrototypeBitWidth = 64;
+
+/// Builds an empty graph with the solver chosen on the command line.
+std::unique_ptr<ConstraintGraph> createGraph(AnalysisContext &ctx) {
+  if (Crop) {
+    return std::unique_ptr<ConstraintGraph>(new CropDFS(ctx));
+  }
+  return std::unique_ptr<ConstraintGraph>(new Cousot(ctx));
+}
+
+// ========================================================================== //
+// Graph files
+// ========================================================================== //
+
+/// Solves the graphs of the graph file FileName. Returns false on an error.
+bool solveGraphFile(const std::string &FileName) {
+  std::unique_ptr<GraphFile> File = GraphFile::open(FileName);
+  if (!File) {
+    return false;
+  }
+
+  AnalysisContext ctx;
+  for (unsigned i = 0, e = File->size(); i < e; ++i) {
+    std::unique_ptr<ConstraintGraph> G = createGraph(ctx);
+    if (!G->read(File->getRecord(i))) {
+      return false;
+    }
+
+    // The solver may renumber the nodes, so they are printed in the order
+    // they had in the file
+    SmallVector<VarNode *, 0> fileOrder;
+    for (unsigned id = 0, n = G->getNumNodes(); id < n; ++id) {
+      fileOrder.push_back(G->getNode(id));
+    }
+    G->solve();
+
+    outs() << "graph " << G->getName() << "\n";
+    for (unsigned id = 0, n = fileOrder.size(); id < n; ++id) {
+      outs() << id << " ";
+      fileOrder[id]->getRange().print(outs());
+      outs() << "\n";
+    }
+  }
+  return true;
+}
+
+// ========================================================================== //
+// Graphs of the Python prototype
+// ========================================================================== //
+
+/// A value of the subset of Python used by the graphs of the prototype:
+/// integers, strings, lists, dictionaries, subscripts such as Variables['k']
+/// and calls such as Interval(0, 99).
+struct PyValue {
+  enum Kind { Int, Str, List, Dict, Subscript, Call };
+
+  Kind kind{Int};
+  int64_t i{0};
+  // The string, the name of the subscripted variable or of the callee.
+  std::string s;
+  // The elements of a list, the keys and values of a dictionary one after
+  // the other, the index of a subscript or the arguments of a call.
+  std::vector<PyValue> items;
+  // The keywords of the arguments of a call, empty for a positional one.
+  std::vector<std::string> keywords;
+};
+
+/// Parses the assignments of a .dat file. Each assignment replaces the
+/// variable it assigns, as it would in Python.
+class PrototypeParser {
+private:
+  StringRef text;
+  size_t pos{0};
+  std::string error;
+
+  /// Skips blanks and comments.
+  void skip() {
+    while (pos < text.size()) {
+      if (std::isspace(static_cast<unsigned char>(text[pos])) != 0) {
+        ++pos;
+      } else if (text[pos] == '#') {
+        pos = text.find('\n', pos);
+        if (pos == StringRef::npos) {
+          pos = text.size();
+        }
+      } else {
+        break;
+      }
+    }
+  }
+  /// Consumes c if it is the next character.
+  bool consume(char c) {
+    skip();
+    if (pos < text.size() && text[pos] == c) {
+      ++pos;
+      return true;
+    }
+    return false;
+  }
+  bool expect(char c) {
+    if (consume(c)) {
+      return true;
+    }
+    return fail(std::string("expected '") + c + "'");
+  }
+  bool fail(const std::string &message) {
+    if (error.empty()) {
+      error = message + " at offset " + std::to_string(pos);
+    }
+    return false;
+  }
+  bool parseIdentifier(std::string &name) {
+    skip();
+    const size_t begin = pos;
+    while (pos < text.size() &&
+           (std::isalnum(static_cast<unsigned char>(text[pos])) != 0 ||
+            text[pos] == '_')) {
+      ++pos;
+    }
+    if (pos == begin ||
+        std::isdigit(static_cast<unsigned char>(text[begin])) != 0) {
+      pos = begin;
+      return fail("expected a name");
+    }
+    name = text.slice(begin, pos).str();
+    return true;
+  }
+  /// Parses the elements of a list or of the arguments of a call, up to
+  /// close. Arguments may have a keyword.
+  bool parseSequence(char close, PyValue &V, bool keywords) {
+    while (!consume(close)) {
+      std::string keyword;
+      if (keywords) {
+        skip();
+        const size_t start = pos;
+        std::string name;
+        if (pos < text.size() &&
+            std::isalpha(static_cast<unsigned char>(text[pos])) != 0 &&
+            parseIdentifier(name) && consume('=')) {
+          keyword = name;
+        } else {
+          pos = start;
+        }
+      }
+      V.items.emplace_back();
+      V.keywords.push_back(keyword);
+      if (!parseValue(V.items.back())) {
+        return false;
+      }
+      if (!consume(',')) {
+        return expect(close);
+      }
+    }
+    return true;
+  }
+  bool parseValue(PyValue &V) {
+    skip();
+    if (pos >= text.size()) {
+      return fail("unexpected end of file");
+    }
+
+    const char c = text[pos];
+    if (c == '\'' || c == '"') {
+      const size_t end = text.find(c, pos + 1);
+      if (end == StringRef::npos) {
+        return fail("unterminated string");
+      }
+      V.kind = PyValue::Str;
+      V.s = text.slice(pos + 1, end).str();
+      pos = end + 1;
+      return true;
+    }
+    if (c == '-' || std::isdigit(static_cast<unsigned char>(c)) != 0) {
+      size_t end = pos + 1;
+      while (end < text.size() &&
+             std::isdigit(static_cast<unsigned char>(text[end])) != 0) {
+        ++end;
+      }
+      if (text.slice(pos, end).getAsInteger(10, V.i)) {
+        return fail("expected a 64-bit integer");
+      }
+      V.kind = PyValue::Int;
+      pos = end;
+      return true;
+    }
+    if (consume('[')) {
+      V.kind = PyValue::List;
+      return parseSequence(']', V, false);
+    }
+    if (consume('{')) {
+      V.kind = PyValue::Dict;
+      while (!consume('}')) {
+        V.items.emplace_back();
+        if (!parseValue(V.items.back()) || !expect(':')) {
+          return false;
+        }
+        V.items.emplace_back();
+        if (!parseValue(V.items.back())) {
+          return false;
+        }
+        if (!consume(',')) {
+          return expect('}');
+        }
+      }
+      return true;
+    }
+
+    if (!parseIdentifier(V.s)) {
+      return false;
+    }
+    if (consume('[')) {
+      V.kind = PyValue::Subscript;
+      V.items.emplace_back();
+      return parseValue(V.items.back()) && expect(']');
+    }
+    if (consume('(')) {
+      V.kind = PyValue::Call;
+      return parseSequence(')', V, true);
+    }
+    return fail("unknown name " + V.s);
+  }
+
+public:
+  explicit PrototypeParser(StringRef text) : text(text) {}
+
+  /// Parses the whole file into the assigned variables. Returns false if
+  /// the file is not in the subset of Python of the prototype.
+  bool parse(std::map<std::string, PyValue> &assignments) {
+    skip();
+    while (pos < text.size()) {
+      std::string name;
+      PyValue V;
+      if (!parseIdentifier(name) || !expect('=') || !parseValue(V)) {
+        return false;
+      }
+      assignments[name] = std::move(V);
+      skip();
+    }
+    return true;
+  }
+  const std::string &getError() const { return error; }
+};
+
+/// Builds the constraint graph of a graph of the prototype. Its operations
+/// map to the operations of the graph:
+///  - PlusOp(a, b, s) is an addition.
+///  - PhiOp(a, b, s) is a phi operation.
+///  - UnaryOp(src, sink, a, b, interval) is sink = a * src + b, intersected
+///    with interval. The product and the sum are binary operations on
+///    constant nodes, through nodes with no variable, and the intersection
+///    is a sigma operation.
+class PrototypeGraph {
+private:
+  ConstraintGraph &G;
+  // The variables of the graph, in the order of the Variables dictionary,
+  // and their nodes.
+  std::vector<std::pair<std::string, VarNode *>> variables;
+  std::map<std::string, VarNode *> nodeOf;
+  // The variables which several operations define, and the nodes these
+  // operations write instead, which a phi joins into the variable.
+  std::map<std::string, std::vector<VarNode *>> joined;
+  // The constant nodes created for the operands of unary operations.
+  std::map<int64_t, VarNode *> constants;
+  std::string error;
+
+  bool fail(const std::string &message) {
+    error = message;
+    return false;
+  }
+  /// Returns the bound of an interval, which is '-', '+' or an integer.
+  bool getBound(const PyValue &V, APInt &bound) {
+    if (V.kind == PyValue::Int) {
+      bound = APInt(PrototypeBitWidth, V.i, true);
+    } else if (V.kind == PyValue::Str && V.s == "-") {
+      bound = APInt::getSignedMinValue(PrototypeBitWidth);
+    } else if (V.kind == PyValue::Str && V.s == "+") {
+      bound = APInt::getSignedMaxValue(PrototypeBitWidth);
+    } else {
+      return fail("bad bound of an interval");
+    }
+    return true;
+  }
+  /// Returns the argument of call V at position index, or with the keyword
+  /// keyword, or null if there is none.
+  static const PyValue *getArgument(const PyValue &V, unsigned index,
+                                    StringRef keyword) {
+    for (unsigned i = 0, e = V.items.size(); i < e; ++i) {
+      if (V.keywords[i].empty() ? i == index : keyword == V.keywords[i]) {
+        return &V.items[i];
+      }
+    }
+    return nullptr;
+  }
+  bool getNode(const PyValue *V, VarNode *&node) {
+    if (V == nullptr || V->kind != PyValue::Subscript ||
+        V->items[0].kind != PyValue::Str) {
+      return fail("expected a variable");
+    }
+    std::map<std::string, VarNode *>::iterator nit =
+        nodeOf.find(V->items[0].s);
+    if (nit == nodeOf.end()) {
+      return fail("unknown variable " + V->items[0].s);
+    }
+    node = nit->second;
+    return true;
+  }
+  /// Reads the sink of an operation. If the variable has several
+  /// definitions, the operation writes a node of its own.
+  bool getSink(const PyValue *V, VarNode *&node) {
+    if (!getNode(V, node)) {
+      return false;
+    }
+    std::map<std::string, std::vector<VarNode *>>::iterator jit =
+        joined.find(V->items[0].s);
+    if (jit != joined.end()) {
+      node = G.addNode(Range(PrototypeBitWidth, Unknown));
+      jit->second.push_back(node);
+    }
+    return true;
+  }
+  bool getInteger(const PyValue *V, int64_t defaultValue, int64_t &i) {
+    if (V == nullptr) {
+      i = defaultValue;
+      return true;
+    }
+    if (V->kind != PyValue::Int) {
+      return fail("expected an integer");
+    }
+    i = V->i;
+    return true;
+  }
+  /// Reads an interval. A symbolic interval sets bound and pred too.
+  bool getInterval(const PyValue &V, Range &R, VarNode *&bound,
+                   CmpInst::Predicate &pred) {
+    bound = nullptr;
+    if (V.kind != PyValue::Call) {
+      return fail("expected an interval");
+    }
+    if (V.s == "BottomInterval") {
+      R = Range(PrototypeBitWidth, Unknown);
+      return true;
+    }
+    if (V.s == "SymbolicInterval") {
+      const PyValue *op = getArgument(V, 1, "op");
+      const StringRef opName = op != nullptr && op->kind == PyValue::Str
+                                   ? StringRef(op->s)
+                                   : StringRef("==");
+      pred = StringSwitch<CmpInst::Predicate>(opName)
+                 .Case("==", CmpInst::ICMP_EQ)
+                 .Case("<=", CmpInst::ICMP_SLE)
+                 .Case("<", CmpInst::ICMP_SLT)
+                 .Case(">=", CmpInst::ICMP_SGE)
+                 .Case(">", CmpInst::ICMP_SGT)
+                 .Default(CmpInst::BAD_ICMP_PREDICATE);
+      if (pred == CmpInst::BAD_ICMP_PREDICATE) {
+        return fail("unknown comparison " + opName.str());
+      }
+      R = Range(PrototypeBitWidth);
+      return getNode(getArgument(V, 0, "bound"), bound);
+    }
+    if (V.s != "Interval") {
+      return fail("unknown interval " + V.s);
+    }
+
+    APInt l = APInt::getSignedMinValue(PrototypeBitWidth);
+    APInt u = APInt::getSignedMaxValue(PrototypeBitWidth);
+    const PyValue *lv = getArgument(V, 0, "l");
+    const PyValue *uv = getArgument(V, 1, "u");
+    if ((lv != nullptr && !getBound(*lv, l)) ||
+        (uv != nullptr && !getBound(*uv, u))) {
+      return false;
+    }
+    if (l.sgt(u)) {
+      return fail("invalid interval");
+    }
+    R = Range(l, u);
+    return true;
+  }
+  VarNode *getConstant(int64_t value) {
+    VarNode *&node = constants[value];
+    if (node == nullptr) {
+      const APInt C(PrototypeBitWidth, value, true);
+      node = G.addNode(Range(C, C), true);
+    }
+    return node;
+  }
+  bool addUnaryOp(const PyValue &V) {
+    VarNode *source = nullptr;
+    VarNode *sink = nullptr;
+    int64_t a = 0;
+    int64_t b = 0;
+    if (!getNode(getArgument(V, 0, "source"), source) ||
+        !getSink(getArgument(V, 1, "sink"), sink) ||
+        !getInteger(getArgument(V, 2, "a"), 1, a) ||
+        !getInteger(getArgument(V, 3, "b"), 0, b)) {
+      return false;
+    }
+
+    Range intersect(PrototypeBitWidth);
+    VarNode *bound = nullptr;
+    CmpInst::Predicate pred = CmpInst::BAD_ICMP_PREDICATE;
+    const PyValue *interval = getArgument(V, 4, "interval");
+    if (interval != nullptr &&
+        !getInterval(*interval, intersect, bound, pred)) {
+      return false;
+    }
+    const bool hasIntersect = bound != nullptr || !intersect.isMaxRange();
+
+    // The last step writes the sink, the others nodes of their own
+    VarNode *current = source;
+    if (a != 1) {
+      VarNode *product = b == 0 && !hasIntersect
+                             ? sink
+                             : G.addNode(Range(PrototypeBitWidth, Unknown));
+      G.addOp(BasicOp::OperationId::BinaryOpId, Instruction::Mul, product,
+              {current, getConstant(a)}, Range(PrototypeBitWidth));
+      current = product;
+    }
+    if (b != 0) {
+      VarNode *sum = !hasIntersect
+                         ? sink
+                         : G.addNode(Range(PrototypeBitWidth, Unknown));
+      G.addOp(BasicOp::OperationId::BinaryOpId, Instruction::Add, sum,
+              {current, getConstant(b)}, Range(PrototypeBitWidth));
+      current = sum;
+    }
+    if (current != sink) {
+      G.addOp(hasIntersect ? BasicOp::OperationId::SigmaOpId
+                           : BasicOp::OperationId::UnaryOpId,
+              0, sink, current, intersect, bound, pred);
+    }
+    return true;
+  }
+  bool addOperation(const PyValue &V) {
+    if (V.kind != PyValue::Call) {
+      return fail("expected an operation");
+    }
+    if (V.s == "UnaryOp") {
+      return addUnaryOp(V);
+    }
+
+    VarNode *src1 = nullptr;
+    VarNode *src2 = nullptr;
+    VarNode *sink = nullptr;
+    if (!getNode(getArgument(V, 0, "src1"), src1) ||
+        !getNode(getArgument(V, 1, "src2"), src2) ||
+        !getSink(getArgument(V, 2, "sink"), sink)) {
+      return false;
+    }
+    if (V.s == "PlusOp") {
+      G.addOp(BasicOp::OperationId::BinaryOpId, Instruction::Add, sink,
+              {src1, src2}, Range(PrototypeBitWidth));
+    } else if (V.s == "PhiOp") {
+      G.addOp(BasicOp::OperationId::PhiOpId, 0, sink, {src1, src2},
+              Range(PrototypeBitWidth));
+    } else {
+      return fail("unknown operation " + V.s);
+    }
+    return true;
+  }
+
+public:
+  explicit PrototypeGraph(ConstraintGraph &G) : G(G) {}
+
+  /// Builds the graph of the Variables and Operations of a .dat file.
+  bool build(const std::map<std::string, PyValue> &assignments) {
+    std::map<std::string, PyValue>::const_iterator vit =
+        assignments.find("Variables");
+    std::map<std::string, PyValue>::const_iterator oit =
+        assignments.find("Operations");
+    if (vit == assignments.end() || vit->second.kind != PyValue::Dict ||
+        oit == assignments.end() || oit->second.kind != PyValue::List) {
+      return fail("expected the Variables and the Operations of a graph");
+    }
+    const std::vector<PyValue> &entries = vit->second.items;
+    const std::vector<PyValue> &operations = oit->second.items;
+
+    // Variables with a singleton interval and no definition are constants.
+    // The prototype lets several operations define a variable: their results
+    // are joined, as if a phi defined it.
+    std::map<std::string, unsigned> definitions;
+    for (const PyValue &op : operations) {
+      const PyValue *sink = op.kind == PyValue::Call
+                                ? getArgument(op, op.s == "UnaryOp" ? 1 : 2,
+                                              "sink")
+                                : nullptr;
+      if (sink != nullptr && sink->kind == PyValue::Subscript &&
+          sink->items[0].kind == PyValue::Str) {
+        ++definitions[sink->items[0].s];
+      }
+    }
+
+    for (unsigned i = 0, e = entries.size(); i < e; i += 2) {
+      const PyValue &node = entries[i + 1];
+      if (entries[i].kind != PyValue::Str || node.kind != PyValue::Call ||
+          node.s != "VarNode") {
+        return fail("expected a VarNode");
+      }
+      const std::string &name = entries[i].s;
+      Range R(PrototypeBitWidth);
+      VarNode *bound = nullptr;
+      CmpInst::Predicate pred = CmpInst::BAD_ICMP_PREDICATE;
+      const PyValue *interval = getArgument(node, 1, "interval");
+      if (interval != nullptr && !getInterval(*interval, R, bound, pred)) {
+        return false;
+      }
+      if (bound != nullptr) {
+        return fail("variable " + name + " has a symbolic interval");
+      }
+      const bool isConstant = R.isRegular() && !R.isLowerMin() &&
+                              R.getLower() == R.getUpper() &&
+                              definitions.count(name) == 0;
+      VarNode *varNode = G.addNode(R, isConstant);
+      if (!nodeOf.emplace(name, varNode).second) {
+        return fail("variable " + name + " is defined twice");
+      }
+      variables.emplace_back(name, varNode);
+      if (definitions[name] > 1) {
+        joined[name];
+      }
+    }
+
+    for (const PyValue &op : operations) {
+      if (!addOperation(op)) {
+        return false;
+      }
+    }
+    for (const auto &pair : joined) {
+      G.addOp(BasicOp::OperationId::PhiOpId, 0, nodeOf[pair.first],
+              pair.second, Range(PrototypeBitWidth));
+    }
+    G.finishBuild();
+    return true;
+  }
+  /// Prints the range of each variable.
+  void print(raw_ostream &OS) const {
+    for (const auto &pair : variables) {
+      OS << pair.first << " ";
+      pair.second->getRange().print(OS);
+      OS << "\n";
+    }
+  }
+  const std::string &getError() const { return error; }
+};
+
+/// Solves the graph of the prototype in FileName. Returns false on an error.
+bool solvePrototypeGraph(const std::string &FileName) {
+  ErrorOr<std::unique_ptr<MemoryBuffer>> BufferOrErr =
+      MemoryBuffer::getFileOrSTDIN(FileName);
+  if (std::error_code EC = BufferOrErr.getError()) {
+    errs() << "ERROR: file " << FileName << " can't be opened: "
+           << EC.message() << "\n";
+    return false;
+  }
+
+  std::map<std::string, PyValue> assignments;
+  PrototypeParser parser((*BufferOrErr)->getBuffer());
+  if (!parser.parse(assignments)) {
+    errs() << "ERROR: " << FileName << ": " << parser.getError() << "\n";
+    return false;
+  }
+
+  AnalysisContext ctx;
+  std::unique_ptr<ConstraintGraph> G = createGraph(ctx);
+  PrototypeGraph graph(*G);
+  if (!graph.build(assignments)) {
+    errs() << "ERROR: " << FileName << ": " << graph.getError() << "\n";
+    return false;
+  }
+  G->solve();
+  graph.print(outs());
+  return true;
+}
+
+} // end anonymous namespace
+
+int main(int argc, char **argv) {
+  llvm_shutdown_obj Y;
+  cl::ParseCommandLineOptions(argc, argv, "range analysis graph solver\n");
+
+  const bool solved = StringRef(InputFilename).endswith(".dat")
+                          ? solvePrototypeGraph(InputFilename)
+                          : solveGraphFile(InputFilename);
+  return solved ? 0 : 1;
+}
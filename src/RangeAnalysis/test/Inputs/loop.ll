@@ -0,0 +1,21 @@
+; A counted loop in e-SSA form: the sigmas narrow the counter down in each
+; successor of the comparison.
+define i8 @count(i32 %n) {
+entry:
+  br label %loop
+
+loop:
+  %i = phi i32 [ 0, %entry ], [ %inc, %body ]
+  %c = icmp slt i32 %i, 100
+  br i1 %c, label %body, label %exit
+
+body:
+  %vSSA_sigma = phi i32 [ %i, %loop ]
+  %inc = add i32 %vSSA_sigma, 1
+  br label %loop
+
+exit:
+  %vSSA_sigma1 = phi i32 [ %i, %loop ]
+  %t = trunc i32 %vSSA_sigma1 to i8
+  ret i8 %t
+}
@@ -0,0 +1,22 @@
+# Runs the command COMMAND, a list, and fails unless it succeeds and prints
+# what the file EXPECTED holds. If WRITE is given, it is first run as a
+# command which writes the graph file GRAPH, from scratch, since graphs are
+# appended to the file.
+if(DEFINED WRITE)
+  file(REMOVE ${GRAPH})
+  execute_process(COMMAND ${WRITE} RESULT_VARIABLE result
+                  OUTPUT_QUIET ERROR_VARIABLE errors)
+  if(NOT result EQUAL 0)
+    message(FATAL_ERROR "${WRITE} failed: ${result}\n${errors}")
+  endif()
+endif()
+
+execute_process(COMMAND ${COMMAND} RESULT_VARIABLE result
+                OUTPUT_VARIABLE output ERROR_VARIABLE errors)
+if(NOT result EQUAL 0)
+  message(FATAL_ERROR "${COMMAND} failed: ${result}\n${errors}")
+endif()
+file(READ ${EXPECTED} expected)
+if(NOT output STREQUAL expected)
+  message(FATAL_ERROR "${COMMAND} printed\n${output}\ninstead of\n${expected}")
+endif()